@@ -0,0 +1,186 @@
+#include "Bitacora.h"
+#include <math.h>
+
+Bitacora bitacora(Serial);
+
+static int16_t centesimas(float v) {
+	if (isnan(v) || isinf(v)) return BITACORA_SIN_VALOR;
+	float c = v * 100.0f;
+	if (c > 32767.0f) return 32767;
+	if (c < -32767.0f) return -32767;
+	return (int16_t)lroundf(c);
+}
+
+Bitacora::Bitacora(HardwareSerial &puerto)
+	: _puerto(puerto), _nivel(BITACORA_NIVEL_INICIAL), _inicio(0), _largo(0), _control(0),
+	  _sinAvisar(0), _descartadosTotal(0) {
+}
+
+void Bitacora::poner(uint8_t b) {
+	_buf[(uint8_t)(_inicio + _largo) % BITACORA_CAPACIDAD] = b;
+	_largo++;
+	_control ^= b;
+}
+
+void Bitacora::poner16(int16_t v) {
+	poner((uint8_t)v);
+	poner((uint8_t)((uint16_t)v >> 8));
+}
+
+void Bitacora::escribirCabecera(uint8_t tipo, uint8_t largo) {
+	poner(BITACORA_SYNC);
+	_control = 0;
+	poner(tipo);
+	poner(largo);
+	unsigned long t = millis();
+	for (uint8_t i = 0; i < 4; i++) poner((uint8_t)(t >> (8 * i)));
+}
+
+void Bitacora::cerrar() {
+	poner(_control);
+}
+
+// Aviso de descartes pendiente, si entra entero
+void Bitacora::avisarDescartes() {
+	if (_sinAvisar == 0) return;
+	if (BITACORA_CAPACIDAD - _largo < BITACORA_CABECERA + 2 + 1) return;
+	escribirCabecera(REG_DESCARTES, 2);
+	poner16((int16_t)_sinAvisar);
+	cerrar();
+	_sinAvisar = 0;
+}
+
+// Reserva lugar para una trama completa y escribe su cabecera; si no entra,
+// la cuenta como descartada (nunca se escriben tramas a medias)
+bool Bitacora::abrir(uint8_t nivel, uint8_t tipo, uint8_t largo) {
+	if (nivel > _nivel) return false;
+	avisarDescartes();
+	if (_sinAvisar > 0 || BITACORA_CAPACIDAD - _largo < BITACORA_CABECERA + largo + 1) {
+		if (_sinAvisar < 0xFFFF) _sinAvisar++;
+		_descartadosTotal++;
+		return false;
+	}
+	escribirCabecera(tipo, largo);
+	return true;
+}
+
+// Para las tramas que se reintentan (volcados): sin nivel y sin contarlas
+// como descartadas si no entran
+bool Bitacora::abrirSiCabe(uint8_t tipo, uint8_t largo) {
+	avisarDescartes();
+	if (_sinAvisar > 0 || BITACORA_CAPACIDAD - _largo < BITACORA_CABECERA + largo + 1) return false;
+	escribirCabecera(tipo, largo);
+	return true;
+}
+
+void Bitacora::drenar() {
+	int lugar = _puerto.availableForWrite();
+	while (_largo > 0 && lugar > 0) {
+		_puerto.write(_buf[_inicio]);
+		_inicio = (uint8_t)(_inicio + 1) % BITACORA_CAPACIDAD;
+		_largo--;
+		lugar--;
+	}
+	avisarDescartes();
+}
+
+void Bitacora::estado(uint8_t desde, uint8_t hasta) {
+	if (!abrir(BITACORA_EVENTOS, REG_ESTADO, 2)) return;
+	poner(desde);
+	poner(hasta);
+	cerrar();
+}
+
+void Bitacora::muestra(float Ta, float RH, float Tr) {
+	if (!abrir(BITACORA_DETALLE, REG_MUESTRA, 6)) return;
+	poner16(centesimas(Ta));
+	poner16(centesimas(RH));
+	poner16(centesimas(Tr));
+	cerrar();
+}
+
+void Bitacora::pmv(uint8_t estado, float Ta, float RH, float pmv) {
+	if (!abrir(BITACORA_PMV, REG_PMV, 7)) return;
+	poner(estado);
+	poner16(centesimas(Ta));
+	poner16(centesimas(RH));
+	poner16(centesimas(pmv));
+	cerrar();
+}
+
+void Bitacora::intentos(uint8_t n) {
+	if (!abrir(BITACORA_EVENTOS, REG_INTENTOS, 1)) return;
+	poner(n);
+	cerrar();
+}
+
+void Bitacora::evento(EventoBitacora e, uint8_t nivel) {
+	if (!abrir(nivel, REG_EVENTO, 1)) return;
+	poner(e);
+	cerrar();
+}
+
+void Bitacora::tarjeta(bool registrada, const byte *uid) {
+	if (!abrir(BITACORA_EVENTOS, REG_TARJETA, 5)) return;
+	poner(registrada ? 1 : 0);
+	for (uint8_t i = 0; i < 4; i++) poner(uid[i]);
+	cerrar();
+}
+
+void Bitacora::perfil(const char *nombre, const char *temperatura) {
+	uint8_t ln = strnlen(nombre, BITACORA_MAX_DATOS / 2 - 1);
+	uint8_t lt = strnlen(temperatura, BITACORA_MAX_DATOS / 2 - 1);
+	if (!abrir(BITACORA_EVENTOS, REG_PERFIL, ln + 1 + lt)) return;
+	for (uint8_t i = 0; i < ln; i++) poner((uint8_t)nombre[i]);
+	poner(0);
+	for (uint8_t i = 0; i < lt; i++) poner((uint8_t)temperatura[i]);
+	cerrar();
+}
+
+void Bitacora::errorRFID(uint8_t operacion, uint8_t bloque, uint8_t status) {
+	if (!abrir(BITACORA_ERRORES, REG_ERROR_RFID, 3)) return;
+	poner(operacion);
+	poner(bloque);
+	poner(status);
+	cerrar();
+}
+
+void Bitacora::heap(uint16_t bytes) {
+	if (!abrir(BITACORA_ERRORES, REG_HEAP, 2)) return;
+	poner16((int16_t)bytes);
+	cerrar();
+}
+
+void Bitacora::zona(uint8_t id, uint8_t modo, float Ta, float RH, float pmv) {
+	if (!abrir(BITACORA_EVENTOS, REG_ZONA, 8)) return;
+	poner(id);
+	poner(modo);
+	poner16(centesimas(Ta));
+	poner16(centesimas(RH));
+	poner16(centesimas(pmv));
+	cerrar();
+}
+
+bool Bitacora::historial(uint16_t direccion, const uint8_t *datos, uint8_t n) {
+	if (!abrirSiCabe(REG_HISTORIAL, 2 + n)) return false;
+	poner16((int16_t)direccion);
+	for (uint8_t i = 0; i < n; i++) poner(datos[i]);
+	cerrar();
+	return true;
+}
+
+bool Bitacora::traza(uint8_t numero, const uint8_t *datos, uint8_t n) {
+	if (!abrirSiCabe(REG_TRAZA, 1 + n)) return false;
+	poner(numero);
+	for (uint8_t i = 0; i < n; i++) poner(datos[i]);
+	cerrar();
+	return true;
+}
+
+bool Bitacora::perfilado(uint8_t tipo, const uint8_t *datos, uint8_t n) {
+	if (!abrirSiCabe(REG_PERFILADO, 1 + n)) return false;
+	poner(tipo);
+	for (uint8_t i = 0; i < n; i++) poner(datos[i]);
+	cerrar();
+	return true;
+}
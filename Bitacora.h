@@ -0,0 +1,126 @@
+#ifndef SMARTCOMFORT_BITACORA_H
+#define SMARTCOMFORT_BITACORA_H
+
+#include <Arduino.h>
+
+// Registro de eventos en binario. Cada evento se arma como una trama corta
+// en un buffer circular en RAM y drenar() la pasa al puerto serie solo en la
+// medida en que haya lugar en el buffer de TX: el loop nunca espera al
+// puerto. Si el buffer circular se llena, el evento se descarta y se cuenta;
+// la cuenta sale como un registro propio en cuanto vuelve a haber lugar.
+//
+// Trama: SYNC, tipo, largo de los datos, millis() (4 bytes), datos, y un
+// byte de control (XOR de todo lo anterior salvo SYNC). Los enteros van en
+// little-endian; temperaturas y PMV en centesimas. host/DecodificadorBitacora
+// la convierte de nuevo en texto; lo que llegue fuera de una trama (los
+// benchmarks) se muestra tal cual.
+#define BITACORA_SYNC 0xA5
+#define BITACORA_CAPACIDAD 128    // bytes de RAM para tramas pendientes
+#define BITACORA_MAX_DATOS 40     // datos de una trama
+#define BITACORA_CABECERA 7       // SYNC, tipo, largo, millis()
+#define BITACORA_SIN_VALOR -32768 // centesimas de un valor NaN
+
+// Verbosidad: se registran los eventos de nivel <= al elegido
+enum NivelBitacora : uint8_t {
+	BITACORA_ERRORES = 0,  // fallos de sensores/RFID y descartes
+	BITACORA_EVENTOS = 1,  // cambios de estado, tarjetas, alarma
+	BITACORA_PMV = 2,      // cada evaluacion de PMV
+	BITACORA_DETALLE = 3   // cada muestra de los sensores
+};
+#define BITACORA_NIVEL_INICIAL BITACORA_PMV
+
+enum TipoRegistro : uint8_t {
+	REG_ESTADO = 1,       // desde, hasta
+	REG_MUESTRA = 2,      // Ta, RH, Tr (int16)
+	REG_PMV = 3,          // estado, Ta (int16), RH (int16), PMV (int16)
+	REG_INTENTOS = 4,     // intentos con PMV alto
+	REG_EVENTO = 5,       // EventoBitacora
+	REG_TARJETA = 6,      // registrada, UID (4 bytes)
+	REG_PERFIL = 7,       // nombre '\0' temperatura preferida
+	REG_ERROR_RFID = 8,   // operacion (0 autenticar, 1 leer), bloque, status
+	REG_HEAP = 9,         // bytes (uint16)
+	REG_DESCARTES = 10,   // eventos perdidos desde el ultimo aviso (uint16)
+	REG_ZONA = 11,        // zona, Zona::Modo, Ta (int16), RH (int16), PMV (int16)
+	REG_HISTORIAL = 12,   // direccion EEPROM (uint16), bytes; sin bytes: fin del volcado
+	REG_TRAZA = 13,       // numero de trama, bytes de la traza de entradas (Traza.h)
+	REG_PERFILADO = 14    // TipoPerfilado, datos (Perfilador.h)
+};
+
+enum EventoBitacora : uint8_t {
+	EV_PRESENCIA = 1,        // IR en alarma: vuelta a inicio
+	EV_IR_REARMADO,
+	EV_TECLA_NUMERAL,        // '#' en alarma
+	EV_TECLA_ASTERISCO,      // '*' en bloqueado
+	EV_TIMER_PMV_ALTO,
+	EV_LECTURAS_NAN,
+	EV_PMV_NORMALIZADO,
+	EV_INTENTOS_AGOTADOS,
+	EV_CONTADOR_RESETEADO,
+	EV_ALARMA_ACTIVADA,
+	EV_TRAZA_CORTADA,        // la traza de entradas lleno su buffer
+	EV_EVENTOS_PERDIDOS,     // la cola de eventos de la maquina se lleno
+	EV_FLANCOS_PERDIDOS,     // la cola de flancos del IR y el boton se lleno
+	EV_FALLA_NTC,            // NTC abierto o en corto: el PMV sigue con Tr = Ta
+	EV_TAREAS_LLENAS,        // PLAN_MAX_TAREAS activas: una tarea no arranco
+	EV_ARRANQUE,             // setup() inicia la maquina de estados
+	EV_CANTIDAD
+};
+
+class Bitacora {
+public:
+	explicit Bitacora(HardwareSerial &puerto);
+
+	void nivel(uint8_t n) { _nivel = n; }
+	uint8_t nivel() const { return _nivel; }
+
+	void estado(uint8_t desde, uint8_t hasta);
+	void muestra(float Ta, float RH, float Tr);
+	void pmv(uint8_t estado, float Ta, float RH, float pmv);
+	void intentos(uint8_t n);
+	void evento(EventoBitacora e, uint8_t nivel = BITACORA_EVENTOS);
+	void tarjeta(bool registrada, const byte *uid);
+	void perfil(const char *nombre, const char *temperatura);
+	void errorRFID(uint8_t operacion, uint8_t bloque, uint8_t status);
+	void heap(uint16_t bytes);
+	void zona(uint8_t id, uint8_t modo, float Ta, float RH, float pmv);
+
+	// Bloque del volcado del historial (Historial.h), a cualquier nivel. Si
+	// no entra ahora devuelve false sin contarlo como descartado: el volcado
+	// lo reintenta en la pasada siguiente.
+	bool historial(uint16_t direccion, const uint8_t *datos, uint8_t n);
+
+	// Bloque de la traza de entradas, con las mismas reglas
+	bool traza(uint8_t numero, const uint8_t *datos, uint8_t n);
+
+	// Registro del volcado de tiempos del loop (Perfilador.h), con las mismas
+	// reglas
+	bool perfilado(uint8_t tipo, const uint8_t *datos, uint8_t n);
+
+	// Pasa al puerto lo que quepa en su buffer de TX, sin esperar
+	void drenar();
+
+	unsigned long descartados() const { return _descartadosTotal; }
+	uint8_t pendientes() const { return _largo; }
+
+private:
+	bool abrir(uint8_t nivel, uint8_t tipo, uint8_t largo);
+	bool abrirSiCabe(uint8_t tipo, uint8_t largo);
+	void escribirCabecera(uint8_t tipo, uint8_t largo);
+	void poner(uint8_t b);
+	void poner16(int16_t v);
+	void cerrar();
+	void avisarDescartes();
+
+	HardwareSerial &_puerto;
+	uint8_t _nivel;
+	uint8_t _buf[BITACORA_CAPACIDAD];
+	uint8_t _inicio;
+	uint8_t _largo;
+	uint8_t _control;
+	uint16_t _sinAvisar;
+	unsigned long _descartadosTotal;
+};
+
+extern Bitacora bitacora;
+
+#endif
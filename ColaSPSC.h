@@ -0,0 +1,69 @@
+#ifndef SMARTCOMFORT_COLASPSC_H
+#define SMARTCOMFORT_COLASPSC_H
+
+#include <stdint.h>
+
+// Cola circular de tamano fijo para un productor y un consumidor que pueden
+// correr en contextos distintos (una interrupcion y el loop) sin bloquear
+// las interrupciones. Cada indice lo escribe un solo lado: el productor
+// avanza _fin despues de escribir el elemento y el consumidor avanza _inicio
+// despues de leerlo. En el AVR un uint8_t se lee y escribe en una
+// instruccion, asi que alcanza con que el compilador no reordene esos
+// accesos (__atomic_* con acquire/release; en el host son atomicos de
+// verdad).
+//
+// Con N potencia de dos y <= 128 el indice da la vuelta con una mascara; se
+// usan los N lugares. Si la cola esta llena poner() descarta el elemento y
+// cuenta un desborde: el productor no espera nunca. Varios productores en el
+// mismo contexto (todo el loop, por ejemplo) cuentan como uno; cada
+// interrupcion que produzca necesita su propia cola.
+//
+// Sin constructor: como global (o con ColaSPSC<T, N> c{}) arranca vacia.
+template <class T, uint8_t N>
+class ColaSPSC {
+	static_assert(N >= 2 && N <= 128 && (N & (N - 1)) == 0, "N debe ser potencia de dos entre 2 y 128");
+
+public:
+	// Productor
+	bool poner(const T &valor) {
+		uint8_t fin = __atomic_load_n(&_fin, __ATOMIC_RELAXED);
+		uint8_t inicio = __atomic_load_n(&_inicio, __ATOMIC_ACQUIRE);
+		uint8_t ocupados = (uint8_t)(fin - inicio);
+		if (ocupados >= N) {
+			if (_desbordes != 0xFF) __atomic_store_n(&_desbordes, (uint8_t)(_desbordes + 1), __ATOMIC_RELAXED);
+			return false;
+		}
+		_datos[fin & (N - 1)] = valor;
+		__atomic_store_n(&_fin, (uint8_t)(fin + 1), __ATOMIC_RELEASE);
+		if (ocupados + 1 > _maximo) _maximo = ocupados + 1;
+		return true;
+	}
+
+	// Consumidor
+	bool sacar(T &valor) {
+		uint8_t inicio = __atomic_load_n(&_inicio, __ATOMIC_RELAXED);
+		if (inicio == __atomic_load_n(&_fin, __ATOMIC_ACQUIRE)) return false;
+		valor = _datos[inicio & (N - 1)];
+		__atomic_store_n(&_inicio, (uint8_t)(inicio + 1), __ATOMIC_RELEASE);
+		return true;
+	}
+
+	bool vacia() const {
+		return __atomic_load_n(&_inicio, __ATOMIC_RELAXED) == __atomic_load_n(&_fin, __ATOMIC_ACQUIRE);
+	}
+
+	// Elementos descartados por cola llena (satura en 255) y mayor ocupacion
+	// vista; los escribe el productor
+	uint8_t desbordes() const { return __atomic_load_n(&_desbordes, __ATOMIC_RELAXED); }
+	uint8_t maximo() const { return _maximo; }
+	static constexpr uint8_t capacidad() { return N; }
+
+private:
+	T _datos[N];
+	uint8_t _inicio;  // lo escribe el consumidor
+	uint8_t _fin;     // lo escribe el productor
+	uint8_t _desbordes;
+	uint8_t _maximo;
+};
+
+#endif
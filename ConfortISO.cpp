@@ -0,0 +1,87 @@
+#include "ConfortISO.h"
+
+#include <Arduino.h>
+#include <math.h>
+#include <string.h>
+
+static inline float cuarta(float x) {
+	float x2 = x * x;
+	return x2 * x2;
+}
+
+float ppdISO(float pmv) {
+	float p2 = pmv * pmv;
+	return 100.0f - 95.0f * expf(-0.03353f * p2 * p2 - 0.2179f * p2);
+}
+
+ConfortISO computeConfortISO(float Ta, float Tr, float RH, float va, float met, float clo, float W) {
+	ConfortISO r;
+	memset(&r, 0, sizeof(r));
+	if (isnan(Ta) || isnan(Tr) || isnan(RH) || isnan(va) || isnan(met) || isnan(clo)) {
+		r.pmv = r.ppd = r.t_cl = NAN;
+		return r;
+	}
+
+	const float M = met * 58.15f;
+	const float MW = M - W * 58.15f;
+	const float I_cl = clo * 0.155f;
+	const float f_cl = I_cl <= 0.078f ? 1.0f + 1.29f * I_cl : 1.05f + 0.645f * I_cl;
+	const float p_a = RH * 10.0f * expf(16.6536f - 4030.183f / (Ta + 235.0f));
+	const float h_cf = 12.1f * sqrtf(va > 0.0f ? va : 0.0f);
+	const float T_sk = 35.7f - 0.028f * MW;
+	const float trK4 = cuarta(Tr + 273.0f);
+
+	// f(T) = T - T_sk + I_cl f_cl (3.96e-8 ((T + 273)^4 - (Tr + 273)^4) +
+	// h_c (T - Ta)), creciente y con la raiz entre Ta, Tr y T_sk
+	float lo = fminf(fminf(Ta, Tr), T_sk);
+	float hi = fmaxf(fmaxf(Ta, Tr), T_sk);
+	float T_cl = 0.5f * (lo + hi);
+	float h_c = h_cf;
+	uint8_t it = 0;
+	while (it < CONFORT_MAX_ITER) {
+		it++;
+		float d = T_cl - Ta;
+		float raiz4 = sqrtf(sqrtf(fabsf(d)));
+		float dh;
+		if (2.38f * raiz4 > h_cf) {
+			h_c = 2.38f * raiz4;
+			dh = 2.975f * raiz4;  // d/dT de 2.38 |d|^1.25
+		} else {
+			h_c = h_cf;
+			dh = h_cf;
+		}
+		float tclK = T_cl + 273.0f;
+		float rad = 3.96e-8f * (cuarta(tclK) - trK4);
+		float f = T_cl - T_sk + I_cl * f_cl * (rad + h_c * d);
+		if (f > 0.0f) hi = T_cl; else lo = T_cl;
+
+		float df = 1.0f + I_cl * f_cl * (4.0f * 3.96e-8f * tclK * tclK * tclK + dh);
+		float T_new = T_cl - f / df;
+		if (T_new <= lo || T_new >= hi) T_new = 0.5f * (lo + hi);
+		float paso = fabsf(T_new - T_cl);
+		T_cl = T_new;
+		if (paso < CONFORT_TCL_TOLERANCIA) break;
+	}
+	h_c = fmaxf(h_cf, 2.38f * sqrtf(sqrtf(fabsf(T_cl - Ta))));
+
+	PerdidasCalor &p = r.perdidas;
+	p.difusion = 3.05e-3f * (5733.0f - 6.99f * MW - p_a);
+	p.sudor = MW > 58.15f ? 0.42f * (MW - 58.15f) : 0.0f;
+	p.respLatente = 1.7e-5f * M * (5867.0f - p_a);
+	p.respSeca = 0.0014f * M * (34.0f - Ta);
+	p.radiacion = 3.96e-8f * f_cl * (cuarta(T_cl + 273.0f) - trK4);
+	p.conveccion = f_cl * h_c * (T_cl - Ta);
+
+	r.carga = MW - p.difusion - p.sudor - p.respLatente - p.respSeca - p.radiacion - p.conveccion;
+	r.pmv = (0.303f * expf(-0.036f * M) + 0.028f) * r.carga;
+	r.ppd = ppdISO(r.pmv);
+	r.t_cl = T_cl;
+	r.h_c = h_c;
+	r.iteraciones = it;
+
+	// Rango de validez (ISO 7730, seccion 4.1)
+	r.enRango = r.pmv >= -2.0f && r.pmv <= 2.0f && met >= 0.8f && met <= 4.0f && clo >= 0.0f && clo <= 2.0f &&
+	            Ta >= 10.0f && Ta <= 30.0f && Tr >= 10.0f && Tr <= 40.0f && va >= 0.0f && va <= 1.0f &&
+	            p_a >= 0.0f && p_a <= 2700.0f;
+	return r;
+}
@@ -0,0 +1,50 @@
+#ifndef SMARTCOMFORT_CONFORTISO_H
+#define SMARTCOMFORT_CONFORTISO_H
+
+#include <stdint.h>
+
+// Motor de confort de referencia segun ISO 7730:2005 (seccion 4 y codigo
+// del anexo D). A diferencia de computePMV, que esta pensado para el loop:
+//   - f_cl segun I_cl (m2K/W): 1 + 1.29 I_cl hasta 0.078, si no
+//     1.05 + 0.645 I_cl
+//   - presion de vapor de la norma: exp(16.6536 - 4030.183 / (Ta + 235))
+//   - kelvin con 273, el sudor solo si M - W > 58.15 y trabajo externo W
+//   - el PMV no se recorta: enRango dice si las entradas y el resultado
+//     estan dentro del rango de validez de la norma
+// T_cl se resuelve con Newton salvaguardado por biseccion sobre la misma
+// ecuacion que itera la norma, hasta CONFORT_TCL_TOLERANCIA.
+//
+// En una pasada devuelve PMV, PPD, T_cl, h_c y cada perdida de calor, para
+// validar los motores rapidos (PMVBench.cpp) y para informes.
+#define CONFORT_TCL_TOLERANCIA 1e-3f  // C; la norma corta en 0.015 C
+#define CONFORT_MAX_ITER 24
+
+// Perdidas de calor del balance (W/m2)
+struct PerdidasCalor {
+	float difusion;     // difusion de vapor por la piel
+	float sudor;        // evaporacion del sudor
+	float respLatente;  // respiracion, calor latente
+	float respSeca;     // respiracion, calor sensible
+	float radiacion;
+	float conveccion;
+};
+
+struct ConfortISO {
+	float pmv;            // sin recortar; NAN si alguna entrada es NaN
+	float ppd;            // %
+	float t_cl;           // C
+	float h_c;            // W/m2K
+	float carga;          // (M - W) menos las perdidas, W/m2
+	PerdidasCalor perdidas;
+	uint8_t iteraciones;
+	bool enRango;
+};
+
+// Ta y Tr en C, RH en %, va en m/s (velocidad relativa), met en met, clo
+// en clo, W en met (casi siempre 0)
+ConfortISO computeConfortISO(float Ta, float Tr, float RH, float va, float met, float clo, float W = 0.0f);
+
+// PPD (%) de un PMV
+float ppdISO(float pmv);
+
+#endif
@@ -0,0 +1,53 @@
+#include "EntradaClave.h"
+
+#define CLAVE_COLUMNA 7  // despues de "Clave: "
+
+EntradaClave::EntradaClave(Pantalla &lcd, uint8_t fila)
+	: _lcd(lcd), _fila(fila), _activa(false), _inicio(0) {
+}
+
+void EntradaClave::iniciar(unsigned long ahora) {
+	_activa = true;
+	_digitos.limpiar();
+	_inicio = ahora;
+	_lcd.setCursor(0, _fila);
+	_lcd.print("Clave: []     ");
+	_lcd.setCursor(CLAVE_COLUMNA, _fila);
+}
+
+void EntradaClave::cancelar() {
+	_activa = false;
+}
+
+void EntradaClave::redibujar() {
+	_lcd.setCursor(CLAVE_COLUMNA, _fila);
+	for (uint8_t i = 0; i < _digitos.largo(); i++) _lcd.print('*');
+	for (uint8_t i = _digitos.largo(); i < CLAVE_LONGITUD; i++) _lcd.print(' ');
+	_lcd.setCursor(CLAVE_COLUMNA + _digitos.largo(), _fila);
+}
+
+EntradaClave::Resultado EntradaClave::procesar(char tecla, unsigned long ahora) {
+	if (!_activa) return EnCurso;
+	
+	if (tecla >= '0' && tecla <= '9') {
+		_lcd.print('*');
+		_digitos.agregar(tecla);
+		if (_digitos.lleno()) {
+			_activa = false;
+			return Completa;
+		}
+	} else if (tecla == '*' && !_digitos.vacio()) {
+		_digitos.quitarUltimo();
+		redibujar();
+	}
+	
+	if (ahora - _inicio >= CLAVE_TIMEOUT_MS) {
+		_activa = false;
+		return Vencida;
+	}
+	return EnCurso;
+}
+
+bool EntradaClave::coincide(const char *clave) const {
+	return _digitos.igual(clave);
+}
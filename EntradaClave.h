@@ -0,0 +1,43 @@
+#ifndef SMARTCOMFORT_ENTRADACLAVE_H
+#define SMARTCOMFORT_ENTRADACLAVE_H
+
+#include <Arduino.h>
+#include "Pantalla.h"
+#include "TextoFijo.h"
+
+#define CLAVE_LONGITUD 4
+#define CLAVE_TIMEOUT_MS 15000UL
+
+// Ingreso de la clave por teclado sin bloquear el loop: recibe como mucho
+// una tecla por pasada (el resultado de keypad.getKey()) y avanza. Muestra
+// "Clave: [" y un '*' por digito en la fila dada del LCD; '*' borra el
+// ultimo digito. Si no se completa en CLAVE_TIMEOUT_MS, se descarta lo
+// ingresado y se vuelve a empezar, como hacia recibirCodigo().
+class EntradaClave {
+public:
+	enum Resultado { EnCurso, Completa, Vencida };
+	
+	EntradaClave(Pantalla &lcd, uint8_t fila);
+	
+	// Dibuja el campo vacio y arranca el plazo
+	void iniciar(unsigned long ahora);
+	void cancelar();
+	bool activa() const { return _activa; }
+	
+	// Procesa la tecla de esta pasada (NO_KEY si no hubo) y el plazo
+	Resultado procesar(char tecla, unsigned long ahora);
+	
+	// Compara la clave completa con la guardada
+	bool coincide(const char *clave) const;
+	
+private:
+	void redibujar();
+	
+	Pantalla &_lcd;
+	uint8_t _fila;
+	bool _activa;
+	TextoFijo<CLAVE_LONGITUD> _digitos;
+	unsigned long _inicio;
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef SMARTCOMFORT_EVENTOS_H
+#define SMARTCOMFORT_EVENTOS_H
+
+#include <stdint.h>
+#include "ColaSPSC.h"
+
+// Entradas de la maquina de estados del sketch en una cola (ColaSPSC.h):
+// las tareas del planificador y el lector del estado actual las ponen, y
+// el loop las consume una por una en orden de llegada. Cada evento lleva el
+// estado en que se produjo: si la maquina ya cambio de estado, el evento es
+// viejo y se descarta sin disparar nada.
+#define EVENTOS_CAPACIDAD 16
+
+struct Evento {
+	uint8_t entrada;
+	uint8_t estado;     // de la maquina al producirse
+	uint16_t instante;  // millis() (16 bits bajos), para la latencia
+};
+
+typedef ColaSPSC<Evento, EVENTOS_CAPACIDAD> ColaEventos;
+
+struct EstadisticaEventos {
+	unsigned long despachados;
+	unsigned long viejos;       // de un estado anterior: descartados
+	uint16_t latenciaMaxima;    // ms entre poner y despachar
+	uint8_t desbordesAvisados;  // desbordes ya informados por la bitacora
+};
+
+#endif
@@ -0,0 +1,108 @@
+#include "Flancos.h"
+#include "Bitacora.h"
+#include "Traza.h"
+
+// Sin constructor: en cero, sin canales
+CapturaFlancos flancos;
+
+#ifdef __AVR__
+ISR(TIMER0_COMPA_vect) {
+	flancos.muestrear();
+}
+#else
+static void muestrearFlancos() {
+	flancos.muestrear();
+}
+#endif
+
+uint8_t CapturaFlancos::agregar(uint8_t pin, AccionFlanco accion) {
+	if (_n >= FLANCOS_CANALES) return 0xFF;
+	_canales[_n].pin = pin;
+	_canales[_n].accion = accion;
+	return _n++;
+}
+
+void CapturaFlancos::begin() {
+	for (uint8_t i = 0; i < _n; i++) {
+		Canal &c = _canales[i];
+#ifdef __AVR__
+		c.puerto = portInputRegister(digitalPinToPort(c.pin));
+		c.mascara = digitalPinToBitMask(c.pin);
+#endif
+		uint8_t v = TRAZA_ENTRADA(TR_DIGITAL, digitalRead(c.pin)) ? HIGH : LOW;
+		c.muestra = c.estable = c.pendiente = v;
+		c.desde = 0;
+	}
+#ifdef __AVR__
+	// Vence a mitad de cada vuelta del Timer0, lejos del desborde
+	OCR0A = 0x80;
+	TIMSK0 |= _BV(OCIE0A);
+#else
+	sim::attachTimerIsr(muestrearFlancos, FLANCOS_PERIODO_US);
+#endif
+}
+
+void CapturaFlancos::muestrear() {
+	for (uint8_t i = 0; i < _n; i++) {
+		Canal &c = _canales[i];
+#ifdef __AVR__
+		uint8_t v = (*c.puerto & c.mascara) ? HIGH : LOW;
+#else
+		uint8_t v = digitalRead(c.pin) ? HIGH : LOW;
+#endif
+		if (v == c.muestra) continue;
+		// Si la cola esta llena el flanco se vuelve a intentar en la
+		// proxima muestra: el nivel no queda desfasado
+		Flanco f = { i, v, millis() };
+		if (_cola.poner(f)) c.muestra = v;
+	}
+}
+
+// El ultimo flanco del canal vale si su nivel se sostuvo hasta 'hasta'
+void CapturaFlancos::filtrar(Canal &c, unsigned long hasta) {
+	if (c.pendiente == c.estable) return;
+	if ((long)(hasta - c.desde) < FLANCOS_ANTIRREBOTE_MS) return;
+	c.estable = c.pendiente;
+	_est.cambios++;
+	if (c.accion != nullptr) c.accion(c.estable);
+}
+
+uint8_t CapturaFlancos::servicio(unsigned long ahora) {
+	uint8_t sacados = 0;
+	for (;;) {
+		// Codigo del flanco en la traza: 0 si no hay, o 1 + canal * 2 + nivel
+		Flanco f = { 0, 0, 0 };
+		uint8_t codigo = _cola.sacar(f) ? (uint8_t)(1 + f.canal * 2 + f.nivel) : 0;
+		codigo = TRAZA_ENTRADA(TR_DIGITAL, codigo);
+		if (codigo == 0 || codigo > 2 * _n) break;
+		f.canal = (uint8_t)((codigo - 1) >> 1);
+		f.nivel = (uint8_t)((codigo - 1) & 1);
+		f.instante = TRAZA_ENTRADA(TR_MILLIS, f.instante);
+		_est.flancos++;
+		if (sacados++ == 0) _latencia = (long)(ahora - f.instante) > 0 ? ahora - f.instante : 0;
+
+		Canal &c = _canales[f.canal];
+		filtrar(c, f.instante);
+		if (c.pendiente != c.estable) _est.rebotes++;
+		c.pendiente = f.nivel;
+		c.desde = f.instante;
+	}
+	for (uint8_t i = 0; i < _n; i++) filtrar(_canales[i], ahora);
+
+	if (_cola.desbordes() != _est.desbordesAvisados) {
+		_est.desbordesAvisados = _cola.desbordes();
+		bitacora.evento(EV_FLANCOS_PERDIDOS, BITACORA_ERRORES);
+	}
+	return sacados;
+}
+
+unsigned long CapturaFlancos::espera(unsigned long ahora, unsigned long tope) const {
+	for (uint8_t i = 0; i < _n; i++) {
+		const Canal &c = _canales[i];
+		if (c.pendiente == c.estable) continue;
+		long falta = (long)(c.desde + FLANCOS_ANTIRREBOTE_MS - ahora);
+		if (falta <= 0) return 0;
+		if ((unsigned long)falta < tope) tope = falta;
+	}
+	return tope;
+}
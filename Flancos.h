@@ -0,0 +1,102 @@
+#ifndef SMARTCOMFORT_FLANCOS_H
+#define SMARTCOMFORT_FLANCOS_H
+
+#include <Arduino.h>
+#include "ColaSPSC.h"
+
+// Captura de flancos de entradas digitales (sensor IR y boton) fuera del
+// loop. Una interrupcion periodica muestrea los pines y pone cada cambio,
+// con su millis(), en una cola (ColaSPSC.h); el loop los saca en servicio()
+// y los pasa por un antirrebote por canal: un nivel nuevo vale cuando se
+// sostuvo FLANCOS_ANTIRREBOTE_MS (medido con los instantes de los flancos,
+// sin esperar). Cada cambio de nivel filtrado llama a la accion del canal,
+// en orden, aunque varios hayan llegado durante una misma pasada larga (una
+// lectura del DHT11, por ejemplo).
+//
+// En el Mega, los pines del IR (23, PA1) y del boton (49, PL0) no tienen
+// interrupcion externa ni de cambio de pin: el muestreo va en la comparacion
+// A del Timer0, que el core deja libre y vence una vez por milisegundo
+// (1024 us), junto al desborde que lleva millis(). Un pulso de mas de ~1 ms
+// no se pierde. En la simulacion, SimHAL corre la misma rutina con el reloj
+// virtual.
+//
+// Los flancos que el loop saca pasan por la traza (TR_DIGITAL y TR_MILLIS),
+// asi la reproduccion recibe los mismos flancos en la misma pasada.
+#define FLANCOS_CANALES 2
+#define FLANCOS_CAPACIDAD 16
+#define FLANCOS_PERIODO_US 1024
+#define FLANCOS_ANTIRREBOTE_MS 50
+
+typedef void (*AccionFlanco)(uint8_t nivel);
+
+struct Flanco {
+	uint8_t canal;
+	uint8_t nivel;
+	unsigned long instante;  // millis() de la muestra que lo vio
+};
+
+struct EstadisticaFlancos {
+	unsigned long flancos;    // sacados de la cola
+	unsigned long rebotes;    // sin sostenerse: descartados
+	unsigned long cambios;    // niveles filtrados, uno por accion
+	uint8_t desbordesAvisados;
+};
+
+class CapturaFlancos {
+public:
+	// Canal siguiente: el pin y la accion de sus cambios de nivel. Antes de
+	// begin().
+	uint8_t agregar(uint8_t pin, AccionFlanco accion);
+
+	// Toma los niveles iniciales y arranca la interrupcion
+	void begin();
+
+	// Desde la interrupcion: compara cada pin con su ultima muestra
+	void muestrear();
+
+	// Saca los flancos pendientes y los filtra; devuelve cuantos saco. Va en
+	// cada pasada del loop.
+	uint8_t servicio(unsigned long ahora);
+
+	// Del ultimo servicio(): ms desde la captura del primer flanco sacado
+	unsigned long latencia() const { return _latencia; }
+
+	// Hay flancos sin sacar (para despertar al loop, Reposo.h)
+	bool pendientes() const { return !_cola.vacia(); }
+
+	// ms hasta que venza el antirrebote de algun canal, a lo sumo tope
+	unsigned long espera(unsigned long ahora, unsigned long tope) const;
+
+	// Nivel filtrado del canal
+	uint8_t nivel(uint8_t canal) const { return _canales[canal].estable; }
+
+	const EstadisticaFlancos &estadistica() const { return _est; }
+	uint8_t desbordes() const { return _cola.desbordes(); }
+	uint8_t maximo() const { return _cola.maximo(); }
+
+private:
+	struct Canal {
+		uint8_t pin;
+		AccionFlanco accion;
+#ifdef __AVR__
+		volatile uint8_t *puerto;  // registro PINx
+		uint8_t mascara;
+#endif
+		volatile uint8_t muestra;  // de la interrupcion
+		uint8_t estable;           // filtrado
+		uint8_t pendiente;         // ultimo flanco, sin filtrar
+		unsigned long desde;       // instante del ultimo flanco
+	};
+
+	void filtrar(Canal &c, unsigned long hasta);
+
+	Canal _canales[FLANCOS_CANALES];
+	uint8_t _n;
+	ColaSPSC<Flanco, FLANCOS_CAPACIDAD> _cola;
+	EstadisticaFlancos _est;
+	unsigned long _latencia;
+};
+
+extern CapturaFlancos flancos;
+
+#endif
@@ -0,0 +1,154 @@
+#include "Historial.h"
+#include "Bitacora.h"
+#include <EEPROM.h>
+#include <math.h>
+
+static_assert(HISTORIAL_PAGINAS <= 255, "demasiadas paginas para un indice de 8 bits");
+static_assert(HISTORIAL_PAGINA % HISTORIAL_BLOQUE_VOLCADO == 0, "el volcado debe alinear con las paginas");
+static_assert(HISTORIAL_CABECERA + HISTORIAL_MAX_REGISTRO <= HISTORIAL_PAGINA, "un registro no entra en una pagina");
+static_assert(HISTORIAL_BLOQUE_VOLCADO + 2 <= BITACORA_MAX_DATOS, "el bloque del volcado no entra en una trama");
+
+Historial historial;
+
+static uint16_t direccionPagina(uint8_t pagina) {
+	return HISTORIAL_INICIO + (uint16_t)pagina * HISTORIAL_PAGINA;
+}
+
+static int16_t escalar(float v, float escala) {
+	if (isnan(v) || isinf(v)) return HISTORIAL_SIN_VALOR;
+	float e = v * escala;
+	if (e > 32767.0f) return 32767;
+	if (e < -32767.0f) return -32767;
+	return (int16_t)lroundf(e);
+}
+
+Historial::Historial()
+	: _inicioCola(0), _largoCola(0), _secuencia(0), _arranque(0), _pagina(HISTORIAL_PAGINAS - 1), _pos(0),
+	  _volcado(0), _descartadas(0) {
+	memset(&_previa, 0, sizeof(_previa));
+}
+
+MuestraHistorial Historial::muestra(unsigned long ahora, float Ta, float Tr, float RH, float pmv, uint8_t estado) {
+	MuestraHistorial m;
+	m.segundos = ahora / 1000;
+	m.Ta = escalar(Ta, 10.0f);
+	m.Tr = escalar(Tr, 10.0f);
+	m.RH = escalar(RH, 1.0f);
+	m.pmv = escalar(pmv, 100.0f);
+	m.estado = estado;
+	return m;
+}
+
+bool Historial::cabeceraValida(uint16_t pagina, CabeceraHistorial &c) const {
+	uint8_t cab[HISTORIAL_CABECERA];
+	uint16_t dir = direccionPagina(pagina);
+	for (uint8_t i = 0; i < HISTORIAL_CABECERA; i++) cab[i] = EEPROM.read(dir + i);
+	return decodificarCabecera(cab, c);
+}
+
+void Historial::begin() {
+	bool alguna = false;
+	uint16_t ultimaSecuencia = 0;
+	uint16_t ultimoArranque = 0;
+	uint8_t ultima = HISTORIAL_PAGINAS - 1;
+	for (uint8_t p = 0; p < HISTORIAL_PAGINAS; p++) {
+		CabeceraHistorial c;
+		if (!cabeceraValida(p, c)) continue;
+		// Comparaciones modulo 2^16: la secuencia puede dar la vuelta
+		if (!alguna || (int16_t)(c.secuencia - ultimaSecuencia) > 0) {
+			ultimaSecuencia = c.secuencia;
+			ultima = p;
+		}
+		if (!alguna || (int16_t)(c.arranque - ultimoArranque) > 0) ultimoArranque = c.arranque;
+		alguna = true;
+	}
+	_pagina = ultima;
+	_secuencia = ultimaSecuencia;
+	_arranque = alguna ? ultimoArranque + 1 : 0;
+	_pos = 0;
+}
+
+void Historial::encolar(uint16_t dir, uint8_t valor) {
+	Escritura &e = _cola[(uint8_t)(_inicioCola + _largoCola) % HISTORIAL_COLA];
+	e.dir = dir;
+	e.valor = valor;
+	_largoCola++;
+}
+
+// Primero el terminador tras la cabecera (lo que quede de la vuelta anterior
+// deja de leerse), despues la cabecera
+void Historial::abrirPagina(const CabeceraHistorial &c) {
+	_pagina = (uint8_t)((_pagina + 1) % HISTORIAL_PAGINAS);
+	_secuencia = c.secuencia;
+	_pos = HISTORIAL_CABECERA;
+	uint16_t dir = direccionPagina(_pagina);
+	uint8_t cab[HISTORIAL_CABECERA];
+	codificarCabecera(c, cab);
+	encolar(dir + HISTORIAL_CABECERA, HISTORIAL_LIBRE);
+	for (uint8_t i = 0; i < HISTORIAL_CABECERA; i++) encolar(dir + i, cab[i]);
+}
+
+bool Historial::registrar(const MuestraHistorial &m) {
+	uint8_t reg[HISTORIAL_MAX_REGISTRO];
+	uint8_t largo = 0;
+	bool nueva = _pos == 0;
+	if (!nueva) {
+		largo = codificarMuestra(m, _previa, _secuencia, reg);
+		nueva = _pos + largo > HISTORIAL_PAGINA;
+	}
+	CabeceraHistorial c;
+	if (nueva) {
+		c.secuencia = _secuencia + 1;
+		c.arranque = _arranque;
+		c.segundos = m.segundos;
+		largo = codificarMuestra(m, muestraInicial(c), c.secuencia, reg);
+	}
+
+	uint8_t necesarias = largo + 1 + (nueva ? HISTORIAL_CABECERA + 1 : 0);
+	if (HISTORIAL_COLA - _largoCola < necesarias) {
+		_descartadas++;
+		return false;
+	}
+	if (nueva) abrirPagina(c);
+
+	// Terminador, datos y por ultimo el largo, que pisa el terminador del
+	// registro anterior: hasta ese byte el registro no existe
+	uint16_t dir = direccionPagina(_pagina) + _pos;
+	if (_pos + largo < HISTORIAL_PAGINA) encolar(dir + largo, HISTORIAL_LIBRE);
+	for (uint8_t i = 1; i < largo; i++) encolar(dir + i, reg[i]);
+	encolar(dir, reg[0]);
+	_pos += largo;
+	_previa = m;
+	return true;
+}
+
+void Historial::servicio() {
+	if (_largoCola > 0) {
+		const Escritura &e = _cola[_inicioCola];
+		EEPROM.update(e.dir, e.valor);
+		_inicioCola = (uint8_t)(_inicioCola + 1) % HISTORIAL_COLA;
+		_largoCola--;
+		return;
+	}
+	if (_volcado != 0) avanzarVolcado();
+}
+
+void Historial::volcar() {
+	if (_volcado == 0) _volcado = HISTORIAL_INICIO;
+}
+
+void Historial::avanzarVolcado() {
+	// Las paginas sin cabecera valida (nunca escritas) no se envian
+	while (_volcado < HISTORIAL_FIN && (_volcado - HISTORIAL_INICIO) % HISTORIAL_PAGINA == 0) {
+		CabeceraHistorial c;
+		if (cabeceraValida((_volcado - HISTORIAL_INICIO) / HISTORIAL_PAGINA, c)) break;
+		_volcado += HISTORIAL_PAGINA;
+	}
+	if (_volcado >= HISTORIAL_FIN) {
+		if (bitacora.historial(HISTORIAL_FIN, nullptr, 0)) _volcado = 0;
+		return;
+	}
+	uint8_t bloque[HISTORIAL_BLOQUE_VOLCADO];
+	for (uint8_t i = 0; i < HISTORIAL_BLOQUE_VOLCADO; i++) bloque[i] = EEPROM.read(_volcado + i);
+	if (bitacora.historial(_volcado, bloque, HISTORIAL_BLOQUE_VOLCADO)) _volcado += HISTORIAL_BLOQUE_VOLCADO;
+}
@@ -0,0 +1,90 @@
+#ifndef SMARTCOMFORT_HISTORIAL_H
+#define SMARTCOMFORT_HISTORIAL_H
+
+#include <Arduino.h>
+#include "HistorialFormato.h"
+
+// Zona de la EEPROM para el historial: los primeros 256 bytes quedan para
+// textos de configuracion (leerTextoEEPROM). 30 paginas de 128 bytes, ~14
+// muestras por pagina: unas 70 horas de historia a una muestra cada 10 min.
+#define HISTORIAL_INICIO 256
+#define HISTORIAL_FIN 4096
+#define HISTORIAL_PAGINA 128
+#define HISTORIAL_PAGINAS ((HISTORIAL_FIN - HISTORIAL_INICIO) / HISTORIAL_PAGINA)
+#define HISTORIAL_PERIODO_MS (HISTORIAL_PERIODO_S * 1000UL)
+
+// Escrituras pendientes: un registro, su terminador y la cabecera de una
+// pagina nueva entran siempre
+#define HISTORIAL_COLA (HISTORIAL_CABECERA + 1 + HISTORIAL_MAX_REGISTRO + 1)
+
+// Bytes de EEPROM por trama REG_HISTORIAL del volcado
+#define HISTORIAL_BLOQUE_VOLCADO 32
+
+// Historial de (segundos, Ta, Tr, RH, PMV, estado) en la EEPROM, en el
+// formato de HistorialFormato.h. Cada muestra se codifica en RAM y sus bytes
+// se escriben de a uno por pasada del loop (servicio()): una escritura de
+// EEPROM tarda ~3.3 ms y el loop no la espera entera.
+//
+// Desgaste: las paginas se llenan en rueda, asi que cada celda se escribe
+// una vez por vuelta (dos las que hicieron de terminador) y se usa
+// EEPROM.update(). Una vuelta son unas 70 horas; las 100.000 escrituras que
+// garantiza el ATmega2560 dan para siglos. Cada arranque abre una pagina
+// nueva con su numero de arranque: lo escrito antes de un corte de energia
+// se conserva, y un registro a medias no valida (su largo se escribe al
+// final, sobre el terminador del anterior).
+class Historial {
+public:
+	Historial();
+
+	// Busca la ultima pagina escrita; la proxima muestra abre la siguiente
+	void begin();
+
+	// Codifica la muestra y encola sus bytes; false (y se descarta) si no
+	// entra en la cola
+	bool registrar(const MuestraHistorial &m);
+
+	// Escribe un byte pendiente o, sin escrituras pendientes, avanza el
+	// volcado en curso. Va en cada pasada del loop.
+	void servicio();
+
+	// Empieza a enviar las paginas validas por la bitacora (REG_HISTORIAL),
+	// un bloque por pasada del loop cuando hay lugar, y un bloque vacio al
+	// terminar
+	void volcar();
+	bool volcando() const { return _volcado != 0; }
+
+	// Quedan bytes por escribir o un volcado en curso
+	bool ocupado() const { return _largoCola > 0 || volcando(); }
+
+	uint16_t arranque() const { return _arranque; }
+	unsigned long descartadas() const { return _descartadas; }
+
+	// Muestra con los valores en las unidades del historial
+	static MuestraHistorial muestra(unsigned long ahora, float Ta, float Tr, float RH, float pmv, uint8_t estado);
+
+private:
+	struct Escritura {
+		uint16_t dir;
+		uint8_t valor;
+	};
+
+	void encolar(uint16_t dir, uint8_t valor);
+	void abrirPagina(const CabeceraHistorial &c);
+	bool cabeceraValida(uint16_t pagina, CabeceraHistorial &c) const;
+	void avanzarVolcado();
+
+	Escritura _cola[HISTORIAL_COLA];
+	uint8_t _inicioCola;
+	uint8_t _largoCola;
+	uint16_t _secuencia;   // de la pagina en curso
+	uint16_t _arranque;
+	uint8_t _pagina;       // en curso (tras begin(), la ultima escrita)
+	uint16_t _pos;         // proxima posicion dentro de la pagina; 0: sin abrir
+	MuestraHistorial _previa;
+	uint16_t _volcado;     // proxima direccion a volcar; 0: sin volcado
+	unsigned long _descartadas;
+};
+
+extern Historial historial;
+
+#endif
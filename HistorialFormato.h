@@ -0,0 +1,154 @@
+#ifndef SMARTCOMFORT_HISTORIALFORMATO_H
+#define SMARTCOMFORT_HISTORIALFORMATO_H
+
+#include <stdint.h>
+
+// Formato del historial en EEPROM, compartido por el sketch (Historial.cpp)
+// y el decodificador de host (host/DecodificadorHistorial.cpp).
+//
+// La zona del historial se divide en paginas que se escriben en rueda: al
+// llegar al final se vuelve a la primera, pisando la mas vieja, de modo que
+// cada celda se escribe una vez por vuelta. Cada pagina empieza con una
+// cabecera:
+//
+//   MARCA, secuencia (uint16), arranque (uint16), segundos (uint32), CRC
+//
+// y sigue con registros [largo, datos..., CRC] hasta un byte 0xFF o el fin
+// de la pagina. Los datos son diferencias con el registro anterior de la
+// pagina (el primero, con muestraInicial()) en varint con zigzag: segundos
+// menos HISTORIAL_PERIODO_S, Ta, Tr, RH, PMV, y al final el estado (un
+// byte). Con la sala estable un registro ocupa 8 bytes. El CRC de los
+// registros arranca en la secuencia de la pagina: lo que quede de la vuelta
+// anterior no valida.
+#define HISTORIAL_MARCA 0x5A
+#define HISTORIAL_CABECERA 10
+#define HISTORIAL_LIBRE 0xFF
+#define HISTORIAL_MAX_REGISTRO 20  // largo + datos + CRC, en el peor caso
+#define HISTORIAL_PERIODO_S 600UL  // una muestra cada 10 minutos
+#define HISTORIAL_SIN_VALOR -32768  // valor NaN
+
+struct MuestraHistorial {
+	uint32_t segundos;  // desde el arranque
+	int16_t Ta;         // decimas de C
+	int16_t Tr;         // decimas de C
+	int16_t RH;         // %
+	int16_t pmv;        // centesimas
+	uint8_t estado;
+};
+
+struct CabeceraHistorial {
+	uint16_t secuencia;  // crece con cada pagina abierta
+	uint16_t arranque;   // crece con cada reinicio de la placa
+	uint32_t segundos;   // de la primera muestra de la pagina
+};
+
+// CRC-8 (polinomio 0x07)
+inline uint8_t crc8Historial(uint8_t crc, uint8_t b) {
+	crc ^= b;
+	for (uint8_t i = 0; i < 8; i++) crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+	return crc;
+}
+
+inline uint8_t crc8Historial(uint8_t crc, const uint8_t *p, uint8_t n) {
+	for (uint8_t i = 0; i < n; i++) crc = crc8Historial(crc, p[i]);
+	return crc;
+}
+
+inline uint8_t ponerVarint(uint8_t *p, uint32_t v) {
+	uint8_t n = 0;
+	while (v >= 0x80) {
+		p[n++] = (uint8_t)(v | 0x80);
+		v >>= 7;
+	}
+	p[n++] = (uint8_t)v;
+	return n;
+}
+
+// Devuelve los bytes consumidos, 0 si el varint no termina antes de 'fin'
+inline uint8_t leerVarint(const uint8_t *p, const uint8_t *fin, uint32_t &v) {
+	v = 0;
+	for (uint8_t n = 0; n < 5 && p + n < fin; n++) {
+		v |= (uint32_t)(p[n] & 0x7F) << (7 * n);
+		if (!(p[n] & 0x80)) return n + 1;
+	}
+	return 0;
+}
+
+inline uint32_t zigzag(int32_t v) {
+	return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+inline int32_t deszigzag(uint32_t v) {
+	return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+// Cabecera de pagina en 'p' (HISTORIAL_CABECERA bytes)
+inline void codificarCabecera(const CabeceraHistorial &c, uint8_t *p) {
+	p[0] = HISTORIAL_MARCA;
+	p[1] = (uint8_t)c.secuencia;
+	p[2] = (uint8_t)(c.secuencia >> 8);
+	p[3] = (uint8_t)c.arranque;
+	p[4] = (uint8_t)(c.arranque >> 8);
+	for (uint8_t i = 0; i < 4; i++) p[5 + i] = (uint8_t)(c.segundos >> (8 * i));
+	p[9] = crc8Historial(0, p, 9);
+}
+
+inline bool decodificarCabecera(const uint8_t *p, CabeceraHistorial &c) {
+	if (p[0] != HISTORIAL_MARCA || crc8Historial(0, p, 9) != p[9]) return false;
+	c.secuencia = (uint16_t)(p[1] | (p[2] << 8));
+	c.arranque = (uint16_t)(p[3] | (p[4] << 8));
+	c.segundos = 0;
+	for (uint8_t i = 0; i < 4; i++) c.segundos |= (uint32_t)p[5 + i] << (8 * i);
+	return true;
+}
+
+// Referencia de las diferencias del primer registro de una pagina
+inline MuestraHistorial muestraInicial(const CabeceraHistorial &c) {
+	MuestraHistorial m;
+	m.segundos = c.segundos - HISTORIAL_PERIODO_S;
+	m.Ta = m.Tr = m.RH = m.pmv = 0;
+	m.estado = 0;
+	return m;
+}
+
+// Registro completo (largo, datos, CRC) en 'p'; devuelve su largo total
+inline uint8_t codificarMuestra(const MuestraHistorial &m, const MuestraHistorial &previa, uint16_t secuencia,
+                                uint8_t *p) {
+	uint8_t n = 1;
+	n += ponerVarint(p + n, zigzag((int32_t)(m.segundos - previa.segundos - HISTORIAL_PERIODO_S)));
+	n += ponerVarint(p + n, zigzag((int32_t)m.Ta - previa.Ta));
+	n += ponerVarint(p + n, zigzag((int32_t)m.Tr - previa.Tr));
+	n += ponerVarint(p + n, zigzag((int32_t)m.RH - previa.RH));
+	n += ponerVarint(p + n, zigzag((int32_t)m.pmv - previa.pmv));
+	p[n++] = m.estado;
+	p[0] = (uint8_t)(n - 1);
+	p[n] = crc8Historial((uint8_t)secuencia, p, n);
+	return n + 1;
+}
+
+// Lee el registro de 'p' (a lo sumo hasta 'fin'); devuelve su largo total,
+// 0 si no hay un registro valido de esta pagina
+inline uint8_t decodificarMuestra(const uint8_t *p, const uint8_t *fin, const MuestraHistorial &previa,
+                                  uint16_t secuencia, MuestraHistorial &m) {
+	if (p >= fin || p[0] == HISTORIAL_LIBRE || p[0] < 6 || p + p[0] + 2 > fin) return 0;
+	uint8_t largo = p[0];
+	if (crc8Historial((uint8_t)secuencia, p, largo + 1) != p[largo + 1]) return 0;
+	const uint8_t *q = p + 1;
+	const uint8_t *finDatos = p + 1 + largo;
+	uint32_t v[5];
+	for (uint8_t i = 0; i < 5; i++) {
+		uint8_t k = leerVarint(q, finDatos, v[i]);
+		if (k == 0) return 0;
+		q += k;
+	}
+	if (q + 1 != finDatos) return 0;
+	m.segundos = previa.segundos + HISTORIAL_PERIODO_S + deszigzag(v[0]);
+	m.Ta = (int16_t)(previa.Ta + deszigzag(v[1]));
+	m.Tr = (int16_t)(previa.Tr + deszigzag(v[2]));
+	m.RH = (int16_t)(previa.RH + deszigzag(v[3]));
+	m.pmv = (int16_t)(previa.pmv + deszigzag(v[4]));
+	m.estado = *q;
+	return largo + 2;
+}
+
+#endif
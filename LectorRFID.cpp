@@ -0,0 +1,97 @@
+#include "LectorRFID.h"
+#include "Bitacora.h"
+#include "Traza.h"
+
+LectorRFID::LectorRFID(MFRC522 &mfrc522, MFRC522::MIFARE_Key &clave, const byte *const *uids, uint8_t numUids)
+	: _mfrc522(mfrc522), _clave(clave), _uids(uids), _numUids(numUids),
+	  _paso(Sondeo), _registrada(false), _desde(0) {
+}
+
+void LectorRFID::reiniciar() {
+	if (_paso != Sondeo && _paso != Espera) {
+		_mfrc522.PICC_HaltA();
+		_mfrc522.PCD_StopCrypto1();
+	}
+	_paso = Sondeo;
+	_desde = 0;
+}
+
+bool LectorRFID::uidRegistrado() const {
+	for (uint8_t i = 0; i < _numUids; i++) {
+		if (memcmp(_mfrc522.uid.uidByte, _uids[i], 4) == 0) return true;
+	}
+	return false;
+}
+
+bool LectorRFID::leerBloque(byte bloque, Texto &destino) {
+	byte buffer[18];
+	byte size = sizeof(buffer);
+	destino.limpiar();
+	MFRC522::StatusCode status =
+		(MFRC522::StatusCode)TRAZA_ENTRADA(TR_RFID, (byte)_mfrc522.MIFARE_Read(bloque, buffer, &size));
+	TRAZA_BYTES(buffer, sizeof(buffer));
+	if (status != MFRC522::STATUS_OK) {
+		bitacora.errorRFID(1, bloque, status);
+		return false;
+	}
+	// Bloque de 16 bytes: el texto termina en el primer 0 o al llenarse
+	for (uint8_t i = 0; i < RFID_TEXTO_MAX && buffer[i] != 0; i++) destino.agregar((char)buffer[i]);
+	return true;
+}
+
+LectorRFID::Evento LectorRFID::actualizar(unsigned long ahora) {
+	switch (_paso) {
+	case Sondeo:
+		if (ahora - _desde < RFID_SONDEO_MS) return Ninguno;
+		_desde = ahora;
+		if (!TRAZA_ENTRADA(TR_RFID, _mfrc522.PICC_IsNewCardPresent())) return Ninguno;
+		if (!TRAZA_ENTRADA(TR_RFID, _mfrc522.PICC_ReadCardSerial())) return Ninguno;
+		_mfrc522.uid.size = TRAZA_ENTRADA(TR_RFID, _mfrc522.uid.size);
+		TRAZA_BYTES(_mfrc522.uid.uidByte, sizeof(_mfrc522.uid.uidByte));
+		
+		_registrada = uidRegistrado();
+		_nombre.limpiar();
+		_temp.limpiar();
+		_paso = _registrada ? Autenticar : Cerrar;
+		return Ninguno;
+		
+	case Autenticar: {
+		// Trailer del sector que contiene ambos bloques
+		byte sectorTrailer = RFID_BLOQUE_NOMBRE - (RFID_BLOQUE_NOMBRE % 4) + 3;
+		MFRC522::StatusCode status = (MFRC522::StatusCode)TRAZA_ENTRADA(TR_RFID, (byte)_mfrc522.PCD_Authenticate(
+			MFRC522::PICC_CMD_MF_AUTH_KEY_A, sectorTrailer, &_clave, &(_mfrc522.uid)));
+		if (status != MFRC522::STATUS_OK) {
+			bitacora.errorRFID(0, RFID_BLOQUE_NOMBRE, status);
+			_paso = Cerrar;
+		} else {
+			_paso = LeerNombre;
+		}
+		return Ninguno;
+	}
+	
+	case LeerNombre:
+		leerBloque(RFID_BLOQUE_NOMBRE, _nombre);
+		_paso = LeerTemp;
+		return Ninguno;
+		
+	case LeerTemp:
+		leerBloque(RFID_BLOQUE_TEMP, _temp);
+		_paso = Cerrar;
+		return Ninguno;
+		
+	case Cerrar:
+		_mfrc522.PICC_HaltA();
+		_mfrc522.PCD_StopCrypto1();
+		_paso = Espera;
+		_desde = ahora;
+		return _registrada ? Registrada : Desconocida;
+		
+	case Espera:
+		if (ahora - _desde >= RFID_ESPERA_MS) {
+			_paso = Sondeo;
+			_desde = ahora - RFID_SONDEO_MS;  // sondear en la proxima pasada
+		}
+		return Ninguno;
+	}
+	return Ninguno;
+}
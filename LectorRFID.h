@@ -0,0 +1,54 @@
+#ifndef SMARTCOMFORT_LECTORRFID_H
+#define SMARTCOMFORT_LECTORRFID_H
+
+#include <Arduino.h>
+#include <MFRC522.h>
+#include "TextoFijo.h"
+
+#define RFID_BLOQUE_NOMBRE 4
+#define RFID_BLOQUE_TEMP 5        // mismo sector que el nombre (4..7)
+#define RFID_SONDEO_MS 100UL      // cada sondeo sin tarjeta ocupa el bus ~25 ms
+#define RFID_ESPERA_MS 2000UL     // mensaje en el LCD antes de volver a leer
+#define RFID_TEXTO_MAX 16
+
+// Lectura del perfil (nombre y temperatura preferida) de una tarjeta en
+// pasos cortos, uno por llamada a actualizar(): sondeo, autenticacion del
+// sector, lectura de cada bloque y cierre de la sesion. El sector 1 se
+// autentica una sola vez para ambos bloques. Tras una lectura el lector
+// descansa RFID_ESPERA_MS sin bloquear el loop.
+class LectorRFID {
+public:
+	enum Evento { Ninguno, Registrada, Desconocida };
+	
+	LectorRFID(MFRC522 &mfrc522, MFRC522::MIFARE_Key &clave, const byte *const *uids, uint8_t numUids);
+	
+	// Avanza un paso; devuelve el evento cuando una lectura termina
+	Evento actualizar(unsigned long ahora);
+	
+	// Cierra una sesion a medias y vuelve a sondear
+	void reiniciar();
+	
+	const char *nombre() const { return _nombre.c_str(); }
+	const char *temperatura() const { return _temp.c_str(); }
+	const MFRC522::Uid &uid() const { return _mfrc522.uid; }
+	
+private:
+	enum Paso { Sondeo, Autenticar, LeerNombre, LeerTemp, Cerrar, Espera };
+	
+	typedef TextoFijo<RFID_TEXTO_MAX> Texto;
+	
+	bool leerBloque(byte bloque, Texto &destino);
+	bool uidRegistrado() const;
+	
+	MFRC522 &_mfrc522;
+	MFRC522::MIFARE_Key &_clave;
+	const byte *const *_uids;
+	uint8_t _numUids;
+	Paso _paso;
+	bool _registrada;
+	unsigned long _desde;
+	Texto _nombre;
+	Texto _temp;
+};
+
+#endif
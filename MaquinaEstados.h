@@ -0,0 +1,197 @@
+#ifndef SMARTCOMFORT_MAQUINAESTADOS_H
+#define SMARTCOMFORT_MAQUINAESTADOS_H
+
+#include <Arduino.h>
+
+// Maquina de estados dirigida por tablas. Las transiciones se declaran en un
+// arreglo constexpr (estado x entrada -> estado siguiente, con guarda
+// opcional) y en compilacion se arma una tabla de despacho con una mascara
+// de 16 bits por celda (estado, entrada): los bits son las transiciones que
+// aplican, en el orden en que se declararon. actualizar() lee la celda y
+// solo evalua esas guardas, en lugar de recorrer todas las transiciones como
+// StateMachineLib. Las tablas van en flash.
+//
+// Todo lo que sigue es C++11 (una expresion por funcion constexpr) para que
+// compile con el core de AVR.
+
+#define ENTRADA_CUALQUIERA 0xFF    // transicion valida con cualquier entrada
+#define MAQUINA_MAX_TRANSICIONES 16
+
+typedef bool (*GuardaEstado)();
+typedef void (*AccionEstado)();
+
+struct Transicion {
+	uint8_t desde;
+	uint8_t entrada;      // o ENTRADA_CUALQUIERA
+	uint8_t hacia;
+	GuardaEstado guarda;  // nullptr: siempre
+};
+
+struct AccionesEstado {
+	AccionEstado alEntrar;
+	AccionEstado alSalir;
+};
+
+// --- Construccion y validacion en compilacion --------------------------
+
+constexpr bool transicionAplica(const Transicion &t, uint8_t estado, uint8_t entrada) {
+	return t.desde == estado && (t.entrada == entrada || t.entrada == ENTRADA_CUALQUIERA);
+}
+
+constexpr uint16_t mascaraCelda(const Transicion *t, uint8_t n, uint8_t estado, uint8_t entrada, uint8_t k = 0) {
+	return k >= n ? 0
+		: (uint16_t)((transicionAplica(t[k], estado, entrada) ? (1u << k) : 0u) |
+		             mascaraCelda(t, n, estado, entrada, k + 1));
+}
+
+constexpr bool transicionValida(const Transicion &t, uint8_t numEstados, uint8_t numEntradas) {
+	return t.desde < numEstados && t.hacia < numEstados &&
+	       (t.entrada < numEntradas || t.entrada == ENTRADA_CUALQUIERA);
+}
+
+constexpr bool transicionesValidas(const Transicion *t, uint8_t n, uint8_t numEstados, uint8_t numEntradas,
+                                   uint8_t k = 0) {
+	return k >= n || (transicionValida(t[k], numEstados, numEntradas) &&
+	                  transicionesValidas(t, n, numEstados, numEntradas, k + 1));
+}
+
+// t[j] (anterior) tapa a t[k] si aplica a las mismas celdas y, o no tiene
+// guarda, o tiene la misma: t[k] no podria dispararse nunca
+constexpr bool tapa(const Transicion &j, const Transicion &k) {
+	return j.desde == k.desde && (j.entrada == k.entrada || j.entrada == ENTRADA_CUALQUIERA) &&
+	       (j.guarda == nullptr || j.guarda == k.guarda);
+}
+
+constexpr bool tapadaPorAnterior(const Transicion *t, uint8_t k, uint8_t j = 0) {
+	return j >= k ? false : (tapa(t[j], t[k]) || tapadaPorAnterior(t, k, j + 1));
+}
+
+constexpr bool hayTransicionInalcanzable(const Transicion *t, uint8_t n, uint8_t k = 1) {
+	return k >= n ? false : (tapadaPorAnterior(t, k) || hayTransicionInalcanzable(t, n, k + 1));
+}
+
+// Estados alcanzables desde 'inicial' (mascara de bits), por punto fijo
+constexpr uint32_t destinosDesde(const Transicion *t, uint8_t n, uint32_t alcanzados, uint8_t k = 0) {
+	return k >= n ? alcanzados
+		: destinosDesde(t, n, ((alcanzados >> t[k].desde) & 1u) ? (alcanzados | (1ul << t[k].hacia)) : alcanzados,
+		                k + 1);
+}
+
+constexpr uint32_t alcanzablesPasos(const Transicion *t, uint8_t n, uint32_t alcanzados, uint8_t pasos) {
+	return pasos == 0 ? alcanzados : alcanzablesPasos(t, n, destinosDesde(t, n, alcanzados), pasos - 1);
+}
+
+constexpr bool todosAlcanzables(const Transicion *t, uint8_t n, uint8_t numEstados, uint8_t inicial) {
+	return alcanzablesPasos(t, n, 1ul << inicial, numEstados) == (numEstados >= 32 ? ~0ul : (1ul << numEstados) - 1);
+}
+
+// Tabla de despacho: una mascara por celda, fila por estado
+template <uint8_t S, uint8_t E>
+struct TablaDespacho {
+	uint16_t celdas[S * E];
+};
+
+template <uint16_t... I>
+struct IndicesCeldas {};
+
+template <uint16_t N, uint16_t... I>
+struct HacerIndicesCeldas : HacerIndicesCeldas<N - 1, N - 1, I...> {};
+
+template <uint16_t... I>
+struct HacerIndicesCeldas<0, I...> {
+	typedef IndicesCeldas<I...> tipo;
+};
+
+template <uint8_t S, uint8_t E, uint16_t... I>
+constexpr TablaDespacho<S, E> construirDespacho(const Transicion *t, uint8_t n, IndicesCeldas<I...>) {
+	return TablaDespacho<S, E>{ { mascaraCelda(t, n, I / E, I % E)... } };
+}
+
+template <uint8_t S, uint8_t E>
+constexpr TablaDespacho<S, E> construirDespacho(const Transicion *t, uint8_t n) {
+	return construirDespacho<S, E>(t, n, typename HacerIndicesCeldas<S * E>::tipo());
+}
+
+// Verifica una tabla de transiciones en compilacion y arma su despacho
+#define MAQUINA_TABLA(nombre, transiciones, numEstados, numEntradas, inicial)                                   \
+	static_assert(sizeof(transiciones) / sizeof(transiciones[0]) <= MAQUINA_MAX_TRANSICIONES,                   \
+	              "demasiadas transiciones para una mascara de 16 bits");                                        \
+	static_assert(transicionesValidas(transiciones, sizeof(transiciones) / sizeof(transiciones[0]), numEstados, \
+	                                  numEntradas),                                                              \
+	              "transicion con estado o entrada fuera de rango");                                            \
+	static_assert(!hayTransicionInalcanzable(transiciones, sizeof(transiciones) / sizeof(transiciones[0])),      \
+	              "transicion duplicada o tapada por una anterior sin guarda");                                  \
+	static_assert(todosAlcanzables(transiciones, sizeof(transiciones) / sizeof(transiciones[0]), numEstados,    \
+	                               inicial),                                                                     \
+	              "hay estados inalcanzables desde el inicial");                                                 \
+	constexpr TablaDespacho<numEstados, numEntradas> nombre PROGMEM =                                           \
+		construirDespacho<numEstados, numEntradas>(transiciones, sizeof(transiciones) / sizeof(transiciones[0]))
+
+// --- Ejecucion ---------------------------------------------------------
+
+template <uint8_t S, uint8_t E>
+class MaquinaEstados {
+public:
+	// Los tres arreglos en flash (PROGMEM)
+	MaquinaEstados(const Transicion *transiciones, const TablaDespacho<S, E> &despacho,
+	               const AccionesEstado *acciones)
+		: _transiciones(transiciones), _despacho(despacho), _acciones(acciones), _estado(0) {}
+
+	// Fija el estado inicial; con alEntrar = true corre su accion de entrada
+	void iniciar(uint8_t estado, bool alEntrar = true) {
+		uint8_t desde = _estado;
+		_estado = estado;
+#ifndef __AVR__
+		sim::notifyStateChange(desde, estado);
+#endif
+		if (alEntrar) {
+			AccionesEstado a = acciones(estado);
+			if (a.alEntrar != nullptr) a.alEntrar();
+		}
+	}
+
+	// Dispara la primera transicion (en orden de declaracion) de la celda
+	// (estado, entrada) cuya guarda se cumple
+	bool actualizar(uint8_t entrada) {
+		uint16_t m = entrada < E ? pgm_read_word(&_despacho.celdas[_estado * E + entrada]) : 0;
+		while (m != 0) {
+			uint8_t k = (uint8_t)__builtin_ctz(m);
+			Transicion t;
+			memcpy_P(&t, &_transiciones[k], sizeof(t));
+			if (t.guarda == nullptr || t.guarda()) {
+				cambiar(t.hacia);
+				return true;
+			}
+			m &= (uint16_t)(m - 1);
+		}
+		return false;
+	}
+
+	uint8_t estado() const { return _estado; }
+
+private:
+	AccionesEstado acciones(uint8_t estado) const {
+		AccionesEstado a;
+		memcpy_P(&a, &_acciones[estado], sizeof(a));
+		return a;
+	}
+
+	void cambiar(uint8_t hacia) {
+		uint8_t desde = _estado;
+		AccionesEstado salida = acciones(desde);
+		if (salida.alSalir != nullptr) salida.alSalir();
+		_estado = hacia;
+#ifndef __AVR__
+		sim::notifyStateChange(desde, hacia);
+#endif
+		AccionesEstado entrada = acciones(hacia);
+		if (entrada.alEntrar != nullptr) entrada.alEntrar();
+	}
+
+	const Transicion *_transiciones;
+	const TablaDespacho<S, E> &_despacho;
+	const AccionesEstado *_acciones;
+	uint8_t _estado;
+};
+
+#endif
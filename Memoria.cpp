@@ -0,0 +1,28 @@
+#include "Memoria.h"
+
+static size_t heap_maximo = 0;
+
+#ifdef __AVR__
+extern char __heap_start;
+extern char *__brkval;
+
+size_t heapUsado() {
+	// __brkval es 0 hasta el primer malloc
+	return __brkval == 0 ? 0 : (size_t)(__brkval - &__heap_start);
+}
+#else
+size_t heapUsado() {
+	return sim::heapUsado();
+}
+#endif
+
+size_t heapMaximo() {
+	return heap_maximo;
+}
+
+bool muestrearHeap() {
+	size_t usado = heapUsado();
+	if (usado <= heap_maximo) return false;
+	heap_maximo = usado;
+	return true;
+}
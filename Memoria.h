@@ -0,0 +1,16 @@
+#ifndef SMARTCOMFORT_MEMORIA_H
+#define SMARTCOMFORT_MEMORIA_H
+
+#include <Arduino.h>
+
+// Uso del heap del sketch. En la placa es lo que malloc tomo de la RAM
+// (desde __heap_start hasta __brkval); en el host, lo que anotan los String
+// y la StateMachine simulados.
+size_t heapUsado();
+
+// Marca de agua alta del heap. muestrearHeap() la actualiza y devuelve true
+// si crecio desde la muestra anterior: en regimen no deberia crecer nunca.
+size_t heapMaximo();
+bool muestrearHeap();
+
+#endif
@@ -0,0 +1,30 @@
+// Generado por host/gen_ntc_tabla.cpp: no editar a mano.
+// Temperatura del NTC x100 (beta 3950, R0 10k, serie 10k) cada 8 codigos del ADC.
+#ifndef SMARTCOMFORT_NTCTABLADATOS_H
+#define SMARTCOMFORT_NTCTABLADATOS_H
+
+#define NTC_TABLA_PASO_BITS 3
+#define NTC_TABLA_PRIMER_CODIGO 8
+#define NTC_TABLA_ULTIMO_CODIGO 1016
+#define NTC_TABLA_N 127
+
+static const int16_t ntcTabla[NTC_TABLA_N] PROGMEM = {
+	 19680,  16062,  14178,  12928,  12002,  11270,  10668,  10156,
+	  9713,   9322,   8973,   8657,   8369,   8104,   7858,   7630,
+	  7416,   7215,   7025,   6845,   6675,   6512,   6356,   6207,
+	  6064,   5927,   5794,   5666,   5542,   5422,   5306,   5192,
+	  5082,   4975,   4871,   4769,   4669,   4572,   4477,   4383,
+	  4291,   4201,   4113,   4026,   3941,   3857,   3774,   3692,
+	  3611,   3532,   3453,   3375,   3298,   3222,   3147,   3072,
+	  2998,   2925,   2852,   2780,   2708,   2637,   2566,   2496,
+	  2425,   2355,   2286,   2216,   2147,   2078,   2009,   1940,
+	  1871,   1802,   1734,   1665,   1596,   1526,   1457,   1388,
+	  1318,   1248,   1177,   1107,   1036,    964,    892,    819,
+	   746,    672,    597,    521,    445,    367,    289,    209,
+	   129,     47,    -37,   -122,   -209,   -297,   -388,   -481,
+	  -576,   -673,   -774,   -878,   -985,  -1096,  -1211,  -1332,
+	 -1458,  -1590,  -1729,  -1876,  -2033,  -2202,  -2385,  -2584,
+	 -2806,  -3055,  -3341,  -3682,  -4108,  -4687,  -5643
+};
+
+#endif
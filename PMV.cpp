@@ -0,0 +1,142 @@
+#include "PMV.h"
+#include "PMVPerfil.h"
+
+#include <math.h>
+
+// T_cl de la llamada anterior para el arranque en caliente (NAN = en frio)
+static float pmv_tcl_previa = NAN;
+
+float saturation_vapor_pressure_kPa(float T) {
+	return 0.6105f * expf((17.27f * T) / (T + 237.3f));
+}
+
+void resetPMVArranque() {
+	pmv_tcl_previa = NAN;
+}
+
+// Entradas saneadas igual que en la version original
+static bool sanearEntradas(float &Ta, float &Tr, float &RH, float &va) {
+	if (isnan(Ta) || isnan(Tr) || isnan(RH)) return false;
+	if (Ta < -10.0f || Ta > 50.0f) Ta = 25.0f;
+	if (Tr < -10.0f || Tr > 50.0f) Tr = Ta;
+	if (RH < 0.0f) RH = 0.0f;
+	if (RH > 100.0f) RH = 100.0f;
+	if (va < 0.0f) va = 0.1f;
+	return true;
+}
+
+static inline float cuarta(float x) {
+	float x2 = x * x;
+	return x2 * x2;
+}
+
+// Balance final del punto fijo original una vez conocida T_cl (Newton usa
+// balancePMV de PMVPerfil.h)
+static float balancePuntoFijo(float Ta, float Tr, float p_a, float M, float f_cl, float h_cf, float T_cl) {
+	const float W = 0.0f;
+	
+	float h_c = h_cf;
+	float h_c2 = 2.38f * sqrtf(sqrtf(fabsf(T_cl - Ta)));
+	if (h_c2 > h_c) h_c = h_c2;
+	
+	float rad = 3.96e-8f * f_cl * (cuarta(T_cl + 273.15f) - cuarta(Tr + 273.15f));
+	
+	float PMV_factor = 0.303f * expf(-0.036f * M) + 0.028f;
+	float PMV_balance = (M - W) 
+		- 3.05e-3f * (5733.0f - 6.99f * (M - W) - p_a) 
+		- 0.42f * ((M - W) - 58.15f)
+		- 1.7e-5f * M * (5867.0f - p_a) 
+		- 0.0014f * M * (34.0f - Ta) 
+		- rad 
+		- f_cl * h_c * (T_cl - Ta);
+	
+	float pmv = PMV_factor * PMV_balance;
+	
+	if (pmv > 3.0f) pmv = 3.0f;
+	if (pmv < -3.0f) pmv = -3.0f;
+	return pmv;
+}
+
+// Cache de terminos por perfil: pocos perfiles distintos en uso, reemplazo
+// circular. Un perfil nuevo cuesta un expf y un sqrtf; uno repetido, tres
+// comparaciones.
+#define PMV_PERFILES_CACHE 4
+
+struct EntradaPerfil {
+	float met, clo, va;
+	TerminosPMV terminos;
+};
+
+static EntradaPerfil pmv_perfiles[PMV_PERFILES_CACHE];
+static uint8_t pmv_perfiles_usados = 0;
+static uint8_t pmv_perfil_siguiente = 0;
+
+const TerminosPMV &terminosPMV(float met, float clo, float va) {
+	for (uint8_t i = 0; i < pmv_perfiles_usados; i++) {
+		const EntradaPerfil &e = pmv_perfiles[i];
+		if (e.met == met && e.clo == clo && e.va == va) return e.terminos;
+	}
+	EntradaPerfil &e = pmv_perfiles[pmv_perfil_siguiente];
+	e.met = met;
+	e.clo = clo;
+	e.va = va;
+	const float M = met * 58.15f;
+	e.terminos = terminosPMVDesde(M, clo, sqrtf(pmvVaSaneada(va)), expf(-0.036f * M));
+	if (pmv_perfiles_usados < PMV_PERFILES_CACHE) pmv_perfiles_usados++;
+	pmv_perfil_siguiente = (pmv_perfil_siguiente + 1) % PMV_PERFILES_CACHE;
+	return e.terminos;
+}
+
+PMVResult computePMV(float Ta, float Tr, float RH, float met, float clo, float va) {
+	return nucleoPMV(terminosPMV(met, clo, va), Ta, Tr, RH, pmv_tcl_previa);
+}
+
+PMVResult computePMVPuntoFijo(float Ta, float Tr, float RH, float met, float clo, float va) {
+	if (!sanearEntradas(Ta, Tr, RH, va)) {
+		return { 0.0f, NAN, 0 };
+	}
+	
+	const float M = met * 58.15f;
+	const float W = 0.0f;
+	
+	float p_sat = saturation_vapor_pressure_kPa(Ta);
+	float p_a = (RH / 100.0f) * p_sat * 1000.0f;
+	
+	float f_cl = (clo <= 0.078f) ? (1.05f + 0.1f * clo) : (1.0f + 0.2f * clo);
+	float I_cl = clo * 0.155f;
+	float T_cl = Ta + 0.1f;
+	
+	uint8_t it = 0;
+	for (int i = 0; i < 200; i++) {
+		it++;
+		float h_c = 12.1f * sqrtf(va > 0.0001f ? va : 0.0001f);
+		float delta = fabsf(T_cl - Ta);
+		float h_c2 = 2.38f * powf(delta, 0.25f);
+		if (h_c2 > h_c) h_c = h_c2;
+		
+		float tclK = T_cl + 273.15f;
+		float trK = Tr + 273.15f;
+		float rad = 3.96e-8f * f_cl * (powf(tclK, 4.0f) - powf(trK, 4.0f));
+		
+		float T_new = 35.7f - 0.028f * (M - W) - I_cl * (rad + f_cl * h_c * (T_cl - Ta));
+		
+		if (fabsf(T_new - T_cl) < 1e-4f) {
+			T_cl = T_new;
+			break;
+		}
+		T_cl = T_new;
+	}
+	
+	float h_cf = 12.1f * sqrtf(va > 0.0001f ? va : 0.0001f);
+	return { balancePuntoFijo(Ta, Tr, p_a, M, f_cl, h_cf, T_cl), T_cl, it };
+}
+
+PMVResult evaluarPMV(float Ta, float Tr, float RH) {
+#if PMV_MOTOR == PMV_MOTOR_TABLA
+	return computePMVTabla(Ta, Tr, RH);
+#elif PMV_MOTOR == PMV_MOTOR_FIJO
+	return computePMVFijo(Ta, Tr, RH);
+#else
+	return computePMVPerfil<PerfilSketch>(Ta, Tr, RH);
+#endif
+}
@@ -0,0 +1,69 @@
+#ifndef SMARTCOMFORT_PMV_H
+#define SMARTCOMFORT_PMV_H
+
+#include <stdint.h>
+
+// Perfil de actividad/ropa/aire fijo usado por el sketch
+#define PMV_MET 1.0f
+#define PMV_CLO 0.61f
+#define PMV_VA 0.1f
+#define PMV_MET_Q8 ((uint16_t)(PMV_MET * 256.0f + 0.5f))
+#define PMV_CLO_Q8 ((uint16_t)(PMV_CLO * 256.0f + 0.5f))
+#define PMV_VA_Q8 ((uint16_t)(PMV_VA * 256.0f + 0.5f))
+
+// Motor usado por evaluarPMV(). Se elige en compilacion (-DPMV_MOTOR=...).
+#define PMV_MOTOR_NEWTON 0   // computePMV: balance completo
+#define PMV_MOTOR_TABLA 1    // computePMVTabla: rejilla en flash, interpolada
+#define PMV_MOTOR_FIJO 2     // computePMVFijo: enteros en punto fijo, sin FPU
+#ifndef PMV_MOTOR
+#define PMV_MOTOR PMV_MOTOR_NEWTON
+#endif
+
+// Resultado del calculo de confort. t_cl e iteraciones permiten medir el
+// solver de temperatura de la ropa (ver PMVBench.cpp).
+struct PMVResult {
+	float pmv;
+	float t_cl;
+	uint8_t iteraciones;
+};
+
+// Tope de iteraciones del solver de Newton con salvaguarda por biseccion.
+// Con la raiz acotada cada paso reduce el intervalo al menos a la mitad, asi
+// que 24 pasos bastan para llegar a 1e-4 C desde cualquier intervalo de 60 C.
+#define PMV_NEWTON_MAX_ITER 24
+#define PMV_TCL_TOLERANCIA 1e-4f
+
+float saturation_vapor_pressure_kPa(float T);
+
+// PMV segun el balance termico de Fanger. Resuelve T_cl con Newton-Raphson
+// arrancando desde la T_cl de la llamada anterior (arranque en caliente).
+// Coincide con computePMVPuntoFijo dentro de |dPMV| < 1e-4 en todo punto
+// donde el punto fijo converge (ver host/bench_main.cpp). Los terminos que
+// solo dependen de met/clo/va se guardan por perfil (PMVPerfil.h); para un
+// perfil constante, computePMVPerfil<Perfil> los pliega en compilacion.
+PMVResult computePMV(float Ta, float Tr, float RH, float met, float clo, float va);
+
+// Solver original por iteracion de punto fijo (hasta 200 pasos). Se conserva
+// como referencia para las comparaciones de precision y tiempo.
+PMVResult computePMVPuntoFijo(float Ta, float Tr, float RH, float met, float clo, float va);
+
+// Olvida la T_cl previa (el siguiente computePMV arranca en frio).
+void resetPMVArranque();
+
+// PMV por interpolacion trilineal en la rejilla precalculada de
+// PMVTablaDatos.h (perfil fijo PMV_MET/PMV_CLO/PMV_VA). Error maximo frente a
+// computePMV: 0.02 con |PMV| <= 2, 0.23 cerca de la saturacion en +-3.
+PMVResult computePMVTabla(float Ta, float Tr, float RH);
+
+// PMV en punto fijo (PMVFijo.cpp): entradas en Q8 (valor x 256), resultado
+// en Q10 recortado a +-3. Solo enteros de 32 bits, sin soft-float. Error
+// frente a computePMV: max 0.027 (rms 0.003) en el rango saneado de entrada.
+int16_t computePMVQ(int16_t ta_q8, int16_t tr_q8, uint16_t rh_q8, uint16_t met_q8, uint16_t clo_q8, uint16_t va_q8);
+
+// Envoltorio float de computePMVQ con el perfil fijo.
+PMVResult computePMVFijo(float Ta, float Tr, float RH);
+
+// PMV del perfil fijo con el motor elegido en PMV_MOTOR.
+PMVResult evaluarPMV(float Ta, float Tr, float RH);
+
+#endif
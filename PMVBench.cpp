@@ -0,0 +1,651 @@
+#include "PMVBench.h"
+#include "PMV.h"
+#include "PMVPerfil.h"
+#include "PMVIncremental.h"
+#include "PMVConsigna.h"
+#include "ConfortISO.h"
+#include "Planificador.h"
+#include "MaquinaEstados.h"
+#include "Sensores.h"
+#include <AsyncTaskLib.h>
+#include <StateMachineLib.h>
+
+// Rejilla pequena para que quepa en el tiempo de arranque del AVR: 6 x 4 x 4
+// puntos dentro del rango habitual de la sala.
+static const float benchTa[] = { 16.0f, 19.0f, 22.0f, 25.0f, 28.0f, 31.0f };
+static const float benchDTr[] = { -2.0f, 0.0f, 1.5f, 3.0f };
+static const float benchRH[] = { 20.0f, 45.0f, 65.0f, 85.0f };
+
+#define BENCH_NTA (sizeof(benchTa) / sizeof(benchTa[0]))
+#define BENCH_NTR (sizeof(benchDTr) / sizeof(benchDTr[0]))
+#define BENCH_NRH (sizeof(benchRH) / sizeof(benchRH[0]))
+
+struct ResultadoBench {
+	unsigned long micros;
+	unsigned long iteraciones;
+	unsigned long llamadas;
+};
+
+// Recorre la rejilla en orden (como el loop: entradas que cambian poco entre
+// llamadas consecutivas), lo que favorece el arranque en caliente.
+static ResultadoBench medir(MotorPMV motor, RelojMicros reloj, uint16_t repeticiones) {
+	ResultadoBench r = { 0, 0, 0 };
+	volatile float sumidero = 0.0f;
+	unsigned long t0 = reloj();
+	for (uint16_t rep = 0; rep < repeticiones; rep++) {
+		for (uint8_t i = 0; i < BENCH_NTA; i++) {
+			for (uint8_t j = 0; j < BENCH_NTR; j++) {
+				for (uint8_t k = 0; k < BENCH_NRH; k++) {
+					PMVResult res = motor(benchTa[i], benchTa[i] + benchDTr[j], benchRH[k], 1.0f, 0.61f, 0.1f);
+					sumidero += res.pmv;
+					r.iteraciones += res.iteraciones;
+					r.llamadas++;
+				}
+			}
+		}
+	}
+	r.micros = reloj() - t0;
+	return r;
+}
+
+static void imprimir(Print &out, const __FlashStringHelper *nombre, const ResultadoBench &r) {
+	out.print(nombre);
+	out.print(F(" iter/llamada="));
+	out.print((float)r.iteraciones / (float)r.llamadas, 2);
+	out.print(F(" us/llamada="));
+	out.println((float)r.micros / (float)r.llamadas, 3);
+}
+
+void benchmarkSolverPMV(Print &out, RelojMicros reloj, uint16_t repeticiones) {
+	out.println(F("--- Solver T_cl de computePMV ---"));
+	
+	ResultadoBench puntoFijo = medir(computePMVPuntoFijo, reloj, repeticiones);
+	imprimir(out, F("punto fijo (original)"), puntoFijo);
+	
+	resetPMVArranque();
+	ResultadoBench newton = medir(computePMV, reloj, repeticiones);
+	imprimir(out, F("Newton + arranque    "), newton);
+	
+	// Peor caso de Newton: arranque en frio en cada llamada
+	ResultadoBench frio = { 0, 0, 0 };
+	unsigned long t0 = reloj();
+	for (uint8_t i = 0; i < BENCH_NTA; i++) {
+		for (uint8_t k = 0; k < BENCH_NRH; k++) {
+			resetPMVArranque();
+			PMVResult res = computePMV(benchTa[i], benchTa[i] + 3.0f, benchRH[k], 1.0f, 0.61f, 0.1f);
+			frio.iteraciones += res.iteraciones;
+			frio.llamadas++;
+		}
+	}
+	frio.micros = reloj() - t0;
+	imprimir(out, F("Newton en frio       "), frio);
+	
+	// Diferencia maxima frente al solver original en la misma rejilla. Donde
+	// el punto fijo agota sus 200 pasos (oscila con conveccion natural, p. ej.
+	// sala fria) su resultado no es una solucion y no se compara.
+	float maxDif = 0.0f;
+	uint16_t sinConvergencia = 0;
+	for (uint8_t i = 0; i < BENCH_NTA; i++) {
+		for (uint8_t j = 0; j < BENCH_NTR; j++) {
+			for (uint8_t k = 0; k < BENCH_NRH; k++) {
+				float Tr = benchTa[i] + benchDTr[j];
+				PMVResult a = computePMV(benchTa[i], Tr, benchRH[k], 1.0f, 0.61f, 0.1f);
+				PMVResult b = computePMVPuntoFijo(benchTa[i], Tr, benchRH[k], 1.0f, 0.61f, 0.1f);
+				if (b.iteraciones >= 200) {
+					sinConvergencia++;
+					continue;
+				}
+				float dif = fabsf(a.pmv - b.pmv);
+				if (dif > maxDif) maxDif = dif;
+			}
+		}
+	}
+	out.print(F("max |dPMV| vs original="));
+	out.print(maxDif, 6);
+	out.print(F(" (original sin converger en "));
+	out.print(sinConvergencia);
+	out.print(F(" de "));
+	out.print((unsigned)(BENCH_NTA * BENCH_NTR * BENCH_NRH));
+	out.println(F(" puntos)"));
+}
+
+typedef PMVResult (*MotorPerfilFijo)(float Ta, float Tr, float RH);
+
+static PMVResult motorNewton(float Ta, float Tr, float RH) {
+	return computePMV(Ta, Tr, RH, PMV_MET, PMV_CLO, PMV_VA);
+}
+
+static PMVResult motorPuntoFijo(float Ta, float Tr, float RH) {
+	return computePMVPuntoFijo(Ta, Tr, RH, PMV_MET, PMV_CLO, PMV_VA);
+}
+
+// Referencia de la rejilla: computeConfortISO con el perfil fijo, recortado
+// a la escala de +-3 como los demas motores
+static PMVResult motorISO(float Ta, float Tr, float RH) {
+	ConfortISO c = computeConfortISO(Ta, Tr, RH, PMV_VA, PMV_MET, PMV_CLO);
+	return { fmaxf(-3.0f, fminf(3.0f, c.pmv)), c.t_cl, c.iteraciones };
+}
+
+// ISO 7730:2005, anexo D, tabla D.1: PMV y PPD de referencia. La fila 7 no
+// es coherente con el resto de la tabla: con las mismas entradas que la 8
+// salvo va = 0.1 da 0.38 mas, cuando entre las filas 9 y 10 (una sala casi
+// igual) el mismo cambio de va resta 0.21. Con las ecuaciones de la norma
+// da 0.36 y PPD 8; se muestra pero no cuenta para el resultado.
+struct ReferenciaISO {
+	float Ta, Tr, va, RH, met, clo;
+	float pmv, ppd;
+	bool incoherente;
+};
+
+static const ReferenciaISO anexoD[] PROGMEM = {
+	{ 22.0f, 22.0f, 0.10f, 60.0f, 1.2f, 0.5f, -0.75f, 17.0f, false },
+	{ 27.0f, 27.0f, 0.10f, 60.0f, 1.2f, 0.5f, 0.77f, 17.0f, false },
+	{ 27.0f, 27.0f, 0.30f, 60.0f, 1.2f, 0.5f, 0.44f, 9.0f, false },
+	{ 23.5f, 25.5f, 0.10f, 60.0f, 1.2f, 0.5f, -0.01f, 5.0f, false },
+	{ 23.5f, 25.5f, 0.30f, 60.0f, 1.2f, 0.5f, -0.55f, 11.0f, false },
+	{ 19.0f, 19.0f, 0.10f, 40.0f, 1.2f, 1.0f, -0.60f, 13.0f, false },
+	{ 23.5f, 23.5f, 0.10f, 40.0f, 1.2f, 1.0f, 0.50f, 10.0f, true },
+	{ 23.5f, 23.5f, 0.30f, 40.0f, 1.2f, 1.0f, 0.12f, 5.0f, false },
+	{ 23.0f, 21.0f, 0.10f, 40.0f, 1.2f, 1.0f, 0.05f, 5.0f, false },
+	{ 23.0f, 21.0f, 0.30f, 40.0f, 1.2f, 1.0f, -0.16f, 6.0f, false },
+	{ 22.0f, 22.0f, 0.10f, 60.0f, 1.6f, 0.5f, 0.05f, 5.0f, false },
+	{ 27.0f, 27.0f, 0.10f, 60.0f, 1.6f, 0.5f, 1.17f, 34.0f, false },
+	{ 27.0f, 27.0f, 0.30f, 60.0f, 1.6f, 0.5f, 0.95f, 24.0f, false },
+};
+#define BENCH_NANEXO (sizeof(anexoD) / sizeof(anexoD[0]))
+
+static ReferenciaISO filaAnexoD(uint8_t i) {
+	ReferenciaISO f;
+	memcpy_P(&f, &anexoD[i], sizeof(f));
+	return f;
+}
+
+float errorAnexoD(MotorPMV motor) {
+	float maxErr = 0.0f;
+	for (uint8_t i = 0; i < BENCH_NANEXO; i++) {
+		ReferenciaISO f = filaAnexoD(i);
+		if (f.incoherente) continue;
+		// Un NaN (punto fijo sin converger) deja al motor sin cifra: NAN
+		float pmv = motor(f.Ta, f.Tr, f.RH, f.met, f.clo, f.va).pmv;
+		if (isnan(pmv)) return NAN;
+		maxErr = fmaxf(maxErr, fabsf(pmv - f.pmv));
+	}
+	return maxErr;
+}
+
+bool benchmarkReferenciaISO(Print &out) {
+	out.println(F("--- ISO 7730 anexo D: computeConfortISO ---"));
+	out.println(F("  Ta    Tr   va  RH met clo |   PMV ref   PPD ref | carga W/m2"));
+	float maxPMV = 0.0f, maxPPD = 0.0f;
+	for (uint8_t i = 0; i < BENCH_NANEXO; i++) {
+		ReferenciaISO f = filaAnexoD(i);
+		ConfortISO c = computeConfortISO(f.Ta, f.Tr, f.RH, f.va, f.met, f.clo);
+		// La tabla da el PMV con dos decimales y el PPD entero
+		if (!f.incoherente) {
+			maxPMV = fmaxf(maxPMV, fabsf(roundf(c.pmv * 100.0f) * 0.01f - f.pmv));
+			maxPPD = fmaxf(maxPPD, fabsf(roundf(c.ppd) - f.ppd));
+		}
+		out.print(f.Ta, 1);
+		out.print(' ');
+		out.print(f.Tr, 1);
+		out.print(' ');
+		out.print(f.va, 1);
+		out.print(' ');
+		out.print(f.RH, 0);
+		out.print(' ');
+		out.print(f.met, 1);
+		out.print(' ');
+		out.print(f.clo, 1);
+		out.print(F(" | "));
+		out.print(c.pmv, 2);
+		out.print(' ');
+		out.print(f.pmv, 2);
+		out.print(' ');
+		out.print(c.ppd, 1);
+		out.print(' ');
+		out.print(f.ppd, 0);
+		out.print(F(" | "));
+		out.print(c.carga, 1);
+		out.println(f.incoherente ? F(" (fila incoherente, no cuenta)") : F(""));
+	}
+	bool ok = maxPMV <= 0.0101f && maxPPD <= 1.0f;
+	out.print(F("max |dPMV|="));
+	out.print(maxPMV, 2);
+	out.print(F(" max |dPPD|="));
+	out.print(maxPPD, 0);
+	out.println(ok ? F(" OK") : F(" FALLA (tolerancia 0.01 y 1 %)"));
+	return ok;
+}
+
+static void medirMotor(Print &out, const __FlashStringHelper *nombre, MotorPerfilFijo motor, MotorPMV variable,
+					   RelojMicros reloj, uint16_t repeticiones) {
+	volatile float sumidero = 0.0f;
+	unsigned long llamadas = 0;
+	unsigned long t0 = reloj();
+	for (uint16_t rep = 0; rep < repeticiones; rep++) {
+		for (uint8_t i = 0; i < BENCH_NTA; i++) {
+			for (uint8_t j = 0; j < BENCH_NTR; j++) {
+				for (uint8_t k = 0; k < BENCH_NRH; k++) {
+					sumidero += motor(benchTa[i], benchTa[i] + benchDTr[j], benchRH[k]).pmv;
+					llamadas++;
+				}
+			}
+		}
+	}
+	float us = (float)(reloj() - t0) / (float)llamadas;
+	
+	float maxErr = 0.0f, sumaCuad = 0.0f;
+	for (uint8_t i = 0; i < BENCH_NTA; i++) {
+		for (uint8_t j = 0; j < BENCH_NTR; j++) {
+			for (uint8_t k = 0; k < BENCH_NRH; k++) {
+				float Tr = benchTa[i] + benchDTr[j];
+				float err = fabsf(motor(benchTa[i], Tr, benchRH[k]).pmv - motorISO(benchTa[i], Tr, benchRH[k]).pmv);
+				if (err > maxErr) maxErr = err;
+				sumaCuad += err * err;
+			}
+		}
+	}
+	
+	out.print(nombre);
+	out.print(F(" us/eval="));
+	out.print(us, 3);
+#ifdef F_CPU
+	out.print(F(" ciclos/eval="));
+	out.print((unsigned long)(us * (F_CPU / 1000000UL)));
+#endif
+	out.print(F(" max|err|="));
+	out.print(maxErr, 4);
+	out.print(F(" rms="));
+	out.print(sqrtf(sumaCuad / (float)(BENCH_NTA * BENCH_NTR * BENCH_NRH)), 4);
+	out.print(F(" anexo D="));
+	if (variable != nullptr) out.println(errorAnexoD(variable), 4);
+	else out.println(F("-"));
+}
+
+static PMVResult motorISOVariable(float Ta, float Tr, float RH, float met, float clo, float va) {
+	return { computeConfortISO(Ta, Tr, RH, va, met, clo).pmv, NAN, 0 };
+}
+
+void benchmarkMotoresPMV(Print &out, RelojMicros reloj, uint16_t repeticiones) {
+	out.println(F("--- Motores PMV: tiempo y error frente a ISO 7730 (computeConfortISO) ---"));
+	medirMotor(out, F("ISO 7730    "), motorISO, motorISOVariable, reloj, repeticiones);
+	medirMotor(out, F("punto fijo  "), motorPuntoFijo, computePMVPuntoFijo, reloj, repeticiones);
+	medirMotor(out, F("Newton      "), motorNewton, computePMV, reloj, repeticiones);
+	medirMotor(out, F("Newton const"), computePMVPerfil<PerfilSketch>, nullptr, reloj, repeticiones);
+	medirMotor(out, F("tabla flash "), computePMVTabla, nullptr, reloj, repeticiones);
+	medirMotor(out, F("punto fijo Q"), computePMVFijo, nullptr, reloj, repeticiones);
+}
+
+// Muestra i de la serie de benchIncremental: Ta y RH enteros que cambian cada
+// pocos minutos, Tr en pasos del NTC cada 7 s
+static void muestraSensores(uint16_t i, float &Ta, float &Tr, float &RH) {
+	Ta = 22.0f + (float)((i / 300) % 4);
+	RH = 50.0f + (float)((i / 420) % 5);
+	Tr = 21.5f + 0.02f * (float)((i / 7) % 64);
+}
+
+// Tiempo de la serie con PMVIncremental(epsT, epsRH) o, con epsT < 0, con
+// evaluarPMV() en cada muestra
+static unsigned long microsSerie(float epsT, float epsRH, RelojMicros reloj, uint16_t muestras,
+                                 EstadisticaPMVIncremental &est) {
+	PMVIncremental inc(epsT, epsRH);
+	volatile float sumidero = 0.0f;
+	float Ta, Tr, RH;
+	unsigned long t0 = reloj();
+	for (uint16_t i = 0; i < muestras; i++) {
+		muestraSensores(i, Ta, Tr, RH);
+		sumidero += epsT < 0.0f ? evaluarPMV(Ta, Tr, RH).pmv : inc.evaluar(Ta, Tr, RH).pmv;
+	}
+	unsigned long us = reloj() - t0;
+	est = inc.estadistica();
+	return us;
+}
+
+// Error maximo de PMVIncremental(epsT, epsRH) frente a evaluarPMV()
+static float errorSerie(float epsT, float epsRH, uint16_t muestras) {
+	PMVIncremental inc(epsT, epsRH);
+	float Ta, Tr, RH, maximo = 0.0f;
+	for (uint16_t i = 0; i < muestras; i++) {
+		muestraSensores(i, Ta, Tr, RH);
+		maximo = fmaxf(maximo, fabsf(inc.evaluar(Ta, Tr, RH).pmv - evaluarPMV(Ta, Tr, RH).pmv));
+	}
+	return maximo;
+}
+
+void benchmarkPMVIncremental(Print &out, RelojMicros reloj, uint16_t muestras) {
+	out.println(F("--- PMV incremental (serie de sensores, 1 muestra/s) ---"));
+	EstadisticaPMVIncremental est;
+	unsigned long base = microsSerie(-1.0f, 0.0f, reloj, muestras, est);
+	out.print(F("evaluarPMV siempre     us/muestra="));
+	out.println((float)base / (float)muestras, 3);
+
+	static const float tolerancias[][2] = { { 0.0f, 0.0f }, { 0.05f, 0.5f }, { 0.1f, 1.0f } };
+	for (uint8_t i = 0; i < sizeof(tolerancias) / sizeof(tolerancias[0]); i++) {
+		float epsT = tolerancias[i][0], epsRH = tolerancias[i][1];
+		unsigned long us = microsSerie(epsT, epsRH, reloj, muestras, est);
+		out.print(F("incremental eps="));
+		out.print(epsT, 2);
+		out.print(F("C/"));
+		out.print(epsRH, 1);
+		out.print(F("% us/muestra="));
+		out.print((float)us / (float)muestras, 3);
+		out.print(F(" x"));
+		out.print(us ? (float)base / (float)us : 0.0f, 1);
+		out.print(F(" sin cambio="));
+		out.print(100.0f * (float)est.aciertos / (float)muestras, 1);
+		out.print(F("% parcial="));
+		out.print(100.0f * (float)(est.soloRH + est.soloTr) / (float)muestras, 1);
+		out.print(F("% max|dPMV|="));
+		out.println(errorSerie(epsT, epsRH, muestras), 4);
+	}
+}
+
+static const float benchObjetivo[] = { -0.7f, -0.35f, 0.0f, 0.35f, 0.7f };
+#define BENCH_NOBJ (sizeof(benchObjetivo) / sizeof(benchObjetivo[0]))
+#define BENCH_NCONSIGNA (BENCH_NTA * BENCH_NRH * BENCH_NOBJ)
+
+typedef ConsignaPMV (*SolverConsigna)(float objetivo, float Tr, float RH, ArranqueConsigna &previa);
+
+static ConsignaPMV consignaNewton(float objetivo, float Tr, float RH, ArranqueConsigna &previa) {
+	static constexpr TerminosPMV terminos = terminosPMVConst(PMV_MET, PMV_CLO, PMV_VA);
+	return consignaPMV(terminos, objetivo, Tr, RH, previa);
+}
+
+// Punto n de la medida: en frio, la rejilla de Tr, RH y objetivo (cada
+// llamada olvida la anterior); en serie, la de los sensores con el objetivo
+// de un usuario, arrancando en la consigna anterior
+static void puntoConsigna(uint16_t n, bool serie, float &objetivo, float &Tr, float &RH) {
+	if (serie) {
+		float Ta;
+		muestraSensores(n, Ta, Tr, RH);
+		objetivo = -0.5f;
+		return;
+	}
+	n %= BENCH_NCONSIGNA;
+	Tr = benchTa[n / (BENCH_NRH * BENCH_NOBJ)];
+	RH = benchRH[(n / BENCH_NOBJ) % BENCH_NRH];
+	objetivo = benchObjetivo[n % BENCH_NOBJ];
+}
+
+static void medirConsigna(Print &out, const __FlashStringHelper *nombre, SolverConsigna solver, MotorPerfilFijo motor,
+                          bool serie, RelojMicros reloj, uint16_t llamadas) {
+	ArranqueConsigna previa;
+	volatile float sumidero = 0.0f;
+	float objetivo, Tr, RH;
+	unsigned long t0 = reloj();
+	for (uint16_t n = 0; n < llamadas; n++) {
+		puntoConsigna(n, serie, objetivo, Tr, RH);
+		if (!serie) previa.olvidar();
+		sumidero += solver(objetivo, Tr, RH, previa).Ta;
+	}
+	float us = (float)(reloj() - t0) / (float)llamadas;
+
+	// Evaluaciones y error: |PMV(consigna) - objetivo| con el motor que el
+	// solver invierte y con Newton
+	previa.olvidar();
+	unsigned long evaluaciones = 0;
+	uint8_t maxEval = 0;
+	uint16_t saturadas = 0;
+	float maxErr = 0.0f, maxErrNewton = 0.0f;
+	for (uint16_t n = 0; n < llamadas; n++) {
+		puntoConsigna(n, serie, objetivo, Tr, RH);
+		if (!serie) previa.olvidar();
+		ConsignaPMV c = solver(objetivo, Tr, RH, previa);
+		evaluaciones += c.evaluaciones;
+		if (c.evaluaciones > maxEval) maxEval = c.evaluaciones;
+		if (c.saturada) {
+			saturadas++;
+			continue;
+		}
+		maxErr = fmaxf(maxErr, fabsf(motor(c.Ta, Tr, RH).pmv - objetivo));
+		maxErrNewton = fmaxf(maxErrNewton, fabsf(motorNewton(c.Ta, Tr, RH).pmv - objetivo));
+	}
+
+	out.print(nombre);
+	out.print(F(" us/llamada="));
+	out.print(us, 3);
+#ifdef F_CPU
+	out.print(F(" ciclos/llamada="));
+	out.print((unsigned long)(us * (F_CPU / 1000000UL)));
+#endif
+	out.print(F(" eval/llamada="));
+	out.print((float)evaluaciones / (float)llamadas, 2);
+	out.print(F(" max="));
+	out.print(maxEval);
+	out.print(F(" max|dPMV|="));
+	out.print(maxErr, 4);
+	out.print(F(" vs Newton="));
+	out.print(maxErrNewton, 4);
+	out.print(F(" saturadas="));
+	out.println(saturadas);
+}
+
+void benchmarkConsignaPMV(Print &out, RelojMicros reloj, uint16_t llamadas) {
+	out.println(F("--- Consigna de Ta para un PMV objetivo ---"));
+	medirConsigna(out, F("Newton frio  "), consignaNewton, motorNewton, false, reloj, llamadas);
+	medirConsigna(out, F("Newton serie "), consignaNewton, motorNewton, true, reloj, llamadas);
+	medirConsigna(out, F("tabla frio   "), consignaPMVTabla, computePMVTabla, false, reloj, llamadas);
+	medirConsigna(out, F("tabla serie  "), consignaPMVTabla, computePMVTabla, true, reloj, llamadas);
+}
+
+// Tareas de intervalo largo: ninguna vence durante la medida, como en la
+// mayoria de las pasadas del loop
+#define BENCH_INTERVALO 600000UL
+#define BENCH_NTAREAS (sizeof(benchTareas) / sizeof(benchTareas[0]))
+static const uint8_t benchTareas[] = { 1, 4, 13, PLAN_MAX_TAREAS };
+
+static float usPorPasadaAsync(AsyncTask *tareas, uint8_t n, RelojMicros reloj, uint16_t pasadas) {
+	for (uint8_t i = 0; i < n; i++) tareas[i].Start();
+	unsigned long t0 = reloj();
+	for (uint16_t p = 0; p < pasadas; p++) {
+		for (uint8_t i = 0; i < n; i++) tareas[i].Update();
+	}
+	float us = (float)(reloj() - t0) / (float)pasadas;
+	for (uint8_t i = 0; i < n; i++) tareas[i].Stop();
+	return us;
+}
+
+static float usPorPasadaPlan(Planificador &plan, Tarea *tareas, uint8_t n, RelojMicros reloj, uint16_t pasadas) {
+	for (uint8_t i = 0; i < n; i++) tareas[i].Start();
+	volatile uint8_t corridas = 0;
+	unsigned long t0 = reloj();
+	for (uint16_t p = 0; p < pasadas; p++) corridas += plan.Ejecutar(millis());
+	float us = (float)(reloj() - t0) / (float)pasadas;
+	for (uint8_t i = 0; i < n; i++) tareas[i].Stop();
+	return us;
+}
+
+void benchmarkPlanificador(Print &out, RelojMicros reloj, uint16_t pasadas) {
+	out.println(F("--- Tareas por pasada del loop (sin vencimientos) ---"));
+	
+	// Planificador propio (estatico: empieza vacio) para no tocar las
+	// tareas del sketch
+	static Planificador plan;
+	
+#define BENCH_ASYNC AsyncTask(BENCH_INTERVALO, false, nullptr)
+#define BENCH_TAREA Tarea(BENCH_INTERVALO, false, nullptr, plan)
+	AsyncTask async[PLAN_MAX_TAREAS] = {
+		BENCH_ASYNC, BENCH_ASYNC, BENCH_ASYNC, BENCH_ASYNC, BENCH_ASYNC, BENCH_ASYNC, BENCH_ASYNC, BENCH_ASYNC,
+		BENCH_ASYNC, BENCH_ASYNC, BENCH_ASYNC, BENCH_ASYNC, BENCH_ASYNC, BENCH_ASYNC, BENCH_ASYNC, BENCH_ASYNC
+	};
+	Tarea tareas[PLAN_MAX_TAREAS] = {
+		BENCH_TAREA, BENCH_TAREA, BENCH_TAREA, BENCH_TAREA, BENCH_TAREA, BENCH_TAREA, BENCH_TAREA, BENCH_TAREA,
+		BENCH_TAREA, BENCH_TAREA, BENCH_TAREA, BENCH_TAREA, BENCH_TAREA, BENCH_TAREA, BENCH_TAREA, BENCH_TAREA
+	};
+#undef BENCH_ASYNC
+#undef BENCH_TAREA
+	
+	for (uint8_t i = 0; i < BENCH_NTAREAS; i++) {
+		uint8_t n = benchTareas[i];
+		out.print(F("tareas="));
+		out.print(n);
+		out.print(F(" AsyncTask us/pasada="));
+		out.print(usPorPasadaAsync(async, n, reloj, pasadas), 3);
+		out.print(F(" Planificador us/pasada="));
+		out.println(usPorPasadaPlan(plan, tareas, n, reloj, pasadas), 3);
+	}
+}
+
+// Copia de la maquina del sketch (7 estados, 14 transiciones) con sus
+// propias variables, para medir el despacho sin tocar la del sketch
+enum { BE_INICIO, BE_CONFIG, BE_BLOQUEADO, BE_ALARMA, BE_MONITOR, BE_PMV_ALTO, BE_PMV_BAJO, BE_ESTADOS };
+enum { BI_TIEMPO, BI_BOTON, BI_UNKNOWN, BI_PMV, BI_TEMPERATURA, BI_TECLADO, BI_BLOQUEO, BI_ALARMA, BI_IR, BI_ENTRADAS };
+
+static volatile uint8_t benchEntrada = BI_UNKNOWN;
+static volatile float benchPMV = 0.0f;
+static volatile uint8_t benchIntentos = 0;
+
+static bool benchPMVAlto() { return benchPMV > 1.0f; }
+static bool benchPMVBajo() { return benchPMV < -1.0f; }
+static bool benchIntentosAgotados() { return benchIntentos >= 3; }
+static bool benchAltoNormalizado() { return benchPMV <= 1.0f; }
+static bool benchBajoNormalizado() { return benchPMV >= -1.0f; }
+
+constexpr Transicion benchTransiciones[] PROGMEM = {
+	{ BE_INICIO, BI_TECLADO, BE_CONFIG, nullptr },
+	{ BE_INICIO, BI_BLOQUEO, BE_BLOQUEADO, nullptr },
+	{ BE_BLOQUEADO, BI_BOTON, BE_INICIO, nullptr },
+	{ BE_BLOQUEADO, BI_TECLADO, BE_INICIO, nullptr },
+	{ BE_CONFIG, BI_TIEMPO, BE_MONITOR, nullptr },
+	{ BE_MONITOR, BI_TIEMPO, BE_CONFIG, nullptr },
+	{ BE_MONITOR, BI_PMV, BE_PMV_ALTO, benchPMVAlto },
+	{ BE_MONITOR, BI_PMV, BE_PMV_BAJO, benchPMVBajo },
+	{ BE_PMV_ALTO, BI_ALARMA, BE_ALARMA, benchIntentosAgotados },
+	{ BE_PMV_ALTO, ENTRADA_CUALQUIERA, BE_MONITOR, benchAltoNormalizado },
+	{ BE_PMV_BAJO, BI_TIEMPO, BE_MONITOR, nullptr },
+	{ BE_PMV_BAJO, ENTRADA_CUALQUIERA, BE_MONITOR, benchBajoNormalizado },
+	{ BE_ALARMA, BI_IR, BE_INICIO, nullptr },
+	{ BE_ALARMA, BI_TECLADO, BE_INICIO, nullptr },
+};
+constexpr AccionesEstado benchAcciones[BE_ESTADOS] PROGMEM = {};
+MAQUINA_TABLA(benchDespacho, benchTransiciones, BE_ESTADOS, BI_ENTRADAS, BE_INICIO);
+
+// Las mismas transiciones en StateMachineLib: la entrada va en la condicion
+static void armarStateMachine(StateMachine &sm) {
+	sm.AddTransition(BE_INICIO, BE_CONFIG, []() { return benchEntrada == BI_TECLADO; });
+	sm.AddTransition(BE_INICIO, BE_BLOQUEADO, []() { return benchEntrada == BI_BLOQUEO; });
+	sm.AddTransition(BE_BLOQUEADO, BE_INICIO, []() { return benchEntrada == BI_BOTON; });
+	sm.AddTransition(BE_BLOQUEADO, BE_INICIO, []() { return benchEntrada == BI_TECLADO; });
+	sm.AddTransition(BE_CONFIG, BE_MONITOR, []() { return benchEntrada == BI_TIEMPO; });
+	sm.AddTransition(BE_MONITOR, BE_CONFIG, []() { return benchEntrada == BI_TIEMPO; });
+	sm.AddTransition(BE_MONITOR, BE_PMV_ALTO, []() { return benchEntrada == BI_PMV && benchPMVAlto(); });
+	sm.AddTransition(BE_MONITOR, BE_PMV_BAJO, []() { return benchEntrada == BI_PMV && benchPMVBajo(); });
+	sm.AddTransition(BE_PMV_ALTO, BE_ALARMA, []() { return benchEntrada == BI_ALARMA && benchIntentosAgotados(); });
+	sm.AddTransition(BE_PMV_ALTO, BE_MONITOR, benchAltoNormalizado);
+	sm.AddTransition(BE_PMV_BAJO, BE_MONITOR, []() { return benchEntrada == BI_TIEMPO || benchBajoNormalizado(); });
+	sm.AddTransition(BE_ALARMA, BE_INICIO, []() { return benchEntrada == BI_IR; });
+	sm.AddTransition(BE_ALARMA, BE_INICIO, []() { return benchEntrada == BI_TECLADO; });
+}
+
+void benchmarkMaquinaEstados(Print &out, RelojMicros reloj, uint16_t pasadas) {
+	out.println(F("--- Despacho de la maquina de estados (entrada Unknown) ---"));
+	
+	static StateMachine sm(BE_ESTADOS, 13);
+	static bool armada = false;
+	if (!armada) {
+		armarStateMachine(sm);
+		armada = true;
+	}
+	MaquinaEstados<BE_ESTADOS, BI_ENTRADAS> maquina(benchTransiciones, benchDespacho, benchAcciones);
+	
+	// PMV fuera de rango para el estado medido: las guardas se evaluan pero
+	// ninguna transicion se dispara, como en la mayoria de las pasadas
+	benchEntrada = BI_UNKNOWN;
+	volatile uint8_t disparos = 0;
+	for (uint8_t e = 0; e < BE_ESTADOS; e++) {
+		benchPMV = e == BE_PMV_BAJO ? -2.0f : 2.0f;
+		sm.SetState(e, false, false);
+		unsigned long t0 = reloj();
+		for (uint16_t p = 0; p < pasadas; p++) disparos += sm.Update();
+		float usLib = (float)(reloj() - t0) / (float)pasadas;
+		
+		maquina.iniciar(e, false);
+		t0 = reloj();
+		for (uint16_t p = 0; p < pasadas; p++) disparos += maquina.actualizar(benchEntrada);
+		float usTabla = (float)(reloj() - t0) / (float)pasadas;
+		
+		out.print(F("estado="));
+		out.print(e);
+		out.print(F(" StateMachineLib us/pasada="));
+		out.print(usLib, 4);
+		out.print(F(" MaquinaEstados us/pasada="));
+		out.println(usTabla, 4);
+	}
+}
+
+// Codigos de 10 bits dentro de la tabla del NTC (sin corto ni circuito abierto)
+#define BENCH_NTC_PRIMERO 8
+#define BENCH_NTC_ULTIMO 1015
+
+void benchmarkNTC(Print &out, RelojMicros reloj, uint16_t repeticiones) {
+	out.println(F("--- Temperatura NTC: log() frente a tabla en flash ---"));
+	volatile float sumidero = 0.0f;
+	unsigned long llamadas = (unsigned long)repeticiones * (BENCH_NTC_ULTIMO - BENCH_NTC_PRIMERO + 1);
+	
+	unsigned long t0 = reloj();
+	for (uint16_t r = 0; r < repeticiones; r++) {
+		for (int c = BENCH_NTC_PRIMERO; c <= BENCH_NTC_ULTIMO; c++) sumidero += temperaturaNTC(c);
+	}
+	float usLog = (float)(reloj() - t0) / (float)llamadas;
+	
+	t0 = reloj();
+	for (uint16_t r = 0; r < repeticiones; r++) {
+		for (int c = BENCH_NTC_PRIMERO; c <= BENCH_NTC_ULTIMO; c++) {
+			sumidero += temperaturaNTCTabla((uint16_t)c << NTC_SOBREMUESTREO_BITS);
+		}
+	}
+	float usTabla = (float)(reloj() - t0) / (float)llamadas;
+	
+	// Error de la tabla en los codigos exactos, en el rango de la sala y fuera
+	float maxErrSala = 0.0f, maxErr = 0.0f;
+	for (int c = BENCH_NTC_PRIMERO; c <= BENCH_NTC_ULTIMO; c++) {
+		float ref = temperaturaNTC(c);
+		float err = fabsf(temperaturaNTCTabla((uint16_t)c, 0) - ref);
+		if (err > maxErr) maxErr = err;
+		if (ref >= 0.0f && ref <= 50.0f && err > maxErrSala) maxErrSala = err;
+	}
+	
+	out.print(F("log()  us/llamada="));
+	out.println(usLog, 3);
+	out.print(F("tabla  us/llamada="));
+	out.print(usTabla, 3);
+	out.print(F(" max|err| 0..50 C="));
+	out.print(maxErrSala, 4);
+	out.print(F(" max|err| total="));
+	out.println(maxErr, 4);
+}
+
+void benchmarkRuidoNTC(Print &out, uint8_t pin, uint16_t lecturas) {
+	out.println(F("--- Ruido de Tr segun el sobremuestreo (sala estable) ---"));
+	for (uint8_t bits = 0; bits <= 3; bits++) {
+		// Sumas respecto de la primera lectura para no perder precision en float
+		float base = NAN, suma = 0.0f, suma2 = 0.0f, minimo = 1000.0f, maximo = -1000.0f;
+		uint16_t validas = 0;
+		for (uint16_t i = 0; i < lecturas; i++) {
+			float t = temperaturaNTCTabla(leerADCSobremuestreado(pin, bits), bits);
+			if (isnan(t)) continue;
+			if (isnan(base)) base = t;
+			suma += t - base;
+			suma2 += (t - base) * (t - base);
+			if (t < minimo) minimo = t;
+			if (t > maximo) maximo = t;
+			validas++;
+		}
+		if (validas == 0) {
+			out.println(F("sin lecturas validas"));
+			return;
+		}
+		float media = suma / validas;
+		float varianza = suma2 / validas - media * media;
+		out.print(F("bits="));
+		out.print(10 + bits);
+		out.print(F(" conversiones="));
+		out.print(1u << (2 * bits));
+		out.print(F(" media="));
+		out.print(base + media, 3);
+		out.print(F(" desvio="));
+		out.print(varianza > 0.0f ? sqrtf(varianza) : 0.0f, 4);
+		out.print(F(" pico a pico="));
+		out.println(maximo - minimo, 3);
+	}
+}
@@ -0,0 +1,64 @@
+#ifndef SMARTCOMFORT_PMVBENCH_H
+#define SMARTCOMFORT_PMVBENCH_H
+
+#include <Arduino.h>
+#include "PMV.h"
+
+// Reloj en microsegundos: micros() en la placa, reloj real en el host.
+typedef unsigned long (*RelojMicros)();
+
+// Motor PMV con perfil variable, como computePMV
+typedef PMVResult (*MotorPMV)(float Ta, float Tr, float RH, float met, float clo, float va);
+
+// Compara los solvers de T_cl de computePMV sobre una rejilla de condiciones
+// interiores: iteraciones medias, microsegundos por llamada y error maximo.
+// En la placa se ejecuta desde setup() compilando con SMARTCOMFORT_BENCH.
+void benchmarkSolverPMV(Print &out, RelojMicros reloj, uint16_t repeticiones);
+
+// computeConfortISO (ConfortISO.h) en las 13 filas de la tabla D.1 de ISO
+// 7730: PMV y PPD calculados y de referencia. true si todas coinciden con
+// los decimales de la tabla (+-0.01 de PMV, +-1 % de PPD).
+bool benchmarkReferenciaISO(Print &out);
+
+// Error maximo de un motor con perfil variable en las filas coherentes del
+// anexo D; NAN si alguna no da resultado
+float errorAnexoD(MotorPMV motor);
+
+// Tiempo por evaluacion (y ciclos de CPU en la placa) de cada motor PMV con
+// el perfil fijo, con su error maximo y rms frente a computeConfortISO en la
+// misma rejilla y, los de perfil variable, en las filas del anexo D.
+void benchmarkMotoresPMV(Print &out, RelojMicros reloj, uint16_t repeticiones);
+
+// PMV sobre una serie de lecturas como las de los sensores (DHT11 de 1 C y
+// 1 %, NTC en pasos de 0.02 C, una muestra por segundo): evaluarPMV() en
+// cada muestra frente a PMVIncremental con varias tolerancias. Informa
+// microsegundos por muestra, que parte se resolvio sin calcular todo y el
+// error maximo frente a evaluarPMV().
+void benchmarkPMVIncremental(Print &out, RelojMicros reloj, uint16_t muestras);
+
+// Consigna de Ta para un PMV objetivo (PMVConsigna.h), con Newton y con la
+// tabla: en frio sobre una rejilla de Tr, RH y objetivo, y en serie sobre
+// lecturas como las de los sensores arrancando en la consigna anterior.
+// Informa microsegundos (y ciclos en la placa) por llamada, evaluaciones
+// del PMV por llamada y el error del PMV en la consigna.
+void benchmarkConsignaPMV(Print &out, RelojMicros reloj, uint16_t llamadas);
+
+// Costo por pasada del loop de revisar N temporizadores sin vencimientos:
+// N llamadas a AsyncTask::Update() frente a un Planificador::Ejecutar() con
+// N tareas activas.
+void benchmarkPlanificador(Print &out, RelojMicros reloj, uint16_t pasadas);
+
+// Costo por pasada del loop de actualizar la maquina de estados sin
+// transiciones, por estado: StateMachine::Update() (recorre las 13
+// transiciones) frente a MaquinaEstados::actualizar() (una celda de la tabla).
+void benchmarkMaquinaEstados(Print &out, RelojMicros reloj, uint16_t pasadas);
+
+// Tiempo por conversion ADC -> temperatura del NTC: temperaturaNTC() (log y
+// divisiones en float) frente a temperaturaNTCTabla(), y error de la tabla.
+void benchmarkNTC(Print &out, RelojMicros reloj, uint16_t repeticiones);
+
+// Media, desvio y pico a pico de Tr en 'lecturas' lecturas del NTC en 'pin'
+// con 0 a 3 bits de sobremuestreo. Con la sala estable el desvio es el ruido.
+void benchmarkRuidoNTC(Print &out, uint8_t pin, uint16_t lecturas);
+
+#endif
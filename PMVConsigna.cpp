@@ -0,0 +1,76 @@
+#include "PMVConsigna.h"
+
+#include <Arduino.h>
+
+bool sanearConsigna(float objetivo, float &Tr, float &RH) {
+	if (isnan(objetivo) || isnan(Tr) || isnan(RH)) return false;
+	if (Tr < -10.0f) Tr = -10.0f;
+	if (Tr > 50.0f) Tr = 50.0f;
+	if (RH < 0.0f) RH = 0.0f;
+	if (RH > 100.0f) RH = 100.0f;
+	return true;
+}
+
+ConsignaPMV consignaPMV(const TerminosPMV &t, float objetivo, float Tr, float RH, ArranqueConsigna &previa) {
+	if (!sanearConsigna(objetivo, Tr, RH)) return { NAN, 0, false };
+	float trK4 = radiantePMV(Tr);
+
+	float lo = PMV_CONSIGNA_TA_MIN;
+	float hi = PMV_CONSIGNA_TA_MAX;
+	float x = previa.Ta;
+	if (isnan(x) || x < lo || x > hi) x = 0.5f * (lo + hi);
+	float pendiente = previa.pendiente > 0.0f ? previa.pendiente : PMV_CONSIGNA_PENDIENTE;
+
+	float xAnt = NAN, gAnt = 0.0f;
+	bool saturada = false;
+	uint8_t n = 0;
+	while (n < PMV_CONSIGNA_MAX_ITER) {
+		n++;
+		float p_a = RH * 10.0f * saturation_vapor_pressure_kPa(x);
+		resolverTclPMV(t, x, Tr, trK4, previa.tcl);
+		float g = balancePMV(t, x, p_a, trK4, previa.tcl) - objetivo;
+		if (fabsf(g) < PMV_CONSIGNA_TOLERANCIA) break;
+		if (g > 0.0f) hi = x; else lo = x;
+		if (lo >= PMV_CONSIGNA_TA_MAX || hi <= PMV_CONSIGNA_TA_MIN) {
+			saturada = true;
+			break;
+		}
+
+		// Con el PMV recortado a +-3 la secante puede ser plana: se conserva
+		// la pendiente anterior
+		if (!isnan(xAnt) && x != xAnt) {
+			float s = (g - gAnt) / (x - xAnt);
+			if (s > 1e-3f) pendiente = s;
+		}
+		// Si el paso sale del intervalo: el borde del rango si todavia no se
+		// evaluo (puede que el objetivo no se alcance), si no biseccion
+		float xNuevo = x - g / pendiente;
+		if (xNuevo >= hi) xNuevo = hi < PMV_CONSIGNA_TA_MAX ? 0.5f * (lo + hi) : PMV_CONSIGNA_TA_MAX;
+		else if (xNuevo <= lo) xNuevo = lo > PMV_CONSIGNA_TA_MIN ? 0.5f * (lo + hi) : PMV_CONSIGNA_TA_MIN;
+		xAnt = x;
+		gAnt = g;
+		x = xNuevo;
+		if (hi - lo < 1e-3f) break;
+	}
+
+	previa.Ta = x;
+	previa.pendiente = pendiente;
+	return { x, n, saturada };
+}
+
+ConsignaPMV evaluarConsigna(float objetivo, float Tr, float RH, ArranqueConsigna &previa) {
+#if PMV_MOTOR == PMV_MOTOR_TABLA
+	return consignaPMVTabla(objetivo, Tr, RH, previa);
+#else
+	static constexpr TerminosPMV terminos = terminosPMVConst(PMV_MET, PMV_CLO, PMV_VA);
+	return consignaPMV(terminos, objetivo, Tr, RH, previa);
+#endif
+}
+
+float objetivoPreferido(float Tpref) {
+	if (isnan(Tpref) || Tpref < PMV_CONSIGNA_TA_MIN || Tpref > PMV_CONSIGNA_TA_MAX) return NAN;
+	float pmv = evaluarPMV(Tpref, Tpref, PMV_CONSIGNA_RH_REF).pmv;
+	if (pmv > PMV_CONSIGNA_OBJETIVO_MAX) pmv = PMV_CONSIGNA_OBJETIVO_MAX;
+	if (pmv < -PMV_CONSIGNA_OBJETIVO_MAX) pmv = -PMV_CONSIGNA_OBJETIVO_MAX;
+	return pmv;
+}
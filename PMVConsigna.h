@@ -0,0 +1,69 @@
+#ifndef SMARTCOMFORT_PMVCONSIGNA_H
+#define SMARTCOMFORT_PMVCONSIGNA_H
+
+#include <math.h>
+#include <stdint.h>
+#include "PMVPerfil.h"
+
+// Problema inverso del PMV: la temperatura del aire que, con Tr, RH y el
+// perfil dados, da un PMV objetivo. Con eso el enfriamiento y la calefaccion
+// apuntan a una consigna de Ta en lugar de cortar en el borde de la banda
+// de +-1.
+//
+// El PMV crece con Ta, asi que la raiz es unica. consignaPMV() la busca con
+// Newton acotado: la pendiente sale de la secante entre las dos ultimas
+// evaluaciones (la primera vez, de la llamada anterior) y si el paso sale
+// del intervalo conocido se biseca. Arranca en la consigna anterior: con Tr
+// y RH que se movieron poco basta una o dos evaluaciones del PMV. El costo
+// por llamada tiene tope: PMV_CONSIGNA_MAX_ITER evaluaciones, cada una un
+// expf y Newton de T_cl arrancando en la T_cl anterior.
+//
+// consignaPMVTabla() (PMVTabla.cpp) invierte la rejilla de PMVTablaDatos.h:
+// a lo largo de Ta la interpolacion es lineal por tramos, asi que busca el
+// tramo que cruza el objetivo (empezando por el de la consigna anterior) y
+// despeja Ta de la recta. Es exacta respecto de computePMVTabla.
+#define PMV_CONSIGNA_TA_MIN 10.0f   // C; la consigna se recorta a este rango
+#define PMV_CONSIGNA_TA_MAX 34.0f   // sobre la rejilla de la tabla
+#define PMV_CONSIGNA_MAX_ITER 8
+#define PMV_CONSIGNA_TOLERANCIA 0.005f  // |PMV - objetivo|, ~0.02 C
+#define PMV_CONSIGNA_PENDIENTE 0.3f     // dPMV/dTa del primer paso en frio
+
+// El objetivo de un usuario es el PMV que siente a su temperatura preferida
+// con Tr = Ta y RH de referencia, recortado a +-PMV_CONSIGNA_OBJETIVO_MAX
+// para que la consigna quede dentro de la banda de confort.
+#define PMV_CONSIGNA_RH_REF 50.0f
+#define PMV_CONSIGNA_OBJETIVO_MAX 0.7f
+
+struct ConsignaPMV {
+	float Ta;             // NAN si alguna entrada es NaN
+	uint8_t evaluaciones; // del PMV (o de columnas de la tabla)
+	bool saturada;        // el objetivo no se alcanza en el rango de Ta
+};
+
+// Arranque en caliente de una consigna: lo que dejo la llamada anterior
+struct ArranqueConsigna {
+	float Ta = NAN;
+	float pendiente = 0.0f;  // dPMV/dTa en Ta
+	float tcl = NAN;
+	void olvidar() { Ta = NAN; pendiente = 0.0f; tcl = NAN; }
+};
+
+// Tr y RH fuera de rango como en sanearPMV (Tr sin Ta de referencia: al
+// borde del rango); false si alguna entrada es NaN
+bool sanearConsigna(float objetivo, float &Tr, float &RH);
+
+// Ta con PMV(Ta, Tr, RH) = objetivo para el perfil de t
+ConsignaPMV consignaPMV(const TerminosPMV &t, float objetivo, float Tr, float RH, ArranqueConsigna &previa);
+
+// Lo mismo sobre la tabla del perfil fijo
+ConsignaPMV consignaPMVTabla(float objetivo, float Tr, float RH, ArranqueConsigna &previa);
+
+// Con el motor elegido en PMV_MOTOR (la tabla con PMV_MOTOR_TABLA; Newton
+// con el perfil del sketch en los otros)
+ConsignaPMV evaluarConsigna(float objetivo, float Tr, float RH, ArranqueConsigna &previa);
+
+// PMV objetivo de un usuario que prefiere Tpref; NAN si Tpref no es una
+// temperatura de consigna valida
+float objetivoPreferido(float Tpref);
+
+#endif
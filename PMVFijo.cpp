@@ -0,0 +1,152 @@
+#include <Arduino.h>
+#include "PMV.h"
+#include "PMVTablaDatos.h"
+
+// Motor PMV en punto fijo (sin FPU ni soft-float en el calculo).
+// Formatos: Qn = valor x 2^n en enteros con signo.
+//   temperaturas Q8 (C), potencias Q8 (W/m2), coeficientes h Q8 (W/m2K),
+//   f_cl Q12, I_cl Q16, ganancias I_cl*f_cl*h Q12, PMV Q10.
+// Todos los productos caben en 32 bits para el rango saneado de entrada.
+
+#define KELVIN_Q8 69926L  // 273.15 * 256
+
+// 2^(-k/16) en Q15, k = 0..16
+static const uint16_t exp2NegTabla[17] PROGMEM = {
+	32768, 31379, 30048, 28774, 27554, 26386, 25268, 24196, 23170,
+	22188, 21247, 20347, 19484, 18658, 17867, 17109, 16384
+};
+
+// Raiz cuadrada entera (bit a bit, sin divisiones)
+static uint16_t isqrt32(uint32_t x) {
+	uint32_t res = 0;
+	uint32_t bit = 1UL << 30;
+	while (bit > x) bit >>= 2;
+	while (bit != 0) {
+		if (x >= res + bit) {
+			x -= res + bit;
+			res = (res >> 1) + bit;
+		} else {
+			res >>= 1;
+		}
+		bit >>= 2;
+	}
+	return (uint16_t)res;
+}
+
+// exp(-x) con x en Q12 (x >= 0); resultado Q15
+static int32_t expNegQ15(int32_t x_q12) {
+	int32_t y = (x_q12 * 5909L) >> 12;  // x * log2(e)
+	uint8_t n = (uint8_t)(y >> 12);
+	if (n > 15) return 0;
+	uint16_t f = (uint16_t)(y & 4095);
+	uint8_t idx = f >> 8;
+	int32_t a = pgm_read_word(&exp2NegTabla[idx]);
+	int32_t b = pgm_read_word(&exp2NegTabla[idx + 1]);
+	int32_t v = a - (((a - b) * (int32_t)(f & 255)) >> 8);
+	return v >> n;
+}
+
+// Presion de vapor saturado en Pa para Ta en Q8 (-10..50 C), interpolando la
+// tabla de 1 C generada junto a pmvTabla
+static int32_t presionSaturacionPa(int16_t ta_q8) {
+	int32_t pos = (int32_t)ta_q8 - (int32_t)(PSAT_TABLA_T_MIN * 256);
+	if (pos < 0) pos = 0;
+	uint8_t idx = (uint8_t)(pos >> 8);
+	int32_t frac = pos & 255;
+	if (idx >= PSAT_TABLA_N - 1) {
+		idx = PSAT_TABLA_N - 2;
+		frac = 256;
+	}
+	int32_t a = pgm_read_word(&psatTabla[idx]);
+	int32_t b = pgm_read_word(&psatTabla[idx + 1]);
+	return a + (((b - a) * frac) >> 8);
+}
+
+// Coeficiente radiativo 3.96e-8 (a+b)(a^2+b^2) en Q8, con a, b en K (Q8):
+// rad = f_cl * h_r * (T_cl - Tr) es exactamente 3.96e-8 f_cl (a^4 - b^4)
+static int32_t coefRadiativoQ8(int32_t tcl_q8, int32_t tr_q8) {
+	int32_t a = (tcl_q8 + KELVIN_Q8) >> 4;  // K en Q4
+	int32_t b = (tr_q8 + KELVIN_Q8) >> 4;
+	int32_t cuad = (a * a + b * b) >> 10;   // K^2 / 4
+	int32_t p = (a + b) * cuad;             // 4 (a+b)(a^2+b^2)
+	return ((p >> 16) * 10885L) >> 16;      // 3.96e-8 / 4 * 256 * 2^16
+}
+
+// Coeficiente convectivo max(forzada, 2.38 |d|^0.25) en Q8
+static int32_t coefConvectivoQ8(int32_t d_q8, int32_t hcf_q8) {
+	uint32_t ad = (uint32_t)(d_q8 < 0 ? -d_q8 : d_q8);
+	uint32_t raiz4 = isqrt32((uint32_t)isqrt32(ad << 8) << 8);  // |d|^0.25 Q8
+	int32_t hn = ((int32_t)raiz4 * 609L) >> 8;                   // 2.38 * 256
+	return hn > hcf_q8 ? hn : hcf_q8;
+}
+
+int16_t computePMVQ(int16_t ta_q8, int16_t tr_q8, uint16_t rh_q8, uint16_t met_q8, uint16_t clo_q8, uint16_t va_q8) {
+	if (ta_q8 < -10 * 256 || ta_q8 > 50 * 256) ta_q8 = 25 * 256;
+	if (tr_q8 < -10 * 256 || tr_q8 > 50 * 256) tr_q8 = ta_q8;
+	if (rh_q8 > 100 * 256) rh_q8 = 100 * 256;
+
+	int32_t ta = ta_q8, tr = tr_q8;
+
+	int32_t M = ((int32_t)met_q8 * 59546L) >> 10;                   // 58.15 W/m2 por met, Q8
+	int32_t pa = (presionSaturacionPa(ta_q8) * (int32_t)rh_q8) / 25600L;  // Pa
+
+	int32_t fcl = (clo_q8 <= 20) ? 4301L + (((int32_t)clo_q8 * 410L) >> 8)   // 1.05 + 0.1 clo
+	                             : 4096L + (((int32_t)clo_q8 * 819L) >> 8);  // 1.0 + 0.2 clo
+	int32_t icl = ((int32_t)clo_q8 * 10158L) >> 8;                  // 0.155 clo, Q16
+	int32_t ganancia = (icl * fcl) >> 12;                            // I_cl f_cl, Q16
+	int32_t hcf = ((int32_t)isqrt32((uint32_t)va_q8 << 8) * 3098L) >> 8;  // 12.1 sqrt(va)
+	int32_t tsk = 9139L - ((M * 7340L) >> 18);                      // 35.7 - 0.028 M, Q8
+
+	// T_cl como media ponderada de T_sk, Tr y Ta con h_r/h_c evaluados en la
+	// estimacion anterior: siempre queda entre los tres y converge en pocas
+	// pasadas sin divergir
+	int32_t tcl = ta + 26;  // Ta + 0.1
+	int32_t hr = 0, hc = 0;
+	for (uint8_t i = 0; i < 8; i++) {
+		hr = coefRadiativoQ8(tcl, tr);
+		hc = coefConvectivoQ8(tcl - ta, hcf);
+		int32_t gr = (ganancia * hr) >> 12;  // Q12
+		int32_t gc = (ganancia * hc) >> 12;
+		int32_t num = (tsk << 12) + gr * tr + gc * ta;
+		int32_t nuevo = num / (4096L + gr + gc);
+		int32_t paso = nuevo - tcl;
+		tcl = nuevo;
+		if (paso >= -1 && paso <= 1) break;
+	}
+	hr = coefRadiativoQ8(tcl, tr);
+	hc = coefConvectivoQ8(tcl - ta, hcf);
+
+	// Perdidas en W/m2 (Q8). Los terminos respiratorios se factorizan como
+	// coeficiente(M) x diferencia para no exceder 32 bits
+	int32_t difusion = ((1467648L - ((M * 7158L) >> 10) - (pa << 8)) * 200L) >> 16;  // 3.05e-3 (5733 - 6.99 M - pa)
+	int32_t sudor = ((M - 14886L) * 430L) >> 10;                                      // 0.42 (M - 58.15)
+	int32_t kLatente = (M * 1141L) >> 10;                                             // 1.7e-5 M, Q24
+	int32_t respLatente = (kLatente * (5867L - pa)) >> 16;                            // 1.7e-5 M (5867 - pa)
+	int32_t kSensible = (M * 367L) >> 10;                                             // 0.0014 M, Q16
+	int32_t respSensible = (kSensible * (8704L - ta)) >> 16;                          // 0.0014 M (34 - Ta)
+	int32_t rad = (((fcl * hr) >> 12) * (tcl - tr)) >> 8;
+	int32_t conv = (((fcl * hc) >> 12) * (tcl - ta)) >> 8;
+	int32_t balance = M - difusion - sudor - respLatente - respSensible - rad - conv;
+
+	// 0.303 exp(-0.036 M) + 0.028, en Q15
+	int32_t factor = ((9929L * expNegQ15((M * 590L) >> 10)) >> 15) + 918L;
+
+	int32_t pmv = (factor * balance) >> 13;  // Q15 * Q8 -> Q10
+	if (pmv > 3072) pmv = 3072;
+	if (pmv < -3072) pmv = -3072;
+	return (int16_t)pmv;
+}
+
+PMVResult computePMVFijo(float Ta, float Tr, float RH) {
+	if (isnan(Ta) || isnan(Tr) || isnan(RH)) {
+		return { 0.0f, NAN, 0 };
+	}
+	// Conversion de entrada: las lecturas del DHT ya llegan como float
+	if (Ta < -10.0f || Ta > 50.0f) Ta = 25.0f;
+	if (Tr < -10.0f || Tr > 50.0f) Tr = Ta;
+	if (RH < 0.0f) RH = 0.0f;
+	if (RH > 100.0f) RH = 100.0f;
+	int16_t q = computePMVQ((int16_t)(Ta * 256.0f), (int16_t)(Tr * 256.0f), (uint16_t)(RH * 256.0f),
+	                        PMV_MET_Q8, PMV_CLO_Q8, PMV_VA_Q8);
+	return { q * (1.0f / 1024.0f), NAN, 0 };
+}
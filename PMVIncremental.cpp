@@ -0,0 +1,94 @@
+#include "PMVIncremental.h"
+#include "PMVPerfil.h"
+
+#include <Arduino.h>
+#include <string.h>
+
+static bool igual(float a, float b, float eps) {
+	return fabsf(a - b) <= eps;
+}
+
+unsigned long EstadisticaPMVIncremental::usAhorrados() const {
+	if (completas == 0) return 0;
+	unsigned long media = usCompletas / completas;
+	unsigned long sinMemo = media * (evaluaciones() - completas);
+	unsigned long conMemo = usAciertos + usParciales;
+	return sinMemo > conMemo ? sinMemo - conMemo : 0;
+}
+
+PMVIncremental::PMVIncremental(float epsT, float epsRH) : _epsT(epsT), _epsRH(epsRH), _valido(false), _Ta(0.0f), _Tr(0.0f), _RH(0.0f), _pSat(0.0f), _trK4(0.0f),
+	_tcl(NAN), _ultimo{ 0.0f, NAN, 0 } {
+	memset(&_est, 0, sizeof(_est));
+}
+
+void PMVIncremental::reiniciarEstadistica() {
+	memset(&_est, 0, sizeof(_est));
+}
+
+#if PMV_MOTOR == PMV_MOTOR_NEWTON
+
+PMVResult PMVIncremental::evaluar(float Ta, float Tr, float RH) {
+	static constexpr TerminosPMV terminos = terminosPMVConst(PMV_MET, PMV_CLO, PMV_VA);
+	if (!sanearPMV(Ta, Tr, RH)) return { 0.0f, NAN, 0 };
+
+	unsigned long desde = micros();
+	bool mismaTa = _valido && igual(Ta, _Ta, _epsT);
+	bool mismaTr = _valido && igual(Tr, _Tr, _epsT);
+	bool mismaRH = _valido && igual(RH, _RH, _epsRH);
+
+	if (mismaTa && mismaTr && mismaRH) {
+		_est.aciertos++;
+		_est.usAciertos += micros() - desde;
+		return _ultimo;
+	}
+
+	// Las entradas dentro de la tolerancia quedan como estaban: asi no se
+	// acumula deriva con cambios chicos repetidos
+	uint8_t it = 0;
+	if (!mismaTa) {
+		_Ta = Ta;
+		_pSat = saturation_vapor_pressure_kPa(Ta);
+	}
+	if (!mismaTr) {
+		_Tr = Tr;
+		_trK4 = radiantePMV(Tr);
+	}
+	if (!mismaRH) _RH = RH;
+	if (!mismaTa || !mismaTr) it = resolverTclPMV(terminos, _Ta, _Tr, _trK4, _tcl);
+	_ultimo = { balancePMV(terminos, _Ta, _RH * 10.0f * _pSat, _trK4, _tcl), _tcl, it };
+
+	unsigned long us = micros() - desde;
+	if (!_valido || !mismaTa) {
+		_est.completas++;
+		_est.usCompletas += us;
+	} else {
+		if (mismaTr) _est.soloRH++;
+		else _est.soloTr++;
+		_est.usParciales += us;
+	}
+	_valido = true;
+	return _ultimo;
+}
+
+#else
+
+PMVResult PMVIncremental::evaluar(float Ta, float Tr, float RH) {
+	if (isnan(Ta) || isnan(Tr) || isnan(RH)) return evaluarPMV(Ta, Tr, RH);
+
+	unsigned long desde = micros();
+	if (_valido && igual(Ta, _Ta, _epsT) && igual(Tr, _Tr, _epsT) && igual(RH, _RH, _epsRH)) {
+		_est.aciertos++;
+		_est.usAciertos += micros() - desde;
+		return _ultimo;
+	}
+	_ultimo = evaluarPMV(Ta, Tr, RH);
+	_est.completas++;
+	_est.usCompletas += micros() - desde;
+	_valido = true;
+	_Ta = Ta;
+	_Tr = Tr;
+	_RH = RH;
+	return _ultimo;
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef SMARTCOMFORT_PMVINCREMENTAL_H
+#define SMARTCOMFORT_PMVINCREMENTAL_H
+
+#include <stdint.h>
+#include "PMV.h"
+
+// Tolerancias por defecto de PMVIncremental: una entrada que se movio a lo
+// sumo esto desde el ultimo calculo cuenta como sin cambio. Con 0 solo se
+// reusan entradas identicas y el PMV no se aparta de evaluarPMV() mas que
+// la tolerancia de Newton. Un cambio de 0.1 C en Ta o Tr mueve el PMV
+// ~0.02; 1 % de RH, ~0.005.
+#ifndef PMV_INC_EPS_T
+#define PMV_INC_EPS_T 0.0f   // C
+#endif
+#ifndef PMV_INC_EPS_RH
+#define PMV_INC_EPS_RH 0.0f  // %
+#endif
+
+// Contadores de PMVIncremental. Los tiempos son micros() acumulados por
+// camino (en la placa; en la simulacion el reloj virtual no avanza).
+struct EstadisticaPMVIncremental {
+	unsigned long aciertos;    // entradas sin cambio: el resultado guardado
+	unsigned long soloRH;      // sin expf ni Newton: solo el balance
+	unsigned long soloTr;      // Newton y balance, sin expf
+	unsigned long completas;
+	unsigned long usAciertos;
+	unsigned long usParciales;  // soloRH + soloTr
+	unsigned long usCompletas;
+
+	unsigned long evaluaciones() const { return aciertos + soloRH + soloTr + completas; }
+
+	// Tiempo ahorrado frente a calcular todo siempre, estimado con la media
+	// de las evaluaciones completas
+	unsigned long usAhorrados() const;
+};
+
+// PMV de una sala que recuerda las ultimas entradas, la presion de vapor
+// saturada de Ta, el termino radiante de Tr y la T_cl resuelta. Si ninguna
+// entrada cambio devuelve el resultado anterior; si solo cambio RH, T_cl no
+// cambia y solo se rehace el balance; si solo cambio Tr, se reusa la presion
+// de vapor (el expf) y Newton arranca desde la T_cl anterior.
+//
+// Con el motor PMV_MOTOR_NEWTON usa el nucleo de PMVPerfil.h con el perfil
+// del sketch; con los otros motores solo reusa resultados de entradas sin
+// cambio y, si no, llama a evaluarPMV().
+class PMVIncremental {
+public:
+	explicit PMVIncremental(float epsT = PMV_INC_EPS_T, float epsRH = PMV_INC_EPS_RH);
+
+	PMVResult evaluar(float Ta, float Tr, float RH);
+
+	// El proximo evaluar() calcula todo
+	void invalidar() { _valido = false; }
+
+	const EstadisticaPMVIncremental &estadistica() const { return _est; }
+	void reiniciarEstadistica();
+
+private:
+	float _epsT, _epsRH;
+	bool _valido;
+	float _Ta, _Tr, _RH;  // entradas saneadas del ultimo calculo
+	float _pSat;          // kPa, de _Ta
+	float _trK4;          // (_Tr + 273.15)^4
+	float _tcl;           // de (_Ta, _Tr); arranque de Newton
+	PMVResult _ultimo;
+	EstadisticaPMVIncremental _est;
+};
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef SMARTCOMFORT_PMVPERFIL_H
+#define SMARTCOMFORT_PMVPERFIL_H
+
+#include <math.h>
+#include "PMV.h"
+
+// Terminos del balance de Fanger que solo dependen del perfil de actividad,
+// ropa y velocidad del aire (met, clo, va). Con un perfil constante se
+// calculan en compilacion; con perfiles variables, una vez por perfil.
+struct TerminosPMV {
+	float M;          // metabolismo [W/m2]
+	float T_sk;       // temperatura de la piel
+	float f_cl;
+	float h_cf;       // conveccion forzada 12.1 sqrt(va)
+	float g_rad;      // I_cl * 3.96e-8 * f_cl
+	float g_conv;     // I_cl * f_cl
+	float radCoef;    // 3.96e-8 * f_cl
+	float factor;     // 0.303 exp(-0.036 M) + 0.028
+	float balance0;   // parte del balance que solo depende de M
+	float k_pa;       // coeficiente de p_a en el balance
+	float k_ta;       // coeficiente de Ta en el balance
+};
+
+// exp y sqrt evaluables en compilacion (C++11: una sola expresion por
+// funcion). Solo se usan para plegar constantes, nunca en tiempo de ejecucion.
+constexpr double pmvExpSerie(double x, int n, double termino, double suma) {
+	return n > 24 ? suma : pmvExpSerie(x, n + 1, termino * x / n, suma + termino * x / n);
+}
+constexpr double pmvCuadrado(double x) { return x * x; }
+constexpr double pmvExpConst(double x) {
+	// exp(x) = exp(x/16)^16: la serie converge rapido cerca de 0
+	return pmvCuadrado(pmvCuadrado(pmvCuadrado(pmvCuadrado(pmvExpSerie(x / 16.0, 1, 1.0, 1.0)))));
+}
+constexpr double pmvRaizNewton(double x, double g, int n) {
+	return n == 0 ? g : pmvRaizNewton(x, 0.5 * (g + x / g), n - 1);
+}
+constexpr double pmvRaizConst(double x) { return pmvRaizNewton(x, x > 1.0 ? x : 1.0, 40); }
+
+constexpr float pmvFcl(float clo) { return (clo <= 0.078f) ? (1.05f + 0.1f * clo) : (1.0f + 0.2f * clo); }
+constexpr float pmvVaSaneada(float va) { return va < 0.0f ? 0.1f : (va > 0.0001f ? va : 0.0001f); }
+
+// Arma los terminos a partir de M, clo, sqrt(va) y exp(-0.036 M) ya evaluados,
+// para compartir las formulas entre la version constexpr y la de ejecucion.
+constexpr TerminosPMV terminosPMVDesde(float M, float clo, float raizVa, float expM) {
+	return TerminosPMV{
+		M,
+		35.7f - 0.028f * M,
+		pmvFcl(clo),
+		12.1f * raizVa,
+		clo * 0.155f * 3.96e-8f * pmvFcl(clo),
+		clo * 0.155f * pmvFcl(clo),
+		3.96e-8f * pmvFcl(clo),
+		0.303f * expM + 0.028f,
+		M - 3.05e-3f * (5733.0f - 6.99f * M) - 0.42f * (M - 58.15f) - 1.7e-5f * M * 5867.0f - 0.0014f * M * 34.0f,
+		3.05e-3f + 1.7e-5f * M,
+		0.0014f * M
+	};
+}
+
+// Terminos de un perfil constante, plegados por el compilador
+constexpr TerminosPMV terminosPMVConst(float met, float clo, float va) {
+	return terminosPMVDesde(met * 58.15f, clo, (float)pmvRaizConst(pmvVaSaneada(va)),
+	                        (float)pmvExpConst(-0.036 * met * 58.15));
+}
+
+// Terminos de un perfil en tiempo de ejecucion. Guarda los ultimos perfiles
+// usados, de modo que computePMV solo los recalcula al cambiar de perfil.
+const TerminosPMV &terminosPMV(float met, float clo, float va);
+
+// Saneado de entradas de computePMV; false si alguna es NaN
+inline bool sanearPMV(float &Ta, float &Tr, float &RH) {
+	if (isnan(Ta) || isnan(Tr) || isnan(RH)) return false;
+	if (Ta < -10.0f || Ta > 50.0f) Ta = 25.0f;
+	if (Tr < -10.0f || Tr > 50.0f) Tr = Ta;
+	if (RH < 0.0f) RH = 0.0f;
+	if (RH > 100.0f) RH = 100.0f;
+	return true;
+}
+
+// (Tr + 273.15)^4, el termino radiante que solo depende de Tr
+inline float radiantePMV(float Tr) {
+	float trK = Tr + 273.15f;
+	float trK2 = trK * trK;
+	return trK2 * trK2;
+}
+
+// T_cl por Newton salvaguardado, arrancando en tclPrevia. Solo depende de Ta
+// y Tr (no de RH). Devuelve las iteraciones usadas.
+inline uint8_t resolverTclPMV(const TerminosPMV &t, float Ta, float Tr, float trK4, float &tclPrevia) {
+	// f(T) = T - T_sk + I_cl * (rad(T) + conv(T)) es creciente (f' >= 1) y
+	// rad/conv se anulan en Tr/Ta, por lo que la raiz esta en [lo, hi].
+	float lo = fminf(fminf(Ta, Tr), t.T_sk);
+	float hi = fmaxf(fmaxf(Ta, Tr), t.T_sk);
+
+	float T_cl = tclPrevia;
+	if (isnan(T_cl) || T_cl <= lo || T_cl >= hi) T_cl = Ta + 0.1f;
+	if (T_cl <= lo || T_cl >= hi) T_cl = 0.5f * (lo + hi);
+
+	uint8_t it = 0;
+	while (it < PMV_NEWTON_MAX_ITER) {
+		it++;
+		float d = T_cl - Ta;
+		float raiz4 = sqrtf(sqrtf(fabsf(d)));
+		float conv, dconv;
+		if (2.38f * raiz4 > t.h_cf) {
+			conv = t.g_conv * 2.38f * raiz4 * d;
+			dconv = t.g_conv * 2.975f * raiz4;  // d/dT de 2.38 |d|^1.25
+		} else {
+			conv = t.g_conv * t.h_cf * d;
+			dconv = t.g_conv * t.h_cf;
+		}
+		float tclK = T_cl + 273.15f;
+		float tclK2 = tclK * tclK;
+		float rad = t.g_rad * (tclK2 * tclK2 - trK4);
+		float drad = 4.0f * t.g_rad * tclK2 * tclK;
+
+		float f = T_cl - t.T_sk + rad + conv;
+		if (f > 0.0f) hi = T_cl; else lo = T_cl;
+
+		float T_new = T_cl - f / (1.0f + drad + dconv);
+		// Salvaguarda: si Newton sale del intervalo, biseccion
+		if (T_new <= lo || T_new >= hi) T_new = 0.5f * (lo + hi);
+
+		float paso = fabsf(T_new - T_cl);
+		T_cl = T_new;
+		if (paso < PMV_TCL_TOLERANCIA) break;
+	}
+	tclPrevia = T_cl;
+	return it;
+}
+
+// Perdidas de calor con T_cl ya resuelta y PMV recortado a +-3. p_a es la
+// presion de vapor en Pa: RH * 10 * saturation_vapor_pressure_kPa(Ta).
+inline float balancePMV(const TerminosPMV &t, float Ta, float p_a, float trK4, float T_cl) {
+	float h_c = t.h_cf;
+	float h_c2 = 2.38f * sqrtf(sqrtf(fabsf(T_cl - Ta)));
+	if (h_c2 > h_c) h_c = h_c2;
+
+	float tclK = T_cl + 273.15f;
+	float tclK2 = tclK * tclK;
+	float balance = t.balance0 + t.k_pa * p_a + t.k_ta * Ta
+		- t.radCoef * (tclK2 * tclK2 - trK4)
+		- t.f_cl * h_c * (T_cl - Ta);
+
+	float pmv = t.factor * balance;
+	if (pmv > 3.0f) pmv = 3.0f;
+	if (pmv < -3.0f) pmv = -3.0f;
+	return pmv;
+}
+
+// Nucleo de computePMV: sanea las entradas, resuelve T_cl con Newton
+// salvaguardado (arrancando en tclPrevia) y evalua el balance. Inline para
+// que con terminos constexpr solo quede el trabajo que depende de Ta/Tr/RH.
+// Las partes sueltas sirven a PMVIncremental.h para recalcular solo lo que
+// depende de la entrada que cambio.
+inline PMVResult nucleoPMV(const TerminosPMV &t, float Ta, float Tr, float RH, float &tclPrevia) {
+	if (!sanearPMV(Ta, Tr, RH)) {
+		return { 0.0f, NAN, 0 };
+	}
+	float p_a = RH * 10.0f * saturation_vapor_pressure_kPa(Ta);
+	float trK4 = radiantePMV(Tr);
+	uint8_t it = resolverTclPMV(t, Ta, Tr, trK4, tclPrevia);
+	return { balancePMV(t, Ta, p_a, trK4, tclPrevia), tclPrevia, it };
+}
+
+// Perfil del sketch como tipo, para especializar computePMVPerfil
+struct PerfilSketch {
+	static constexpr float met = PMV_MET;
+	static constexpr float clo = PMV_CLO;
+	static constexpr float va = PMV_VA;
+};
+
+// computePMV especializado para un perfil constante (met/clo/va como
+// miembros static constexpr de Perfil). Cada perfil tiene su propio
+// arranque en caliente.
+template <class Perfil>
+PMVResult computePMVPerfil(float Ta, float Tr, float RH) {
+	static constexpr TerminosPMV terminos = terminosPMVConst(Perfil::met, Perfil::clo, Perfil::va);
+	static float tclPrevia = NAN;
+	return nucleoPMV(terminos, Ta, Tr, RH, tclPrevia);
+}
+
+#endif
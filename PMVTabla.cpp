@@ -0,0 +1,109 @@
+#include <Arduino.h>
+#include "PMV.h"
+#include "PMVConsigna.h"
+#include "PMVTablaDatos.h"
+
+static inline float celda(uint8_t i, uint8_t j, uint8_t k) {
+	return (float)(int16_t)pgm_read_word(&pmvTabla[i][j][k]);
+}
+
+// Indice de celda y fraccion dentro de ella, sin salir de la rejilla
+static inline uint8_t ubicar(float x, float minimo, float paso, uint8_t n, float &frac) {
+	float pos = (x - minimo) / paso;
+	if (pos <= 0.0f) {
+		frac = 0.0f;
+		return 0;
+	}
+	// Antes de convertir: una x enorme no entra en un uint8_t
+	if (pos >= n - 1) {
+		frac = 1.0f;
+		return n - 2;
+	}
+	uint8_t idx = (uint8_t)pos;
+	frac = pos - idx;
+	return idx;
+}
+
+// PMV x1000 de la fila i de Ta, interpolado en Tr (j, b) y RH (k, c)
+static float columna(uint8_t i, uint8_t j, float b, uint8_t k, float c) {
+	float c0 = celda(i, j, k) + c * (celda(i, j, k + 1) - celda(i, j, k));
+	float c1 = celda(i, j + 1, k) + c * (celda(i, j + 1, k + 1) - celda(i, j + 1, k));
+	return c0 + b * (c1 - c0);
+}
+
+PMVResult computePMVTabla(float Ta, float Tr, float RH) {
+	// Mismo saneado de entradas que computePMV
+	if (!sanearPMV(Ta, Tr, RH)) {
+		return { 0.0f, NAN, 0 };
+	}
+	
+	float a, b, c;
+	uint8_t i = ubicar(Ta, PMV_TABLA_TA_MIN, PMV_TABLA_TA_PASO, PMV_TABLA_NTA, a);
+	uint8_t j = ubicar(Tr, PMV_TABLA_TR_MIN, PMV_TABLA_TR_PASO, PMV_TABLA_NTR, b);
+	uint8_t k = ubicar(RH, PMV_TABLA_RH_MIN, PMV_TABLA_RH_PASO, PMV_TABLA_NRH, c);
+	
+	// Interpolacion a lo largo de RH, luego Tr, luego Ta
+	float c0 = columna(i, j, b, k, c);
+	float c1 = columna(i + 1, j, b, k, c);
+	float pmv = (c0 + a * (c1 - c0)) * 0.001f;
+	
+	return { pmv, NAN, 0 };
+}
+
+static inline float taFila(uint8_t i) {
+	return PMV_TABLA_TA_MIN + PMV_TABLA_TA_PASO * i;
+}
+
+ConsignaPMV consignaPMVTabla(float objetivo, float Tr, float RH, ArranqueConsigna &previa) {
+	if (!sanearConsigna(objetivo, Tr, RH)) return { NAN, 0, false };
+
+	float b, c;
+	uint8_t j = ubicar(Tr, PMV_TABLA_TR_MIN, PMV_TABLA_TR_PASO, PMV_TABLA_NTR, b);
+	uint8_t k = ubicar(RH, PMV_TABLA_RH_MIN, PMV_TABLA_RH_PASO, PMV_TABLA_NRH, c);
+	float y = objetivo * 1000.0f;
+
+	// Filas de Ta dentro del rango de la consigna
+	const uint8_t iMin = (uint8_t)ceilf((PMV_CONSIGNA_TA_MIN - PMV_TABLA_TA_MIN) / PMV_TABLA_TA_PASO);
+	const uint8_t iMax = (uint8_t)((PMV_CONSIGNA_TA_MAX - PMV_TABLA_TA_MIN) / PMV_TABLA_TA_PASO);
+	uint8_t lo = iMin, hi = iMax;
+	uint8_t n = 0;
+
+	// Primero el tramo de la consigna anterior; despues biseccion de filas
+	if (!isnan(previa.Ta)) {
+		float frac;
+		uint8_t i = ubicar(previa.Ta, PMV_TABLA_TA_MIN, PMV_TABLA_TA_PASO, PMV_TABLA_NTA, frac);
+		if (i < iMin) i = iMin;
+		if (i > iMax - 1) i = iMax - 1;
+		n++;
+		if (columna(i, j, b, k, c) <= y) {
+			lo = i;
+			n++;
+			if (columna(i + 1, j, b, k, c) > y) hi = i + 1;
+		} else {
+			hi = i;
+		}
+	}
+	while (hi - lo > 1) {
+		uint8_t medio = (lo + hi) / 2;
+		n++;
+		if (columna(medio, j, b, k, c) <= y) lo = medio;
+		else hi = medio;
+	}
+
+	// En el tramo [lo, hi] la interpolacion en Ta es una recta
+	float yLo = columna(lo, j, b, k, c);
+	float yHi = columna(hi, j, b, k, c);
+	n += 2;
+	ConsignaPMV res = { 0.0f, n, false };
+	if (y <= yLo) {
+		res.Ta = taFila(lo);
+		res.saturada = y < yLo;
+	} else if (y >= yHi) {
+		res.Ta = taFila(hi);
+		res.saturada = y > yHi;
+	} else {
+		res.Ta = taFila(lo) + PMV_TABLA_TA_PASO * (y - yLo) / (yHi - yLo);
+	}
+	previa.Ta = res.Ta;
+	return res;
+}
@@ -0,0 +1,498 @@
+// Generado por host/gen_pmv_tabla.cpp: no editar a mano.
+// PMV x1000 con met=1.00, clo=0.61, va=0.10; indices [Ta][Tr][RH].
+#ifndef SMARTCOMFORT_PMVTABLADATOS_H
+#define SMARTCOMFORT_PMVTABLADATOS_H
+
+#define PMV_TABLA_TA_MIN (-10.0f)
+#define PMV_TABLA_TA_PASO 2.0f
+#define PMV_TABLA_NTA 31
+#define PMV_TABLA_TR_MIN (-10.0f)
+#define PMV_TABLA_TR_PASO 5.0f
+#define PMV_TABLA_NTR 13
+#define PMV_TABLA_RH_MIN (0.0f)
+#define PMV_TABLA_RH_PASO 20.0f
+#define PMV_TABLA_NRH 6
+
+static const int16_t pmvTabla[PMV_TABLA_NTA][PMV_TABLA_NTR][PMV_TABLA_NRH] PROGMEM = {
+	{ // Ta = -10.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 }
+	},
+	{ // Ta = -8.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 }
+	},
+	{ // Ta = -6.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 }
+	},
+	{ // Ta = -4.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -2631,  -2607,  -2583,  -2559,  -2535,  -2511 }
+	},
+	{ // Ta = -2.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -2973,  -2945,  -2917,  -2889 },
+		{  -2154,  -2126,  -2098,  -2070,  -2042,  -2015 }
+	},
+	{ // Ta = 0.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -2558,  -2526,  -2493,  -2461,  -2429,  -2397 },
+		{  -1681,  -1649,  -1616,  -1584,  -1552,  -1520 }
+	},
+	{ // Ta = 2.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -2936,  -2899,  -2861,  -2824,  -2787,  -2750 },
+		{  -2091,  -2054,  -2017,  -1980,  -1943,  -1905 },
+		{  -1212,  -1175,  -1138,  -1100,  -1063,  -1026 }
+	},
+	{ // Ta = 4.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -2477,  -2434,  -2391,  -2348,  -2305,  -2262 },
+		{  -1630,  -1587,  -1544,  -1501,  -1458,  -1415 },
+		{   -748,   -705,   -662,   -619,   -576,   -533 }
+	},
+	{ // Ta = 6.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -2838,  -2789,  -2740,  -2690,  -2641,  -2592 },
+		{  -2023,  -1973,  -1924,  -1875,  -1825,  -1776 },
+		{  -1173,  -1123,  -1074,  -1025,   -975,   -926 },
+		{   -288,   -239,   -190,   -140,    -91,    -42 }
+	},
+	{ // Ta = 8.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -2952,  -2895 },
+		{  -2393,  -2336,  -2279,  -2223,  -2166,  -2110 },
+		{  -1574,  -1517,  -1461,  -1404,  -1347,  -1291 },
+		{   -721,   -664,   -608,   -551,   -495,   -438 },
+		{    167,    223,    280,    336,    393,    450 }
+	},
+	{ // Ta = 10.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -2742,  -2677,  -2612,  -2548,  -2483,  -2418 },
+		{  -1953,  -1888,  -1823,  -1758,  -1694,  -1629 },
+		{  -1130,  -1066,  -1001,   -936,   -871,   -807 },
+		{   -274,   -209,   -145,    -80,    -15,     50 },
+		{    616,    681,    746,    811,    876,    940 }
+	},
+	{ // Ta = 12.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -2999,  -2925,  -2851,  -2777,  -2703 },
+		{  -2312,  -2238,  -2164,  -2090,  -2016,  -1942 },
+		{  -1519,  -1445,  -1371,  -1297,  -1223,  -1149 },
+		{   -693,   -619,   -545,   -471,   -397,   -323 },
+		{    167,    241,    315,    389,    463,    537 },
+		{   1061,   1135,   1209,   1283,   1357,   1431 }
+	},
+	{ // Ta = 14.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -2967 },
+		{  -2655,  -2571,  -2486,  -2402,  -2318,  -2233 },
+		{  -1890,  -1805,  -1721,  -1637,  -1552,  -1468 },
+		{  -1092,  -1008,   -924,   -839,   -755,   -671 },
+		{   -262,   -178,    -93,     -9,     75,    160 },
+		{    602,    686,    771,    855,    939,   1024 },
+		{   1500,   1584,   1669,   1753,   1837,   1922 }
+	},
+	{ // Ta = 16.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -2985,  -2889,  -2793,  -2697,  -2601,  -2505 },
+		{  -2246,  -2150,  -2054,  -1958,  -1862,  -1766 },
+		{  -1475,  -1379,  -1283,  -1187,  -1091,   -995 },
+		{   -673,   -577,   -481,   -385,   -289,   -193 },
+		{    162,    258,    354,    450,    546,    642 },
+		{   1031,   1127,   1222,   1318,   1414,   1510 },
+		{   1933,   2029,   2125,   2221,   2317,   2412 }
+	},
+	{ // Ta = 18.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -2981,  -2872,  -2763 },
+		{  -2591,  -2482,  -2373,  -2264,  -2156,  -2047 },
+		{  -1845,  -1736,  -1627,  -1519,  -1410,  -1301 },
+		{  -1069,   -960,   -851,   -742,   -633,   -524 },
+		{   -261,   -152,    -43,     66,    175,    284 },
+		{    579,    688,    797,    906,   1015,   1124 },
+		{   1453,   1561,   1670,   1779,   1888,   1997 },
+		{   2359,   2468,   2577,   2686,   2795,   2904 }
+	},
+	{ // Ta = 20.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -2939,  -2816,  -2692,  -2569,  -2445,  -2322 },
+		{  -2209,  -2085,  -1962,  -1839,  -1715,  -1592 },
+		{  -1455,  -1332,  -1209,  -1085,   -962,   -838 },
+		{   -672,   -549,   -425,   -302,   -178,    -55 },
+		{    142,    266,    389,    513,    636,    759 },
+		{    989,   1112,   1235,   1359,   1482,   1605 },
+		{   1867,   1991,   2114,   2237,   2361,   2484 },
+		{   2779,   2903,   3000,   3000,   3000,   3000 }
+	},
+	{ // Ta = 22.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -2937,  -2797,  -2658 },
+		{  -2626,  -2487,  -2347,  -2208,  -2068,  -1929 },
+		{  -1861,  -1721,  -1582,  -1442,  -1303,  -1163 },
+		{  -1077,   -938,   -798,   -659,   -519,   -380 },
+		{   -286,   -146,     -7,    133,    272,    412 },
+		{    536,    675,    815,    954,   1094,   1233 },
+		{   1389,   1528,   1668,   1807,   1947,   2086 },
+		{   2274,   2413,   2553,   2692,   2832,   2971 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 }
+	},
+	{ // Ta = 24.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -2947 },
+		{  -3000,  -2885,  -2727,  -2570,  -2412,  -2255 },
+		{  -2314,  -2157,  -1999,  -1842,  -1685,  -1527 },
+		{  -1550,  -1392,  -1235,  -1077,   -920,   -762 },
+		{   -747,   -589,   -432,   -275,   -117,     40 },
+		{     88,    245,    403,    560,    718,    875 },
+		{    918,   1076,   1233,   1391,   1548,   1706 },
+		{   1779,   1937,   2094,   2252,   2409,   2566 },
+		{   2671,   2829,   2986,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 }
+	},
+	{ // Ta = 26.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -2889,  -2712,  -2534 },
+		{  -2730,  -2552,  -2375,  -2198,  -2020,  -1843 },
+		{  -2002,  -1825,  -1648,  -1470,  -1293,  -1116 },
+		{  -1239,  -1061,   -884,   -707,   -529,   -352 },
+		{   -437,   -259,    -82,     95,    273,    450 },
+		{    404,    581,    759,    936,   1113,   1291 },
+		{   1285,   1462,   1639,   1817,   1994,   2171 },
+		{   2159,   2336,   2513,   2691,   2868,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 }
+	},
+	{ // Ta = 28.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -2966,  -2767 },
+		{  -3000,  -2908,  -2709,  -2510,  -2310,  -2111 },
+		{  -2417,  -2218,  -2018,  -1819,  -1620,  -1420 },
+		{  -1691,  -1492,  -1292,  -1093,   -893,   -694 },
+		{   -928,   -728,   -529,   -330,   -130,     69 },
+		{   -127,     73,    272,    471,    671,    870 },
+		{    713,    912,   1112,   1311,   1511,   1710 },
+		{   1593,   1792,   1991,   2191,   2390,   2590 },
+		{   2513,   2713,   2912,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 }
+	},
+	{ // Ta = 30.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -2953 },
+		{  -3000,  -3000,  -3000,  -2779,  -2555,  -2331 },
+		{  -2795,  -2571,  -2347,  -2124,  -1900,  -1676 },
+		{  -2105,  -1882,  -1658,  -1434,  -1210,   -986 },
+		{  -1380,  -1156,   -932,   -708,   -484,   -261 },
+		{   -617,   -394,   -170,     54,    278,    502 },
+		{    183,    406,    630,    854,   1078,   1302 },
+		{   1022,   1245,   1469,   1693,   1917,   2141 },
+		{   1900,   2124,   2348,   2572,   2796,   3000 },
+		{   2820,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 }
+	},
+	{ // Ta = 32.0
+		{  -3000,  -3000,  -3000,  -3000,  -3000,  -3000 },
+		{  -3000,  -3000,  -3000,  -3000,  -2752,  -2501 },
+		{  -3000,  -2886,  -2636,  -2385,  -2134,  -1883 },
+		{  -2483,  -2232,  -1981,  -1730,  -1479,  -1229 },
+		{  -1794,  -1543,  -1292,  -1041,   -790,   -539 },
+		{  -1069,   -818,   -567,   -316,    -66,    185 },
+		{   -307,    -57,    194,    445,    696,    947 },
+		{    492,    743,    993,   1244,   1495,   1746 },
+		{   1330,   1581,   1831,   2082,   2333,   2584 },
+		{   2208,   2458,   2709,   2960,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 }
+	},
+	{ // Ta = 34.0
+		{  -3000,  -3000,  -3000,  -3000,  -2803,  -2523 },
+		{  -3000,  -3000,  -2817,  -2536,  -2256,  -1975 },
+		{  -2796,  -2516,  -2235,  -1954,  -1674,  -1393 },
+		{  -2171,  -1890,  -1610,  -1329,  -1048,   -768 },
+		{  -1482,  -1202,   -921,   -641,   -360,    -79 },
+		{   -758,   -478,   -197,     83,    364,    645 },
+		{      2,    283,    564,    844,   1125,   1405 },
+		{    801,   1081,   1362,   1643,   1923,   2204 },
+		{   1638,   1918,   2199,   2480,   2760,   3000 },
+		{   2515,   2795,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 }
+	},
+	{ // Ta = 36.0
+		{  -3000,  -3000,  -2904,  -2590,  -2277,  -1964 },
+		{  -2990,  -2676,  -2363,  -2049,  -1736,  -1422 },
+		{  -2415,  -2101,  -1788,  -1475,  -1161,   -848 },
+		{  -1805,  -1492,  -1178,   -865,   -551,   -238 },
+		{  -1158,   -844,   -531,   -218,     96,    409 },
+		{   -448,   -135,    179,    492,    806,   1119 },
+		{    312,    625,    939,   1252,   1565,   1879 },
+		{   1109,   1423,   1736,   2050,   2363,   2676 },
+		{   1945,   2259,   2572,   2886,   3000,   3000 },
+		{   2821,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 }
+	},
+	{ // Ta = 38.0
+		{  -3000,  -2777,  -2427,  -2078,  -1728,  -1379 },
+		{  -2591,  -2241,  -1892,  -1542,  -1193,   -843 },
+		{  -2023,  -1673,  -1324,   -974,   -625,   -275 },
+		{  -1420,  -1071,   -721,   -372,    -22,    327 },
+		{   -782,   -432,    -82,    267,    617,    966 },
+		{   -104,    245,    595,    944,   1294,   1643 },
+		{    621,    970,   1320,   1669,   2019,   2368 },
+		{   1417,   1767,   2116,   2466,   2815,   3000 },
+		{   2253,   2602,   2952,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 }
+	},
+	{ // Ta = 40.0
+		{  -2714,  -2325,  -1936,  -1547,  -1158,   -768 },
+		{  -2184,  -1795,  -1406,  -1016,   -627,   -238 },
+		{  -1621,  -1232,   -843,   -454,    -65,    324 },
+		{  -1025,   -636,   -247,    142,    531,    920 },
+		{   -394,     -5,    384,    773,   1163,   1552 },
+		{    275,    664,   1053,   1442,   1831,   2220 },
+		{    983,   1372,   1761,   2150,   2539,   2928 },
+		{   1733,   2122,   2511,   2900,   3000,   3000 },
+		{   2560,   2949,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 }
+	},
+	{ // Ta = 42.0
+		{  -2295,  -1862,  -1430,   -997,   -564,   -132 },
+		{  -1769,  -1337,   -904,   -471,    -39,    394 },
+		{  -1212,   -779,   -347,     86,    518,    951 },
+		{   -622,   -189,    243,    676,   1109,   1541 },
+		{      3,    436,    868,   1301,   1733,   2166 },
+		{    665,   1097,   1530,   1962,   2395,   2827 },
+		{   1364,   1797,   2229,   2662,   3000,   3000 },
+		{   2104,   2537,   2969,   3000,   3000,   3000 },
+		{   2888,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 }
+	},
+	{ // Ta = 44.0
+		{  -1869,  -1389,   -909,   -428,     52,    532 },
+		{  -1348,   -867,   -387,     93,    573,   1053 },
+		{   -795,   -315,    165,    645,   1125,   1605 },
+		{   -210,    270,    750,   1230,   1710,   2190 },
+		{    409,    889,   1369,   1849,   2329,   2809 },
+		{   1063,   1543,   2024,   2504,   2984,   3000 },
+		{   1756,   2236,   2716,   3000,   3000,   3000 },
+		{   2487,   2967,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 }
+	},
+	{ // Ta = 46.0
+		{  -1437,   -905,   -373,    159,    691,   1223 },
+		{   -920,   -388,    144,    676,   1208,   1741 },
+		{   -372,    160,    692,   1224,   1756,   2289 },
+		{    208,    740,   1272,   1804,   2336,   2869 },
+		{    822,   1354,   1886,   2418,   2950,   3000 },
+		{   1470,   2002,   2535,   3000,   3000,   3000 },
+		{   2156,   2688,   3000,   3000,   3000,   3000 },
+		{   2880,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 }
+	},
+	{ // Ta = 48.0
+		{  -1000,   -412,    177,    766,   1355,   1944 },
+		{   -487,    102,    691,   1280,   1869,   2458 },
+		{     57,    646,   1235,   1824,   2413,   3000 },
+		{    632,   1221,   1810,   2399,   2988,   3000 },
+		{   1241,   1830,   2419,   3000,   3000,   3000 },
+		{   1884,   2473,   3000,   3000,   3000,   3000 },
+		{   2564,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 }
+	},
+	{ // Ta = 50.0
+		{   -559,     92,    743,   1394,   2045,   2695 },
+		{    -49,    602,   1253,   1904,   2555,   3000 },
+		{    491,   1142,   1793,   2444,   3000,   3000 },
+		{   1062,   1713,   2364,   3000,   3000,   3000 },
+		{   1666,   2317,   2968,   3000,   3000,   3000 },
+		{   2305,   2955,   3000,   3000,   3000,   3000 },
+		{   2978,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 },
+		{   3000,   3000,   3000,   3000,   3000,   3000 }
+	}
+};
+
+// Presion de vapor saturado [Pa] de saturation_vapor_pressure_kPa, T = -10..50 C
+#define PSAT_TABLA_T_MIN -10
+#define PSAT_TABLA_N 61
+
+static const uint16_t psatTabla[PSAT_TABLA_N] PROGMEM = {
+	286, 309, 334, 361, 390, 421, 454, 489, 527, 567,
+	611, 656, 705, 757, 813, 872, 935, 1001, 1072, 1147,
+	1227, 1312, 1402, 1497, 1598, 1705, 1817, 1937, 2063, 2196,
+	2337, 2486, 2643, 2808, 2982, 3166, 3360, 3564, 3778, 4004,
+	4241, 4490, 4752, 5028, 5317, 5620, 5938, 6272, 6622, 6988,
+	7372, 7774, 8195, 8635, 9096, 9578, 10081, 10608, 11157, 11731,
+	12331
+};
+
+#endif
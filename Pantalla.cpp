@@ -0,0 +1,57 @@
+#include "Pantalla.h"
+
+Pantalla::Pantalla(LiquidCrystal &lcd)
+	: _lcd(lcd), _col(0), _fila(0), _lcdCol(0), _lcdFila(0), _pendiente(false) {
+	memset(_deseado, ' ', sizeof(_deseado));
+	memset(_mostrado, ' ', sizeof(_mostrado));
+}
+
+void Pantalla::begin() {
+	// lcd.begin() borra el LCD: arranca igual que la copia
+	_lcd.begin(PANTALLA_COLUMNAS, PANTALLA_FILAS);
+	memset(_mostrado, ' ', sizeof(_mostrado));
+	_lcdCol = 0;
+	_lcdFila = 0;
+}
+
+void Pantalla::clear() {
+	memset(_deseado, ' ', sizeof(_deseado));
+	_col = 0;
+	_fila = 0;
+	_pendiente = true;
+}
+
+void Pantalla::setCursor(uint8_t col, uint8_t fila) {
+	_col = col;
+	_fila = fila < PANTALLA_FILAS ? fila : PANTALLA_FILAS - 1;
+}
+
+size_t Pantalla::write(uint8_t c) {
+	if (_col < PANTALLA_COLUMNAS) {
+		_deseado[_fila][_col] = (char)c;
+		_pendiente = true;
+	}
+	_col++;
+	return 1;
+}
+
+uint8_t Pantalla::refrescar(uint8_t maxBytes) {
+	if (!_pendiente) return 0;
+	uint8_t enviados = 0;
+	for (uint8_t f = 0; f < PANTALLA_FILAS; f++) {
+		for (uint8_t c = 0; c < PANTALLA_COLUMNAS; c++) {
+			if (_deseado[f][c] == _mostrado[f][c]) continue;
+			// Celdas seguidas salen sin reposicionar: el LCD avanza solo
+			uint8_t costo = (f == _lcdFila && c == _lcdCol) ? 1 : 2;
+			if (enviados + costo > maxBytes) return enviados;
+			if (costo == 2) _lcd.setCursor(c, f);
+			_lcd.write((uint8_t)_deseado[f][c]);
+			_mostrado[f][c] = _deseado[f][c];
+			_lcdFila = f;
+			_lcdCol = c + 1;
+			enviados += costo;
+		}
+	}
+	_pendiente = false;
+	return enviados;
+}
@@ -0,0 +1,45 @@
+#ifndef SMARTCOMFORT_PANTALLA_H
+#define SMARTCOMFORT_PANTALLA_H
+
+#include <Arduino.h>
+#include <LiquidCrystal.h>
+
+#define PANTALLA_COLUMNAS 16
+#define PANTALLA_FILAS 2
+// Bytes al LCD por pasada del loop (~100 us cada uno): una pantalla
+// completa sale en 4 o 5 pasadas
+#define PANTALLA_BYTES_POR_PASADA 8
+
+// Copia en RAM del LCD 16x2. Los estados escriben con la misma interfaz de
+// LiquidCrystal (clear, setCursor, print), pero solo en la copia: clear()
+// no toca el LCD y lo que cae fuera de las 16 columnas se descarta.
+// refrescar(), una vez por pasada, envia solo las celdas que difieren de lo
+// que el LCD ya muestra, con un tope de bytes por llamada.
+class Pantalla : public Print {
+public:
+	explicit Pantalla(LiquidCrystal &lcd);
+	
+	// Inicializa el LCD (lcd.begin + un solo clear real)
+	void begin();
+	
+	void clear();
+	void setCursor(uint8_t col, uint8_t fila);
+	size_t write(uint8_t c) override;
+	using Print::write;
+	
+	// Envia hasta maxBytes (datos y posicionamientos); devuelve los enviados
+	uint8_t refrescar(uint8_t maxBytes = PANTALLA_BYTES_POR_PASADA);
+	
+	// true si el LCD ya muestra la copia completa
+	bool alDia() const { return !_pendiente; }
+	
+private:
+	LiquidCrystal &_lcd;
+	char _deseado[PANTALLA_FILAS][PANTALLA_COLUMNAS];
+	char _mostrado[PANTALLA_FILAS][PANTALLA_COLUMNAS];
+	uint8_t _col, _fila;        // cursor de la copia
+	uint8_t _lcdCol, _lcdFila;  // cursor del LCD (avanza solo al escribir)
+	bool _pendiente;
+};
+
+#endif
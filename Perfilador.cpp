@@ -0,0 +1,145 @@
+#include "Perfilador.h"
+#include "Bitacora.h"
+
+#define PERFIL_FILAS (PERF_SECCIONES + PERFIL_MAX_TAREAS)
+#define PERFIL_PASO_PMV (2 * PERFIL_FILAS + 1)
+#define PERFIL_PASO_REPOSO (PERFIL_PASO_PMV + 1)
+#define PERFIL_PASO_FIN (PERFIL_PASO_REPOSO + REPOSO_ESTADOS)
+
+static_assert(PERF_SECCIONES < PERFIL_TAREA && PERFIL_MAX_TAREAS <= PERFIL_TAREA, "ids de seccion superpuestos");
+static_assert(2 + 2 * PERFIL_CUBOS <= BITACORA_MAX_DATOS, "el histograma no entra en una trama");
+
+// Sin constructor: arranca en cero, como el planificador
+Perfilador perfilador;
+
+static uint8_t cubo(uint32_t us) {
+	uint8_t b = 0;
+	while (b < PERFIL_CUBOS - 1 && (us >> (b + 1)) != 0) b++;
+	return b;
+}
+
+static uint8_t idFila(uint8_t fila) {
+	return fila < PERF_SECCIONES ? fila : (uint8_t)(PERFIL_TAREA | (fila - PERF_SECCIONES));
+}
+
+static uint8_t poner32(uint8_t *p, uint32_t v) {
+	for (uint8_t i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+	return 4;
+}
+
+EstadisticaSeccion *Perfilador::estadistica(uint8_t seccion) {
+	if (seccion & PERFIL_TAREA) {
+		uint8_t n = seccion & ~PERFIL_TAREA;
+		return n < PERFIL_MAX_TAREAS ? &_tareas[n] : nullptr;
+	}
+	return seccion < PERF_SECCIONES ? &_secciones[seccion] : nullptr;
+}
+
+const EstadisticaSeccion *Perfilador::estadistica(uint8_t seccion) const {
+	return const_cast<Perfilador *>(this)->estadistica(seccion);
+}
+
+void Perfilador::registrar(uint8_t seccion, uint32_t us) {
+	EstadisticaSeccion *e = estadistica(seccion);
+	if (e == nullptr) return;
+	if (e->n == 0 || us < e->minimo) e->minimo = us;
+	if (e->n == 0 || us > e->maximo) {
+		e->maximo = us;
+		if (seccion == PERF_LOOP) {
+			_peorEstado = _estado;
+			_peorInstante = millis();
+		}
+	}
+	e->n++;
+
+	// La media es de una ventana: al desbordar se olvida la mitad
+	if (e->sumadas == 0xFFFF || e->suma + us < e->suma) {
+		e->suma >>= 1;
+		e->sumadas >>= 1;
+	}
+	e->suma += us;
+	e->sumadas++;
+
+	uint8_t b = cubo(us);
+	if (e->cubos[b] == 0xFFFF) {
+		for (uint8_t i = 0; i < PERFIL_CUBOS; i++) e->cubos[i] >>= 1;
+	}
+	e->cubos[b]++;
+}
+
+void Perfilador::reiniciar() {
+	memset(_secciones, 0, sizeof(_secciones));
+	memset(_tareas, 0, sizeof(_tareas));
+	_peorEstado = 0;
+	_peorInstante = 0;
+}
+
+// Paso del volcado: dos por fila (estadisticas e histograma), la peor
+// pasada, los contadores del PMV incremental, el reposo de cada estado y el
+// fin. Devuelve false si la bitacora no tiene lugar.
+bool Perfilador::enviar(uint8_t paso) {
+	uint8_t d[2 + 2 * PERFIL_CUBOS];
+	uint8_t n = 0;
+	if (paso < 2 * PERFIL_FILAS) {
+		uint8_t fila = paso / 2;
+		uint8_t id = idFila(fila);
+		const EstadisticaSeccion &e = *estadistica(id);
+		if (e.n == 0) return true;  // nunca medida: no se envia
+		d[n++] = id;
+		if (paso % 2 == 0) {
+			n += poner32(d + n, fila < PERF_SECCIONES ? 0 : _intervalos[fila - PERF_SECCIONES]);
+			n += poner32(d + n, e.n);
+			n += poner32(d + n, e.minimo);
+			n += poner32(d + n, e.maximo);
+			n += poner32(d + n, e.media());
+			return bitacora.perfilado(PERFILADO_SECCION, d, n);
+		}
+		for (uint8_t i = 0; i < PERFIL_CUBOS; i++) {
+			d[n++] = (uint8_t)e.cubos[i];
+			d[n++] = (uint8_t)(e.cubos[i] >> 8);
+		}
+		return bitacora.perfilado(PERFILADO_HISTOGRAMA, d, n);
+	}
+	if (paso == 2 * PERFIL_FILAS) {
+		n += poner32(d + n, _secciones[PERF_LOOP].maximo);
+		n += poner32(d + n, _peorInstante);
+		d[n++] = _peorEstado;
+		return bitacora.perfilado(PERFILADO_PEOR_LOOP, d, n);
+	}
+	if (paso == PERFIL_PASO_PMV) {
+		if (_pmv == nullptr) return true;
+		n += poner32(d + n, _pmv->aciertos);
+		n += poner32(d + n, _pmv->soloRH);
+		n += poner32(d + n, _pmv->soloTr);
+		n += poner32(d + n, _pmv->completas);
+		n += poner32(d + n, _pmv->usAhorrados());
+		return bitacora.perfilado(PERFILADO_PMV, d, n);
+	}
+	if (paso < PERFIL_PASO_FIN) {
+		if (_reposo == nullptr) return true;
+		uint8_t estado = paso - PERFIL_PASO_REPOSO;
+		const EstadisticaReposo &r = _reposo->estadistica(estado);
+		if (r.msActivo == 0 && r.msDormido == 0) return true;  // estado sin visitar
+		d[n++] = estado;
+		n += poner32(d + n, r.msActivo);
+		n += poner32(d + n, r.msDormido);
+		n += poner32(d + n, r.despertaresTiempo);
+		n += poner32(d + n, r.despertaresEntrada);
+		d[n++] = (uint8_t)r.latenciaMaxima;
+		d[n++] = (uint8_t)(r.latenciaMaxima >> 8);
+		return bitacora.perfilado(PERFILADO_REPOSO, d, n);
+	}
+	return bitacora.perfilado(PERFILADO_FIN, nullptr, 0);
+}
+
+void Perfilador::servicio() {
+	if (_volcado == 0) return;
+	uint8_t paso = (uint8_t)(_volcado - 1);
+	// Las filas sin mediciones no ocupan la pasada
+	while (paso < 2 * PERFIL_FILAS && estadistica(idFila(paso / 2))->n == 0) paso += 2;
+	if (!enviar(paso)) {
+		_volcado = paso + 1;
+		return;
+	}
+	_volcado = paso >= PERFIL_PASO_FIN ? 0 : paso + 2;
+}
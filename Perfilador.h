@@ -0,0 +1,120 @@
+#ifndef SMARTCOMFORT_PERFILADOR_H
+#define SMARTCOMFORT_PERFILADOR_H
+
+#include <Arduino.h>
+#include "PMVIncremental.h"
+#include "Reposo.h"
+
+// Tiempos del loop por seccion, medidos con micros(). PERFIL_SECCION(s) al
+// comienzo de un bloque mide hasta el final del bloque; por seccion se
+// guardan la cantidad, el minimo, el maximo, la media y un histograma en
+// potencias de dos (el cubo b cuenta las duraciones de 2^b a 2^(b+1) - 1
+// us; el ultimo, de 2^15 us en adelante). Las tareas del planificador se
+// miden cada una como su propia seccion.
+//
+// Solo con SMARTCOMFORT_PERFIL definido (el build de host siempre lo
+// define): sin el, PERFIL_SECCION() no genera codigo. Con el, cada medicion
+// cuesta dos micros() (resolucion de 4 us en la placa) y las estadisticas
+// ocupan ~1.4 KB de RAM. Enviando 'P' por el monitor serie se vuelcan por la
+// bitacora (REG_PERFILADO) sin bloquear el loop; 'p' las pone a cero.
+#define PERFIL_CUBOS 16
+#define PERFIL_MAX_TAREAS 16
+#define PERFIL_TAREA 0x80  // id de seccion de la tarea n: PERFIL_TAREA | n
+
+enum SeccionPerfil : uint8_t {
+	PERF_LOOP = 0,   // pasada completa, con la espera
+	PERF_ENTRADA,    // readInput()
+	PERF_MAQUINA,    // maquina.actualizar()
+	PERF_TAREAS,     // planificador.Ejecutar(), todas las tareas vencidas
+	PERF_ESPERA,     // reposo hasta la proxima tarea o entrada
+	PERF_PMV,        // evaluarPMV() de las salas
+	PERF_DHT,        // lectura de Ta y RH
+	PERF_NTC,        // lectura sobremuestreada de Tr
+	PERF_PANTALLA,   // pantalla.refrescar()
+	PERF_BITACORA,   // bitacora.drenar()
+	PERF_SECCIONES
+};
+
+// Subtipos de REG_PERFILADO
+enum TipoPerfilado : uint8_t {
+	PERFILADO_SECCION = 0,     // id, intervalo (ms, tareas), n, min, max, media (uint32)
+	PERFILADO_HISTOGRAMA = 1,  // id, PERFIL_CUBOS cuentas (uint16)
+	PERFILADO_PEOR_LOOP = 2,   // duracion (us), millis(), estado
+	PERFILADO_FIN = 3,
+	PERFILADO_PMV = 4,         // aciertos, solo RH, solo Tr, completas, us ahorrados (uint32)
+	PERFILADO_REPOSO = 5       // estado; ms activo, ms dormido, despertares por tiempo y por
+	                           // entrada (uint32); latencia maxima de los flancos (ms, uint16)
+};
+
+struct EstadisticaSeccion {
+	uint32_t n;
+	uint32_t minimo;
+	uint32_t maximo;
+	uint32_t suma;       // de las ultimas 'sumadas' mediciones
+	uint16_t sumadas;    // al desbordar, suma y sumadas se dividen a la mitad
+	uint16_t cubos[PERFIL_CUBOS];  // saturan dividiendo todos a la mitad
+
+	uint32_t media() const { return sumadas ? suma / sumadas : 0; }
+};
+
+class Perfilador {
+public:
+	void registrar(uint8_t seccion, uint32_t us);
+
+	// Estado de la maquina en la pasada en curso, para la peor pasada
+	void estado(uint8_t e) { _estado = e; }
+
+	// Intervalo de la tarea n, para reconocerla en el volcado
+	void tarea(uint8_t n, unsigned long intervalo) {
+		if (n < PERFIL_MAX_TAREAS) _intervalos[n] = intervalo;
+	}
+
+	// Contadores de PMVIncremental que acompanan al volcado (los de la sala
+	// principal)
+	void pmv(const EstadisticaPMVIncremental *e) { _pmv = e; }
+
+	// Reposo del loop por estado (ciclo activo y despertares)
+	void reposo(const Reposo *r) { _reposo = r; }
+
+	// Vuelca las estadisticas por la bitacora, un registro por pasada
+	void volcar() { if (_volcado == 0) _volcado = 1; }
+	bool volcando() const { return _volcado != 0; }
+	void servicio();
+	void reiniciar();
+
+private:
+	EstadisticaSeccion *estadistica(uint8_t seccion);
+	const EstadisticaSeccion *estadistica(uint8_t seccion) const;
+	bool enviar(uint8_t paso);
+
+	EstadisticaSeccion _secciones[PERF_SECCIONES];
+	EstadisticaSeccion _tareas[PERFIL_MAX_TAREAS];
+	unsigned long _intervalos[PERFIL_MAX_TAREAS];
+	uint8_t _estado;
+	uint8_t _peorEstado;
+	unsigned long _peorInstante;
+	uint16_t _volcado;  // proximo paso del volcado + 1; 0: sin volcado
+	const EstadisticaPMVIncremental *_pmv;
+	const Reposo *_reposo;
+};
+
+extern Perfilador perfilador;
+
+// Mide desde su construccion hasta el final del bloque
+class CronometroPerfil {
+public:
+	explicit CronometroPerfil(uint8_t seccion) : _seccion(seccion), _desde(micros()) {}
+	~CronometroPerfil() { perfilador.registrar(_seccion, (uint32_t)(micros() - _desde)); }
+
+private:
+	uint8_t _seccion;
+	unsigned long _desde;
+};
+
+#ifdef SMARTCOMFORT_PERFIL
+#define PERFIL_SECCION(s) CronometroPerfil _cronometroPerfil(s)
+#else
+#define PERFIL_SECCION(s) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,131 @@
+#include "Planificador.h"
+#include "Bitacora.h"
+#include "Traza.h"
+#include "Perfilador.h"
+
+Planificador planificador;
+
+// Comparacion de instantes tolerante al desborde de millis()
+static inline bool vencida(unsigned long vence, unsigned long ahora) {
+	return (long)(ahora - vence) >= 0;
+}
+
+Tarea::Tarea(unsigned long intervalo, bool autoReset, TareaCallback alVencer)
+	: Tarea(intervalo, autoReset, alVencer, planificador) {
+}
+
+Tarea::Tarea(unsigned long intervalo, bool autoReset, TareaCallback alVencer, Planificador &plan)
+	: Interval(intervalo), AutoReset(autoReset), _alVencer(alVencer), _siguiente(nullptr),
+	  _plan(plan), _vence(0), _pos(PLAN_SIN_POSICION), _activa(false) {
+#ifdef SMARTCOMFORT_PERFIL
+	static uint8_t construidas = 0;
+	_perfil = construidas;
+	if (construidas < 0xFF) construidas++;
+#endif
+}
+
+void Tarea::Start() {
+	// Con la cola llena la tarea queda inactiva, no activa sin correr nunca
+	_activa = _plan.programar(*this, millisTraza() + Interval);
+}
+
+void Tarea::Stop() {
+	_activa = false;
+	_plan.quitar(*this);
+}
+
+bool Planificador::antes(const Tarea *a, const Tarea *b) {
+	return (long)(a->_vence - b->_vence) < 0;
+}
+
+void Planificador::colocar(uint8_t i, Tarea *t) {
+	_cola[i] = t;
+	t->_pos = i;
+}
+
+void Planificador::subir(uint8_t i) {
+	Tarea *t = _cola[i];
+	while (i > 0) {
+		uint8_t padre = (i - 1) / 2;
+		if (!antes(t, _cola[padre])) break;
+		colocar(i, _cola[padre]);
+		i = padre;
+	}
+	colocar(i, t);
+}
+
+void Planificador::bajar(uint8_t i) {
+	Tarea *t = _cola[i];
+	for (;;) {
+		uint8_t hijo = 2 * i + 1;
+		if (hijo >= _n) break;
+		if (hijo + 1 < _n && antes(_cola[hijo + 1], _cola[hijo])) hijo++;
+		if (!antes(_cola[hijo], t)) break;
+		colocar(i, _cola[hijo]);
+		i = hijo;
+	}
+	colocar(i, t);
+}
+
+bool Planificador::programar(Tarea &t, unsigned long vence) {
+	t._vence = vence;
+	if (t._pos == PLAN_SIN_POSICION) {
+		if (_n >= PLAN_MAX_TAREAS) {
+			bitacora.evento(EV_TAREAS_LLENAS, BITACORA_ERRORES);
+			return false;
+		}
+		colocar(_n, &t);
+		_n++;
+		subir(t._pos);
+	} else {
+		// Reprogramacion: el nuevo vencimiento puede ir en cualquier sentido
+		subir(t._pos);
+		bajar(t._pos);
+	}
+	return true;
+}
+
+void Planificador::quitar(Tarea &t) {
+	if (t._pos == PLAN_SIN_POSICION) return;
+	uint8_t i = t._pos;
+	t._pos = PLAN_SIN_POSICION;
+	_n--;
+	if (i == _n) return;
+	Tarea *movida = _cola[_n];
+	colocar(i, movida);
+	subir(i);
+	bajar(movida->_pos);
+}
+
+uint8_t Planificador::Ejecutar(unsigned long ahora) {
+	uint8_t corridas = 0;
+	// Tope por pasada: una tarea de intervalo 0 no debe colgar el loop
+	while (_n > 0 && vencida(_cola[0]->_vence, ahora) && corridas < PLAN_MAX_TAREAS) {
+		Tarea &t = *_cola[0];
+		quitar(t);
+		corridas++;
+		if (t._alVencer != nullptr) {
+#ifdef SMARTCOMFORT_PERFIL
+			perfilador.tarea(t._perfil, t.Interval);
+#endif
+			PERFIL_SECCION(PERFIL_TAREA | t._perfil);
+			t._alVencer();
+		}
+		// Igual que AsyncTask: se rearma desde ahora y, sin AutoReset, se
+		// detiene (si el callback la detuvo, queda detenida)
+		if (t.AutoReset) {
+			if (t._activa) programar(t, ahora + t.Interval);
+		} else {
+			t.Stop();
+		}
+		if (t._siguiente != nullptr) t._siguiente->Start();
+	}
+	return corridas;
+}
+
+unsigned long Planificador::Espera(unsigned long ahora, unsigned long tope) const {
+	if (_n == 0) return tope;
+	if (vencida(_cola[0]->_vence, ahora)) return 0;
+	unsigned long falta = _cola[0]->_vence - ahora;
+	return falta < tope ? falta : tope;
+}
@@ -0,0 +1,80 @@
+#ifndef SMARTCOMFORT_PLANIFICADOR_H
+#define SMARTCOMFORT_PLANIFICADOR_H
+
+#include <Arduino.h>
+
+#define PLAN_MAX_TAREAS 16
+#define PLAN_SIN_POSICION 0xFF
+
+class Planificador;
+
+typedef void (*TareaCallback)();
+
+// Temporizador con la misma semantica que AsyncTask (Start/Stop, AutoReset,
+// callback al vencer), pero sin Update(): las tareas activas viven en la cola
+// por vencimiento de un Planificador, que solo toca las que vencieron.
+class Tarea {
+public:
+	Tarea(unsigned long intervalo, bool autoReset, TareaCallback alVencer);
+	Tarea(unsigned long intervalo, bool autoReset, TareaCallback alVencer, Planificador &plan);
+	
+	void Start();
+	void Stop();
+	bool IsActive() const { return _activa; }
+	
+	// Al vencer (y tras el callback) arranca 'siguiente', como hacia
+	// taskA.Update(taskB) en cada pasada del loop
+	void Encadenar(Tarea &siguiente) { _siguiente = &siguiente; }
+	
+	unsigned long Interval;
+	bool AutoReset;
+	
+private:
+	friend class Planificador;
+	
+	TareaCallback _alVencer;
+	Tarea *_siguiente;
+	Planificador &_plan;
+	unsigned long _vence;
+	uint8_t _pos;  // indice en el monticulo o PLAN_SIN_POSICION
+	bool _activa;
+#ifdef SMARTCOMFORT_PERFIL
+	uint8_t _perfil;  // orden de construccion: seccion PERFIL_TAREA | _perfil
+#endif
+};
+
+// Cola de tareas ordenada por vencimiento (monticulo minimo de tamano fijo).
+// Agregar, quitar o reprogramar cuesta O(log n); una pasada sin tareas
+// vencidas es una sola comparacion.
+class Planificador {
+public:
+	// Ejecuta las tareas vencidas; devuelve cuantas corrieron
+	uint8_t Ejecutar(unsigned long ahora);
+	
+	// Milisegundos hasta el proximo vencimiento (0 si ya hay uno vencido,
+	// 'tope' si no hay tareas activas o faltan mas de 'tope')
+	unsigned long Espera(unsigned long ahora, unsigned long tope) const;
+	
+	uint8_t Activas() const { return _n; }
+	
+private:
+	friend class Tarea;
+	
+	// false si la cola esta llena y la tarea no entro (EV_TAREAS_LLENAS)
+	bool programar(Tarea &t, unsigned long vence);
+	void quitar(Tarea &t);
+	void subir(uint8_t i);
+	void bajar(uint8_t i);
+	void colocar(uint8_t i, Tarea *t);
+	static bool antes(const Tarea *a, const Tarea *b);
+	
+	Tarea *_cola[PLAN_MAX_TAREAS];
+	uint8_t _n;
+};
+
+// Planificador del sketch (inicializado a cero en el arranque, sin
+// constructor, para que las Tarea globales puedan referirlo sin depender del
+// orden de inicializacion)
+extern Planificador planificador;
+
+#endif
@@ -0,0 +1,98 @@
+#include "Reposo.h"
+
+#ifdef __AVR__
+#include <avr/power.h>
+#include <avr/sleep.h>
+#endif
+
+// Sin constructor: arranca en cero
+Reposo reposo;
+
+static void sumar(uint32_t &ms, uint16_t &resto, unsigned long us) {
+	us += resto;
+	ms += us / 1000;
+	resto = (uint16_t)(us % 1000);
+}
+
+void Reposo::begin() {
+#ifdef __AVR__
+	power_twi_disable();
+	power_usart1_disable();
+	power_usart2_disable();
+	power_usart3_disable();
+	power_timer1_disable();
+	power_timer3_disable();
+	power_timer4_disable();
+#endif
+	_desde = micros();
+}
+
+void Reposo::dormir(uint8_t estado, unsigned long ms, Despertador despierto) {
+	EstadisticaReposo &e = _estados[estado < REPOSO_ESTADOS ? estado : REPOSO_ESTADOS - 1];
+	unsigned long desde = micros();
+	sumar(e.msActivo, e.usActivo, desde - _desde);
+	if (ms == 0 || despierto()) {
+		_desde = desde;
+		return;
+	}
+
+	bool porEntrada = false;
+#ifdef __AVR__
+	uint8_t adc = ADCSRA;
+	ADCSRA = adc & ~_BV(ADEN);
+	set_sleep_mode(SLEEP_MODE_IDLE);
+	unsigned long inicio = millis();
+	while (millis() - inicio < ms) {
+		// Con las interrupciones bloqueadas hasta sleep_cpu(), una que llegue
+		// despues de consultar no se pierde: despierta enseguida
+		noInterrupts();
+		if (despierto()) {
+			interrupts();
+			porEntrada = true;
+			break;
+		}
+		sleep_enable();
+		interrupts();
+		sleep_cpu();
+		sleep_disable();
+	}
+	ADCSRA = adc;
+#else
+	uint64_t us = (uint64_t)ms * 1000ULL;
+	porEntrada = sim::sleepMicros(us, despierto) < us;
+#endif
+
+	if (porEntrada) e.despertaresEntrada++;
+	else e.despertaresTiempo++;
+	_desde = micros();
+	sumar(e.msDormido, e.usDormido, _desde - desde);
+}
+
+void Reposo::latencia(uint8_t estado, unsigned long ms) {
+	EstadisticaReposo &e = _estados[estado < REPOSO_ESTADOS ? estado : REPOSO_ESTADOS - 1];
+	e.latencias++;
+	e.latenciaSuma += ms;
+	if (ms > e.latenciaMaxima) e.latenciaMaxima = ms > 0xFFFF ? 0xFFFF : (uint16_t)ms;
+}
+
+EstadisticaReposo Reposo::total() const {
+	EstadisticaReposo t;
+	memset(&t, 0, sizeof(t));
+	for (uint8_t i = 0; i < REPOSO_ESTADOS; i++) {
+		const EstadisticaReposo &e = _estados[i];
+		sumar(t.msActivo, t.usActivo, e.usActivo);
+		sumar(t.msDormido, t.usDormido, e.usDormido);
+		t.msActivo += e.msActivo;
+		t.msDormido += e.msDormido;
+		t.despertaresTiempo += e.despertaresTiempo;
+		t.despertaresEntrada += e.despertaresEntrada;
+		t.latencias += e.latencias;
+		t.latenciaSuma += e.latenciaSuma;
+		if (e.latenciaMaxima > t.latenciaMaxima) t.latenciaMaxima = e.latenciaMaxima;
+	}
+	return t;
+}
+
+void Reposo::reiniciar() {
+	memset(_estados, 0, sizeof(_estados));
+}
@@ -0,0 +1,84 @@
+#ifndef SMARTCOMFORT_REPOSO_H
+#define SMARTCOMFORT_REPOSO_H
+
+#include <Arduino.h>
+
+// Reposo del loop entre vencimientos. El sketch calcula cuanto puede dormir
+// (proxima tarea del planificador, proxima muestra de sensores, antirrebote
+// de Flancos.h, con un tope por estado) y dormir() detiene la CPU hasta
+// entonces o hasta que llegue una entrada: un flanco del IR o del boton, o
+// un byte por el puerto serie.
+//
+// El modo es IDLE, el mas profundo que es seguro en esta placa: en
+// POWER_SAVE o POWER_DOWN se detienen el Timer0 (millis() y el muestreo de
+// Flancos.h), el Timer5 (PWM del servo) y la USART0 (bitacora), y el Mega
+// no tiene cristal de 32 kHz para el Timer2 asincrono. Lo que si se hace es
+// apagar los perifericos que nada usa (TWI, USART1 a 3, Timer1, 3 y 4) y el
+// ADC mientras se duerme. La CPU despierta con cada interrupcion del Timer0
+// (dos por milisegundo) y vuelve a dormir si no hay nada que hacer.
+//
+// El teclado (pines 30 a 37, puerto C) no tiene interrupcion de cambio de
+// pin: en los estados que lo leen el tope es REPOSO_TOPE_SONDEO_MS, lo
+// mismo que esperaba antes el loop.
+//
+// Por estado se cuenta el tiempo activo y el dormido, los despertares por
+// tiempo y por entrada y la latencia de los flancos (de la muestra en la
+// interrupcion a su atencion en el loop). Con las corrientes de abajo se
+// estima la carga consumida por el MCU.
+#define REPOSO_ESTADOS 8
+#define REPOSO_TOPE_SONDEO_MS 10UL
+#define REPOSO_TOPE_MS 1000UL
+
+// ATmega2560 a 16 MHz y 5 V, valores tipicos de la hoja de datos; solo el
+// MCU (el regulador, el USB y el LCD de la placa consumen aparte)
+#define REPOSO_MA_ACTIVO 14.0f
+#define REPOSO_MA_DORMIDO 3.5f
+
+// true si hay una entrada por atender; se consulta en cada despertar
+typedef bool (*Despertador)();
+
+struct EstadisticaReposo {
+	uint32_t msActivo;
+	uint32_t msDormido;
+	uint16_t usActivo;           // resto de menos de 1 ms
+	uint16_t usDormido;
+	uint32_t despertaresTiempo;  // vencio la espera
+	uint32_t despertaresEntrada; // antes de tiempo, por una entrada
+	uint32_t latencias;          // flancos atendidos
+	uint32_t latenciaSuma;       // ms
+	uint16_t latenciaMaxima;     // ms
+
+	// Fraccion del tiempo con la CPU en marcha y carga estimada (mAh)
+	float cicloActivo() const {
+		uint32_t total = msActivo + msDormido;
+		return total ? (float)msActivo / (float)total : 0.0f;
+	}
+	float mAh() const {
+		return ((float)msActivo * REPOSO_MA_ACTIVO + (float)msDormido * REPOSO_MA_DORMIDO) / 3.6e6f;
+	}
+};
+
+class Reposo {
+public:
+	// Apaga los perifericos sin uso
+	void begin();
+
+	// Duerme hasta ms milisegundos o hasta que despierto() de true. El tiempo
+	// desde la vuelta anterior cuenta como activo del estado.
+	void dormir(uint8_t estado, unsigned long ms, Despertador despierto);
+
+	// Un flanco atendido ms despues de su captura
+	void latencia(uint8_t estado, unsigned long ms);
+
+	const EstadisticaReposo &estadistica(uint8_t estado) const { return _estados[estado]; }
+	EstadisticaReposo total() const;
+	void reiniciar();
+
+private:
+	EstadisticaReposo _estados[REPOSO_ESTADOS];
+	unsigned long _desde;  // micros() al volver del ultimo dormir()
+};
+
+extern Reposo reposo;
+
+#endif
@@ -0,0 +1,125 @@
+#include "Sensores.h"
+#include "Bitacora.h"
+#include "NTCTablaDatos.h"
+#include "Traza.h"
+#include "Perfilador.h"
+#include <math.h>
+
+static_assert(NTC_SOBREMUESTREO_BITS <= 4, "mas de 256 conversiones por lectura");
+
+float temperaturaNTC(int adc) {
+	float Vout = adc * (5.0f / 1023.0f);
+	float Rntc = (NTC_R_SERIE * Vout) / (5.0f - Vout);
+	float T_kelvin = 1.0f / ((1.0f / NTC_T0) + (1.0f / NTC_BETA) * log(Rntc / NTC_R0));
+	return T_kelvin - 273.15f;
+}
+
+uint16_t leerADCSobremuestreado(uint8_t pin, uint8_t bitsExtra) {
+	uint16_t n = 1u << (2 * bitsExtra);
+	uint32_t suma = 0;
+	for (uint16_t i = 0; i < n; i++) suma += analogReadTraza(pin);
+	// Diezmado con redondeo: quedan bitsExtra bits por debajo del LSB
+	if (bitsExtra == 0) return (uint16_t)suma;
+	return (uint16_t)((suma + (1ul << (bitsExtra - 1))) >> bitsExtra);
+}
+
+float temperaturaNTCTabla(uint16_t codigo, uint8_t bitsExtra) {
+	// Solo un codigo en cero o a fondo de escala es un NTC en corto o
+	// abierto; un poco antes del final de la tabla se usa la fila del borde
+	if (codigo == 0 || codigo >= (1023u << bitsExtra)) return NAN;
+	if (codigo < ((uint16_t)NTC_TABLA_PRIMER_CODIGO << bitsExtra)) {
+		return (int16_t)pgm_read_word(&ntcTabla[0]) * 0.01f;
+	}
+	if (codigo >= ((uint16_t)NTC_TABLA_ULTIMO_CODIGO << bitsExtra)) {
+		return (int16_t)pgm_read_word(&ntcTabla[NTC_TABLA_N - 1]) * 0.01f;
+	}
+	uint16_t pos = codigo - ((uint16_t)NTC_TABLA_PRIMER_CODIGO << bitsExtra);
+	uint8_t bitsPaso = NTC_TABLA_PASO_BITS + bitsExtra;
+	uint8_t i = (uint8_t)(pos >> bitsPaso);
+	int16_t frac = (int16_t)(pos & ((1u << bitsPaso) - 1));
+	int16_t a = (int16_t)pgm_read_word(&ntcTabla[i]);
+	int16_t b = (int16_t)pgm_read_word(&ntcTabla[i + 1]);
+	int32_t escalado = ((int32_t)a << bitsPaso) + (int32_t)(b - a) * frac;
+	int16_t centesimas = (int16_t)((escalado + (1l << (bitsPaso - 1))) >> bitsPaso);
+	return centesimas * 0.01f;
+}
+
+ServicioSensores::ServicioSensores(DHT &dht, uint8_t pinNTC)
+	: _dht(dht), _pinNTC(pinNTC), _ultimoDHT(0), _ultimoNTC(0), _primera(true), _nueva(false),
+	  _fallaNTC(false) {
+	_ta = { NAN, 0, 0 };
+	_rh = { NAN, 0, 0 };
+	_tr = { NAN, 0, 0 };
+}
+
+void ServicioSensores::registrar(LecturaSensor &l, float valor, unsigned long ahora) {
+	if (isnan(valor) || isinf(valor)) {
+		if (l.fallos < 255) l.fallos++;
+		return;
+	}
+	l.valor = valor;
+	l.instante = ahora;
+	l.fallos = 0;
+}
+
+bool ServicioSensores::actualizar(unsigned long ahora) {
+	bool nueva = false;
+	
+	// Un fallo del DHT se reintenta en el periodo siguiente: antes la
+	// libreria devolveria el mismo resultado cacheado
+	if (_primera || ahora - _ultimoDHT >= DHT_PERIODO_MS) {
+		_ultimoDHT = ahora;
+		PERFIL_SECCION(PERF_DHT);
+		float t = TRAZA_ENTRADA(TR_DHT, _dht.readTemperature());
+		float h = TRAZA_ENTRADA(TR_DHT, _dht.readHumidity());
+		if (!isnan(t) && !isnan(h)) nueva = true;
+		registrar(_ta, t, ahora);
+		registrar(_rh, h, ahora);
+	}
+	
+	if (_primera || ahora - _ultimoNTC >= NTC_PERIODO_MS) {
+		_ultimoNTC = ahora;
+		PERFIL_SECCION(PERF_NTC);
+		float tr = temperaturaNTCTabla(leerADCSobremuestreado(_pinNTC));
+		bool falla = isnan(tr) || isinf(tr);
+		if (!falla) nueva = true;
+		else if (!_fallaNTC) bitacora.evento(EV_FALLA_NTC, BITACORA_ERRORES);
+		_fallaNTC = falla;
+		registrar(_tr, tr, ahora);
+	}
+	
+	_primera = false;
+	if (nueva) _nueva = true;
+	return nueva;
+}
+
+bool ServicioSensores::nuevaMuestra() {
+	bool n = _nueva;
+	_nueva = false;
+	return n;
+}
+
+bool ServicioSensores::vigente(const LecturaSensor &l, unsigned long ahora) {
+	return !isnan(l.valor) && ahora - l.instante < SENSOR_VIGENCIA_MS;
+}
+
+bool ServicioSensores::vigentes(unsigned long ahora) const {
+	return vigente(_ta, ahora) && vigente(_rh, ahora);
+}
+
+float ServicioSensores::trPMV(unsigned long ahora) const {
+	return vigente(_tr, ahora) ? _tr.valor : _ta.valor;
+}
+
+static unsigned long falta(unsigned long ahora, unsigned long ultimo, unsigned long periodo) {
+	unsigned long pasado = ahora - ultimo;
+	return pasado >= periodo ? 0 : periodo - pasado;
+}
+
+unsigned long ServicioSensores::espera(unsigned long ahora, unsigned long tope) const {
+	if (_primera) return 0;
+	unsigned long f = falta(ahora, _ultimoDHT, DHT_PERIODO_MS);
+	if (f < tope) tope = f;
+	f = falta(ahora, _ultimoNTC, NTC_PERIODO_MS);
+	return f < tope ? f : tope;
+}
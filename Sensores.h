@@ -0,0 +1,96 @@
+#ifndef SMARTCOMFORT_SENSORES_H
+#define SMARTCOMFORT_SENSORES_H
+
+#include <Arduino.h>
+#include <DHT.h>
+
+// Periodos de muestreo por sensor. El DHT11 no entrega datos nuevos mas
+// rapido que cada 2 s (la libreria devuelve el ultimo resultado) y cada
+// lectura ocupa el bus ~23 ms; la sala cambia mucho mas lento, asi que se
+// lee cada 4 s. El NTC se lee por ADC, que es barato.
+#define DHT_PERIODO_MS 4000UL
+#define NTC_PERIODO_MS 1000UL
+// Un valor mas viejo que esto ya no se usa para el PMV
+#define SENSOR_VIGENCIA_MS 10000UL
+
+// Divisor del NTC: 10k en serie, NTC beta 3950 de 10k a 25 C. Con otros
+// valores hay que regenerar NTCTablaDatos.h (make -C host tabla).
+#define NTC_BETA 3950.0f
+#define NTC_R_SERIE 10.0f  // kOhm
+#define NTC_R0 10.0f       // kOhm a T0
+#define NTC_T0 298.15f
+
+// Sobremuestreo del ADC del NTC: 4^n conversiones sumadas y diezmadas dan un
+// codigo de 10 + n bits (el ruido del ADC hace de dither). Cada conversion
+// lleva ~112 us: con n = 2 son 16 conversiones (~1.8 ms) por segundo.
+#define NTC_SOBREMUESTREO_BITS 2
+#define NTC_ADC_BITS (10 + NTC_SOBREMUESTREO_BITS)
+
+// Ultimo valor valido de un sensor
+struct LecturaSensor {
+	float valor;             // NAN hasta la primera lectura valida
+	unsigned long instante;  // millis() del valor
+	uint8_t fallos;          // lecturas fallidas seguidas desde entonces
+};
+
+// Servicio central de muestreo de Ta/RH (DHT11) y Tr (NTC). Cada sensor se
+// lee a su propio ritmo desde actualizar(), que va en cada pasada del loop;
+// los fallos (NaN) no pisan el ultimo valor valido. La logica de PMV lee de
+// aqui y solo recalcula cuando nuevaMuestra() lo indica. Una falla del NTC
+// se registra en la bitacora al aparecer (EV_FALLA_NTC).
+class ServicioSensores {
+public:
+	ServicioSensores(DHT &dht, uint8_t pinNTC);
+	
+	// Muestrea lo que corresponda; true si llego algun valor nuevo
+	bool actualizar(unsigned long ahora);
+	
+	// true una vez por cada muestra nueva desde la ultima consulta
+	bool nuevaMuestra();
+	
+	// Ta y RH validos y con menos de SENSOR_VIGENCIA_MS. Tr no hace falta:
+	// sin ella el PMV sigue con trPMV()
+	bool vigentes(unsigned long ahora) const;
+	
+	// Tr para el PMV y la consigna: la del NTC si esta vigente, si no Ta
+	// (como sanearPMV con una Tr fuera de rango)
+	float trPMV(unsigned long ahora) const;
+	
+	// El NTC da un valor imposible (abierto o en corto)
+	bool fallaNTC() const { return _fallaNTC; }
+	
+	// ms hasta la proxima lectura de algun sensor, a lo sumo tope
+	unsigned long espera(unsigned long ahora, unsigned long tope) const;
+	
+	const LecturaSensor &Ta() const { return _ta; }
+	const LecturaSensor &RH() const { return _rh; }
+	const LecturaSensor &Tr() const { return _tr; }
+	
+private:
+	static void registrar(LecturaSensor &l, float valor, unsigned long ahora);
+	static bool vigente(const LecturaSensor &l, unsigned long ahora);
+	
+	DHT &_dht;
+	uint8_t _pinNTC;
+	unsigned long _ultimoDHT;
+	unsigned long _ultimoNTC;
+	bool _primera;
+	bool _nueva;
+	bool _fallaNTC;
+	LecturaSensor _ta, _rh, _tr;
+};
+
+// Temperatura del NTC (divisor con 10k en serie) a partir del valor ADC.
+// Calculo directo con log(); queda como referencia de la tabla.
+float temperaturaNTC(int adc);
+
+// Codigo de 10 + bitsExtra bits: suma de 4^bitsExtra conversiones, diezmada
+uint16_t leerADCSobremuestreado(uint8_t pin, uint8_t bitsExtra = NTC_SOBREMUESTREO_BITS);
+
+// Temperatura del NTC para un codigo de 10 + bitsExtra bits, interpolando en
+// la tabla de flash (solo enteros). Fuera de la tabla da la temperatura de
+// la fila del borde; NAN solo con el codigo en cero o a fondo de escala
+// (NTC en corto o abierto), que ServicioSensores informa como EV_FALLA_NTC
+float temperaturaNTCTabla(uint16_t codigo, uint8_t bitsExtra = NTC_SOBREMUESTREO_BITS);
+
+#endif
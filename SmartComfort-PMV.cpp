@@ -1,5 +1,4 @@
-#include "StateMachineLib.h"
-#include <AsyncTaskLib.h>
+#include "MaquinaEstados.h"
 #include <Keypad.h>
 #include <LiquidCrystal.h>
 #include <DHT.h>
@@ -8,13 +7,31 @@
 #include <SPI.h>
 #include <math.h>
 #include <EEPROM.h>
+#include "PMV.h"
+#include "EntradaClave.h"
+#include "LectorRFID.h"
+#include "Sensores.h"
+#include "Planificador.h"
+#include "TextoFijo.h"
+#include "Memoria.h"
+#include "Bitacora.h"
+#include "Pantalla.h"
+#include "Zona.h"
+#include "Historial.h"
+#include "Traza.h"
+#include "Perfilador.h"
+#include "Eventos.h"
+#include "Flancos.h"
+#include "Reposo.h"
+#ifdef SMARTCOMFORT_BENCH
+#include "PMVBench.h"
+#endif
 
 #define LED_GREEN 28
 #define LED_RED 27
 #define LED_BLUE 29
 #define BUTTON_PIN 49
 #define DHTPIN 22 
-#define DHTTYPE DHT11
 #define RELAY_PIN 25
 #define SERVO_PIN 26
 #define RST_PIN 9
@@ -22,15 +39,20 @@
 #define BUZZER_PIN 7
 #define IR_SENSOR 23
 
-DHT dht(DHTPIN, DHTTYPE);
-Servo servo;
 MFRC522 mfrc522(SS_PIN, RST_PIN);
 
 #define analogPin A0
-#define beta 3950.0
-#define resistance 10.0
-#define R0 10.0
-#define T0 298.15
+
+// Salas que atiende la placa. La primera es la del teclado, el LCD y la
+// alarma. Para sumar una sala se agrega una linea con sus pines (DHT11, NTC,
+// rele, servo): las demas se regulan solas, una por turno de taskZonas.
+Zona zonas[] = {
+	{ 0, DHTPIN, analogPin, RELAY_PIN, SERVO_PIN },
+	// { 1, 40, A1, 41, 44 },
+	// { 2, 42, A2, 43, 45 },
+};
+const uint8_t NUM_ZONAS = sizeof(zonas) / sizeof(zonas[0]);
+Zona &principal = zonas[0];
 
 const byte ROWS = 4;
 const byte COLS = 4;
@@ -48,21 +70,20 @@ byte colPins[COLS] = { 34, 35, 36, 37 };
 
 Keypad keypad = Keypad(makeKeymap(keys), rowPins, colPins, ROWS, COLS);
 MFRC522::MIFARE_Key key;
+const byte *const uidsRegistrados[] = { tarjetaUID, llaveroUID };
+LectorRFID lectorRFID(mfrc522, key, uidsRegistrados, 2);
 
 const int rs = 12, en = 11, d4 = 5, d5 = 4, d6 = 3, d7 = 2;
 LiquidCrystal lcd(rs, en, d4, d5, d6, d7);
+Pantalla pantalla(lcd);
+EntradaClave entradaClave(pantalla, 1);
 
-String clave_store = "1234";
-String inputKey = "";
-float pmv_actual = 0.0;
-int intentos_temp_alta = 0;
-float temperatura_actual = 0.0;
-bool pmv_alto_debe_salir = false;
+const char clave_store[CLAVE_LONGITUD + 1] = "1234";
 
-// Variables para manejo del sensor IR y debounce (correccin)
-unsigned long ultimo_ir_detectado = 0;
-const unsigned long IR_DEBOUNCE_TIME = 500; // 500 ms debounce razonable
+// Sensor IR y boton: los flancos los captura una interrupcion y el
+// antirrebote es de Flancos.h. El IR dispara una sola vez por deteccion.
 bool ir_armed = true; // arma para detectar slo una vez hasta que libere
+uint8_t canalBoton, canalIR;
 
 enum State { inicio,
 	Config,
@@ -81,631 +102,611 @@ enum Input { tiempo,
 	alarmaTemp,
 	sensorIR};
 
-StateMachine stateMachine(7, 13);
-Input input;
+const uint8_t NUM_ESTADOS = pmv_bajo + 1;
+const uint8_t NUM_ENTRADAS = sensorIR + 1;
 
-AsyncTask taskConfig(5000, true, []() {
-	input = tiempo;
-});
-AsyncTask taskMonitor(7000, true, []() {
-	input = tiempo;
+// Entradas pendientes de la maquina (Eventos.h); el loop las despacha
+ColaEventos eventos;
+EstadisticaEventos estadisticaEventos;
+void emitir(Input entrada);
+void vencioPmvAlto();
+
+Tarea taskConfig(5000, true, []() {
+	emitir(tiempo);
 });
-AsyncTask taskpmv_alto(5000, true, []() {
-	input = tiempo;
+Tarea taskMonitor(7000, true, []() {
+	emitir(tiempo);
 });
-AsyncTask taskpmv_bajo(3000, true, []() {
-	input = tiempo;
+Tarea taskpmv_alto(5000, true, vencioPmvAlto);
+Tarea taskpmv_bajo(3000, true, []() {
+	emitir(tiempo);
 });
-AsyncTask taskLEDBLUEON(300, false, []() {
+Tarea taskLEDBLUEON(300, false, []() {
 	digitalWrite(LED_BLUE, HIGH);
 });
-AsyncTask taskLEDBLUEOFF(400, false, []() {
+Tarea taskLEDBLUEOFF(400, false, []() {
 	digitalWrite(LED_BLUE, LOW);
 });
-AsyncTask taskLEDGREENON(200, false, []() {
+Tarea taskLEDGREENON(200, false, []() {
 	digitalWrite(LED_GREEN, HIGH);
 });
-AsyncTask taskLEDGREENOFF(300, false, []() {
+Tarea taskLEDGREENOFF(300, false, []() {
 	digitalWrite(LED_GREEN, LOW);
 });
-AsyncTask taskLEDREDON(500, false, []() {
+Tarea taskLEDREDON(500, false, []() {
 	digitalWrite(LED_RED, HIGH);
 });
-AsyncTask taskLEDREDOFF(500, false, []() {
+Tarea taskLEDREDOFF(500, false, []() {
 	digitalWrite(LED_RED, LOW);
 });
-AsyncTask taskSHORTLEDREDON(100, false, []() {
+Tarea taskSHORTLEDREDON(100, false, []() {
 	digitalWrite(LED_RED, HIGH);
 });
-AsyncTask taskSHORTLEDREDOFF(500, false, []() {
+Tarea taskSHORTLEDREDOFF(500, false, []() {
 	digitalWrite(LED_RED, LOW);
 });
-AsyncTask taskBuzzer(500, true, []() {
+Tarea taskBuzzer(500, true, []() {
 	static bool buzzerState = false;
 	buzzerState = !buzzerState;
 	digitalWrite(BUZZER_PIN, buzzerState ? HIGH : LOW);
 });
 
+// Un turno por vencimiento para las salas sin pantalla, en rueda
+Tarea taskZonas(ZONA_TURNO_MS, true, []() {
+	static uint8_t turno = 0;
+	if (NUM_ZONAS < 2) return;
+	turno = turno + 1 < NUM_ZONAS ? turno + 1 : 1;
+	Zona &z = zonas[turno];
+	if (z.regular(millisTraza())) {
+		bitacora.zona(z.id(), z.modo(), z.temperatura(), z.sensores().RH().valor, z.pmv());
+	}
+});
+
 int readInput();
-void setupStateMachine();
 void leerDatosRFID();
-void autenticarBloque(byte bloque);
-String leerBloque(byte bloque);
-bool compararUID(byte *uid, byte *referencia);
-String recibirCodigo();
-String leerStringEEPROM(int direccion);
+template <uint8_t N> bool leerTextoEEPROM(int direccion, TextoFijo<N> &destino);
 bool estaVacioEEPROM(int direccion);
 void actualizarDisplayMonitor();
+void enteringInicio();
+void enteringConfig();
+void enteringBloqueado();
+void enteringAlarma();
+void enteringMonitor();
+void enteringPMVALTO();
+void enteringPMVBAJO();
+void leavingInicio();
+void leavingConfig();
+void leavingBloqueado();
+void leavingAlarma();
+void leavingMonitor();
+void leavingPmvAlto();
+void leavingPmvBajo();
 
-struct PMVResult {
-	float pmv;
-};
-
-static inline float saturation_vapor_pressure_kPa(float T) {
-	return 0.6105f * expf((17.27f * T) / (T + 237.3f));
+// -------------------------------------------------------------
+// Maquina de estados: guardas, transiciones y acciones (MaquinaEstados.h)
+// -------------------------------------------------------------
+bool pmvAltoDetectado() { return principal.confort() > 0; }
+bool pmvBajoDetectado() { return principal.confort() < 0; }
+// Solo iremos a Alarma si se lleg por condicin de alerta (evento alarmaTemp)
+bool intentosAgotados() { return principal.intentos() >= ZONA_INTENTOS_ALARMA; }
+// Salida de pmv_alto/pmv_bajo a Monitor con cualquier evento: la sala
+// llego a la consigna del usuario o, sin tarjeta leida, el PMV volvio a la
+// banda
+bool pmvAltoNormalizado() { return principal.enfriada(); }
+bool pmvBajoNormalizado() { return principal.calentada(); }
+// Fin de un periodo de calefaccion: sin consigna vuelve siempre a Monitor a
+// medir; con consigna sigue calentando hasta alcanzarla, salvo que los
+// sensores dejen de responder
+bool calefaccionTerminada() {
+	return isnan(principal.consigna()) || principal.calentada() || !principal.sensores().vigentes(millisTraza());
 }
 
-PMVResult computePMV(float Ta, float Tr, float RH, float met, float clo, float va) {
-	if (isnan(Ta) || isnan(Tr) || isnan(RH)) {
-		return { 0.0f };
-	}
-	
-	if (Ta < -10.0f || Ta > 50.0f) Ta = 25.0f;
-	if (Tr < -10.0f || Tr > 50.0f) Tr = Ta;
-	if (RH < 0.0f) RH = 0.0f;
-	if (RH > 100.0f) RH = 100.0f;
-	if (va < 0.0f) va = 0.1f;
-	
-	const float M = met * 58.15f;
-	const float W = 0.0f;
-	
-	float p_sat = saturation_vapor_pressure_kPa(Ta);
-	float p_a = (RH / 100.0f) * p_sat * 1000.0f;
-	
-	float f_cl = (clo <= 0.078f) ? (1.05f + 0.1f * clo) : (1.0f + 0.2f * clo);
-	float I_cl = clo * 0.155f;
-	float T_cl = Ta + 0.1f;
+// Dentro de cada estado, en orden de prioridad
+constexpr Transicion transiciones[] PROGMEM = {
+	// Transiciones desde INICIO
+	{ inicio, keypadInput, Config, nullptr },
+	{ inicio, keypadBlock, Bloqueado, nullptr },
 	
-	for (int i = 0; i < 200; i++) {
-		float h_c = 12.1f * sqrtf(max(0.0001f, va));
-		float delta = fabsf(T_cl - Ta);
-		float h_c2 = 2.38f * powf(delta, 0.25f);
-		if (h_c2 > h_c) h_c = h_c2;
-		
-		float tclK = T_cl + 273.15f;
-		float trK = Tr + 273.15f;
-		float rad = 3.96e-8f * f_cl * (powf(tclK, 4.0f) - powf(trK, 4.0f));
-		
-		float T_new = 35.7f - 0.028f * (M - W) - I_cl * (rad + f_cl * h_c * (T_cl - Ta));
-		
-		if (fabsf(T_new - T_cl) < 1e-4f) {
-			T_cl = T_new;
-			break;
-		}
-		T_cl = T_new;
-	}
+	// Transiciones desde BLOQUEADO
+	{ Bloqueado, boton, inicio, nullptr },
+	{ Bloqueado, keypadInput, inicio, nullptr },
 	
-	float h_c = 12.1f * sqrtf(max(0.0001f, va));
-	float delta = fabsf(T_cl - Ta);
-	float h_c2 = 2.38f * powf(delta, 0.25f);
-	if (h_c2 > h_c) h_c = h_c2;
+	// Transiciones entre CONFIG y MONITOR
+	{ Config, tiempo, Monitor, nullptr },
+	{ Monitor, tiempo, Config, nullptr },
 	
-	float tclK = T_cl + 273.15f;
-	float trK = Tr + 273.15f;
-	float rad = 3.96e-8f * f_cl * (powf(tclK, 4.0f) - powf(trK, 4.0f));
+	// Transiciones desde MONITOR a PMV
+	{ Monitor, pmv, pmv_alto, pmvAltoDetectado },
+	{ Monitor, pmv, pmv_bajo, pmvBajoDetectado },
 	
-	float PMV_factor = 0.303f * expf(-0.036f * M) + 0.028f;
-	float PMV_balance = (M - W) 
-		- 3.05e-3f * (5733.0f - 6.99f * (M - W) - p_a) 
-		- 0.42f * ((M - W) - 58.15f)
-		- 1.7e-5f * M * (5867.0f - p_a) 
-		- 0.0014f * M * (34.0f - Ta) 
-		- rad 
-		- f_cl * h_c * (T_cl - Ta);
+	// Alarma de otra sala
+	{ Monitor, alarmaTemp, Alarma, nullptr },
 	
-	float pmv = PMV_factor * PMV_balance;
+	// Transiciones desde PMV_ALTO
+	{ pmv_alto, alarmaTemp, Alarma, intentosAgotados },
+	{ pmv_alto, ENTRADA_CUALQUIERA, Monitor, pmvAltoNormalizado },
 	
-	if (pmv > 3.0f) pmv = 3.0f;
-	if (pmv < -3.0f) pmv = -3.0f;
+	// Transiciones desde PMV_BAJO
+	{ pmv_bajo, tiempo, Monitor, calefaccionTerminada },
+	{ pmv_bajo, ENTRADA_CUALQUIERA, Monitor, pmvBajoNormalizado },
 	
-	return { pmv };
+	// Transiciones desde ALARMA
+	{ Alarma, sensorIR, inicio, nullptr },
+	{ Alarma, keypadInput, inicio, nullptr },
+};
+
+// Callbacks de entrada y salida, en el orden de State
+constexpr AccionesEstado accionesEstado[] PROGMEM = {
+	{ enteringInicio, leavingInicio },
+	{ enteringConfig, leavingConfig },
+	{ enteringBloqueado, leavingBloqueado },
+	{ enteringAlarma, leavingAlarma },
+	{ enteringMonitor, leavingMonitor },
+	{ enteringPMVALTO, leavingPmvAlto },
+	{ enteringPMVBAJO, leavingPmvBajo },
+};
+static_assert(sizeof(accionesEstado) / sizeof(accionesEstado[0]) == NUM_ESTADOS, "faltan acciones de algun estado");
+
+MAQUINA_TABLA(despachoEstados, transiciones, NUM_ESTADOS, NUM_ENTRADAS, inicio);
+MaquinaEstados<NUM_ESTADOS, NUM_ENTRADAS> maquina(transiciones, despachoEstados, accionesEstado);
+
+// Pone un evento en la cola, marcado con el estado actual. Si la cola esta
+// llena se pierde; despacharEventos() lo informa.
+void emitir(Input entrada) {
+	Evento e = { (uint8_t)entrada, maquina.estado(), (uint16_t)millis() };
+	eventos.poner(e);
+}
+
+void registrarCambioEstado(uint8_t desde, uint8_t hacia) {
+	bitacora.estado(desde, hacia);
+#ifdef SMARTCOMFORT_TRAZA
+	traza.estado(desde, hacia);
+#endif
 }
 
-float readNTCTemperature() {
-	int adc = analogRead(analogPin);
-	float Vout = adc * (5.0f / 1023.0f);
-	float Rntc = (resistance * Vout) / (5.0f - Vout);
-	float T_kelvin = 1.0f / ((1.0f / T0) + (1.0f / beta) * log(Rntc / R0));
-	return T_kelvin - 273.15f;
+// Pasa a la maquina los eventos pendientes, en orden. Sin eventos del estado
+// actual la maquina igual se actualiza (con Unknown), para las transiciones
+// con ENTRADA_CUALQUIERA que dependen solo de su guarda.
+void despacharEventos() {
+	Evento e;
+	bool despachado = false;
+	while (eventos.sacar(e)) {
+		uint8_t desde = maquina.estado();
+		if (e.estado != desde) {
+			estadisticaEventos.viejos++;
+			continue;
+		}
+		uint16_t latencia = (uint16_t)millis() - e.instante;
+		if (latencia > estadisticaEventos.latenciaMaxima) estadisticaEventos.latenciaMaxima = latencia;
+		estadisticaEventos.despachados++;
+		despachado = true;
+		if (maquina.actualizar(e.entrada)) registrarCambioEstado(desde, maquina.estado());
+	}
+	if (!despachado) {
+		uint8_t desde = maquina.estado();
+		if (maquina.actualizar(Unknown)) registrarCambioEstado(desde, maquina.estado());
+	}
+	if (eventos.desbordes() != estadisticaEventos.desbordesAvisados) {
+		estadisticaEventos.desbordesAvisados = eventos.desbordes();
+		bitacora.evento(EV_EVENTOS_PERDIDOS, BITACORA_ERRORES);
+	}
 }
 
+// Presencia en Alarma: apaga la sirena; la salida a inicio es el evento
+// sensorIR
+void detectarPresencia() {
+	bitacora.evento(EV_PRESENCIA);
+	ir_armed = false;            // desarma hasta que vuelva HIGH
+	digitalWrite(LED_RED, LOW);
+	digitalWrite(BUZZER_PIN, LOW);
+	taskBuzzer.Stop();
+}
+
+// Cambios de nivel ya filtrados (Flancos.h), en el orden en que ocurrieron
+void flancoIR(uint8_t nivel) {
+	if (nivel == HIGH) {
+		// Si el sensor vuelve a HIGH, rearmamos la deteccin futura
+		if (!ir_armed) {
+			ir_armed = true;
+			bitacora.evento(EV_IR_REARMADO);
+		}
+	} else if (ir_armed && maquina.estado() == Alarma) {
+		detectarPresencia();
+		emitir(sensorIR);
+	}
+}
+
+void flancoBoton(uint8_t nivel) {
+	if (nivel == LOW) emitir(boton);
+}
+
+// PMV con los ultimos valores del servicio de sensores; false si no hay
+// lecturas vigentes
+bool calcularPMVActual() {
+	return principal.calcularPMV(millisTraza());
+}
+
+// Una muestra de la sala principal al historial de la EEPROM
+Tarea taskHistorial(HISTORIAL_PERIODO_MS, true, []() {
+	unsigned long ahora = millisTraza();
+	const ServicioSensores &s = principal.sensores();
+	if (!s.vigentes(ahora)) return;
+	float Tr = s.trPMV(ahora);
+	float pmv = evaluarPMV(s.Ta().valor, Tr, s.RH().valor).pmv;
+	historial.registrar(Historial::muestra(ahora, s.Ta().valor, Tr, s.RH().valor, pmv, maquina.estado()));
+});
+
 void setup() {
+#ifdef SMARTCOMFORT_TRAZA
+#ifdef __AVR__
+	// Desde la primera lectura, para poder reproducir desde el arranque
+	traza.grabar();
+#endif
+	Serial.begin(traza.grabando() ? TRAZA_BAUDIOS : 9600);
+#else
 	Serial.begin(9600);
+#endif
 	pinMode(BUTTON_PIN, INPUT_PULLUP);
 	pinMode(LED_BLUE, OUTPUT);
 	pinMode(LED_RED, OUTPUT);
-	pinMode(RELAY_PIN, OUTPUT);
 	pinMode(BUZZER_PIN, OUTPUT);
 	pinMode(IR_SENSOR, INPUT);
-	digitalWrite(RELAY_PIN, LOW);
+	canalBoton = flancos.agregar(BUTTON_PIN, flancoBoton);
+	canalIR = flancos.agregar(IR_SENSOR, flancoIR);
+	flancos.begin();
 	digitalWrite(BUZZER_PIN, LOW);
-	servo.attach(SERVO_PIN);
-	servo.write(0);
 	SPI.begin();
 	mfrc522.PCD_Init();
-	lcd.begin(16, 2);
-	dht.begin();
-	Serial.println("Starting State Machine...");
-	setupStateMachine();
-	Serial.println("State Machine Started");
-	stateMachine.SetState(inicio, false, true);
+	pantalla.begin();
+	for (uint8_t i = 0; i < NUM_ZONAS; i++) zonas[i].begin();
+	// Marca el reinicio en la bitacora; el paso a inicio sale como REG_ESTADO
+	bitacora.evento(EV_ARRANQUE);
+	maquina.iniciar(inicio);
 	for (byte i = 0; i < 6; i++) key.keyByte[i] = 0xFF;
+	
+	// Parpadeos: cada mitad arranca a la otra al vencer
+	taskLEDBLUEON.Encadenar(taskLEDBLUEOFF);
+	taskLEDBLUEOFF.Encadenar(taskLEDBLUEON);
+	taskLEDGREENON.Encadenar(taskLEDGREENOFF);
+	taskLEDGREENOFF.Encadenar(taskLEDGREENON);
+	taskLEDREDON.Encadenar(taskLEDREDOFF);
+	taskLEDREDOFF.Encadenar(taskLEDREDON);
+	taskSHORTLEDREDON.Encadenar(taskSHORTLEDREDOFF);
+	taskSHORTLEDREDOFF.Encadenar(taskSHORTLEDREDON);
+	
+	// Las salas sin pantalla se regulan siempre, aun sin usuario
+	if (NUM_ZONAS > 1) taskZonas.Start();
+	
+	// El historial sigue en la pagina siguiente a la del ultimo arranque
+	historial.begin();
+	taskHistorial.Start();
+#ifdef SMARTCOMFORT_PERFIL
+	perfilador.pmv(&principal.pmvIncremental().estadistica());
+	perfilador.reposo(&reposo);
+#endif
+	
+	// Lo que quede reservado aqui es todo el heap: el loop no usa String
+	muestrearHeap();
+	bitacora.heap(heapUsado());
+#ifdef SMARTCOMFORT_BENCH
+	benchmarkSolverPMV(Serial, micros, 1);
+	benchmarkReferenciaISO(Serial);
+	benchmarkMotoresPMV(Serial, micros, 1);
+	benchmarkPMVIncremental(Serial, micros, 600);
+	benchmarkConsignaPMV(Serial, micros, 120);
+	benchmarkPlanificador(Serial, micros, 200);
+	benchmarkMaquinaEstados(Serial, micros, 200);
+	benchmarkNTC(Serial, micros, 1);
+	benchmarkRuidoNTC(Serial, analogPin, 50);
+#endif
+	reposo.begin();
+}
+
+// Tope del reposo por estado, en el orden de State. Los que leen el
+// teclado o el RFID los sondean cada 10 ms, como antes; los demas solo
+// esperan tareas, sensores y flancos.
+const unsigned long topeReposo[] = {
+	REPOSO_TOPE_SONDEO_MS,  // inicio: clave
+	REPOSO_TOPE_SONDEO_MS,  // Config: tarjeta
+	REPOSO_TOPE_SONDEO_MS,  // Bloqueado: '*'
+	REPOSO_TOPE_SONDEO_MS,  // Alarma: '#'
+	REPOSO_TOPE_MS,         // Monitor
+	REPOSO_TOPE_MS,         // pmv_alto
+	REPOSO_TOPE_MS,         // pmv_bajo
+};
+static_assert(sizeof(topeReposo) / sizeof(topeReposo[0]) == NUM_ESTADOS, "falta el tope de algun estado");
+static_assert(NUM_ESTADOS <= REPOSO_ESTADOS, "Reposo no cuenta todos los estados");
+
+// Cuanto puede dormir el loop: hasta la proxima tarea, la proxima lectura
+// de la sala principal o el fin de un antirrebote, con el tope del estado.
+// Con salida a medias (LCD, bitacora, EEPROM, volcados) sigue a 10 ms.
+unsigned long esperaLoop(unsigned long ahora) {
+	bool ocupado = !pantalla.alDia() || bitacora.pendientes() > 0 || historial.ocupado();
+#ifdef SMARTCOMFORT_PERFIL
+	ocupado = ocupado || perfilador.volcando();
+#endif
+	unsigned long tope = ocupado ? REPOSO_TOPE_SONDEO_MS : topeReposo[maquina.estado()];
+	tope = principal.sensores().espera(ahora, tope);
+	tope = flancos.espera(ahora, tope);
+	return planificador.Espera(ahora, tope);
+}
+
+// Lo que despierta al loop antes de tiempo (o no lo deja dormir: los
+// eventos que pusieron las tareas de esta pasada)
+bool hayEntradas() {
+	return !eventos.vacia() || flancos.pendientes() || Serial.available() > 0;
 }
 
 void loop() {
-	// readInput devuelve el Input detectado (o Unknown)
-	Input newInput = static_cast<Input>(readInput());
+	PERFIL_SECCION(PERF_LOOP);
 	
-	// Solo actualizamos si hay evento vlido
-	if (newInput != Unknown) {
-		input = newInput;
+	// Sensores a su propio ritmo; el resto del loop lee los valores cacheados
+	if (principal.actualizarSensores(millisTraza())) {
+		const ServicioSensores &sensores = principal.sensores();
+		bitacora.muestra(sensores.Ta().valor, sensores.RH().valor, sensores.Tr().valor);
 	}
 	
-	// Actualiza la mquina
-	stateMachine.Update();
-	
-	// Si hubo cambio de estado, limpiamos input para evitar doble procesado
-	static State prevState = inicio;
-	State currentState = stateMachine.GetState();
-	if (currentState != prevState) {
-		Serial.print("CAMBIO DE ESTADO: ");
-		Serial.print(prevState);
-		Serial.print(" -> ");
-		Serial.println(currentState);
-		prevState = currentState;
-		input = Unknown;
+	// Solo se registra si el heap supera su maximo (no deberia pasar en regimen)
+	if (muestrearHeap()) bitacora.heap(heapMaximo());
+	
+	// Desde el monitor serie: verbosidad de la bitacora ('0' a '3'),
+	// volcado del historial ('H') y del perfilado ('P'; 'p' lo reinicia)
+	if (TRAZA_ENTRADA(TR_SERIE, Serial.available()) > 0) {
+		int c = TRAZA_ENTRADA(TR_SERIE, Serial.read());
+		if (c >= '0' && c <= '0' + BITACORA_DETALLE) bitacora.nivel(c - '0');
+		else if (c == 'H') historial.volcar();
+#ifdef SMARTCOMFORT_PERFIL
+		else if (c == 'P') perfilador.volcar();
+		else if (c == 'p') {
+			perfilador.reiniciar();
+			reposo.reiniciar();
+		}
+#endif
 	}
 	
-	// Actualizamos tareas asncronas (mantn orden similar al original)
-	taskConfig.Update();
-	taskMonitor.Update();
-	taskpmv_alto.Update();
-	taskpmv_bajo.Update();
-	taskLEDBLUEON.Update(taskLEDBLUEOFF);
-	taskLEDBLUEOFF.Update(taskLEDBLUEON);
-	taskLEDGREENON.Update(taskLEDGREENOFF);
-	taskLEDGREENOFF.Update(taskLEDGREENON);
-	taskLEDREDON.Update(taskLEDREDOFF);
-	taskLEDREDOFF.Update(taskLEDREDON);
-	taskSHORTLEDREDON.Update(taskSHORTLEDREDOFF);
-	taskSHORTLEDREDOFF.Update(taskSHORTLEDREDON);
-	taskBuzzer.Update();
-	
-	// Pequeo delay no crtico para estabilidad del loop (10 ms)
-	delay(10);
-}
-
-void setupStateMachine() {
-	// Transiciones desde INICIO
-	stateMachine.AddTransition(inicio, Config, []() {
-		return input == keypadInput;
-	});
-	stateMachine.AddTransition(inicio, Bloqueado, []() {
-		return input == keypadBlock;
-	});
+	// readInput devuelve el Input detectado (o Unknown); va a la cola detras
+	// de los vencimientos de las tareas de la pasada anterior
+	Input leida = static_cast<Input>(readInput());
+	if (leida != Unknown) emitir(leida);
 	
-	// Transiciones desde BLOQUEADO
-	stateMachine.AddTransition(Bloqueado, inicio, []() {
-		return input == boton;
-	});
-	stateMachine.AddTransition(Bloqueado, inicio, []() {
-		return input == keypadInput;
-	});
+	// La mquina consume los eventos; los de un estado anterior se descartan
+	{
+		PERFIL_SECCION(PERF_MAQUINA);
+		despacharEventos();
+	}
+#ifdef SMARTCOMFORT_PERFIL
+	perfilador.estado(maquina.estado());
+#endif
+	
+	// Tareas asncronas: solo corren las vencidas (ver Planificador.h)
+	{
+		PERFIL_SECCION(PERF_TAREAS);
+		planificador.Ejecutar(millisTraza());
+	}
 	
-	// Transiciones entre CONFIG y MONITOR
-	stateMachine.AddTransition(Config, Monitor, []() {
-		return input == tiempo;
-	});
-	stateMachine.AddTransition(Monitor, Config, []() {
-		return input == tiempo;
-	});
+	// La CPU duerme hasta el proximo vencimiento o una entrada (Reposo.h)
+	{
+		PERFIL_SECCION(PERF_ESPERA);
+		reposo.dormir(maquina.estado(), esperaLoop(millisTraza()), hayEntradas);
+	}
 	
-	// Transiciones desde MONITOR a PMV
-	stateMachine.AddTransition(Monitor, pmv_alto, []() {
-		return input == pmv && pmv_actual > 1.0f;
-	});
-	stateMachine.AddTransition(Monitor, pmv_bajo, []() {
-		return input == pmv && pmv_actual < -1.0f;
-	});
+	// Un byte del historial a la EEPROM (o un bloque del volcado)
+	historial.servicio();
 	
-	// Transiciones desde PMV_ALTO
-	stateMachine.AddTransition(pmv_alto, Alarma, []() {
-		// Solo iremos a Alarma si se lleg por condicin de alerta (se usa input alarmaTemp)
-		return input == alarmaTemp && intentos_temp_alta >= 3;
-	});
+#ifdef SMARTCOMFORT_TRAZA
+	traza.servicio();
+#endif
 	
-	// --- CORRECCIN ---
-	// Salida de pmv_alto a Monitor basada en pmv_actual (no depender nicamente de 'input')
-	stateMachine.AddTransition(pmv_alto, Monitor, []() {
-		return pmv_actual <= 1.00f;
-	});
+#ifdef SMARTCOMFORT_PERFIL
+	perfilador.servicio();
+#endif
 	
-	// Transiciones desde PMV_BAJO
-	stateMachine.AddTransition(pmv_bajo, Monitor, []() {
-		return input == tiempo || pmv_actual >= -1.00f;
-	});
+	// La bitacora sale por el puerto sin esperarlo
+	{
+		PERFIL_SECCION(PERF_BITACORA);
+		bitacora.drenar();
+	}
 	
-	// Transiciones desde ALARMA
-	stateMachine.AddTransition(Alarma, inicio, []() {
-		return input == sensorIR;
-	});
-	
-	stateMachine.AddTransition(Alarma, inicio, []() {
-		return input == keypadInput;
-	});
-	
-	// Configurar callbacks de entrada a estados
-	stateMachine.SetOnEntering(inicio, enteringInicio);
-	stateMachine.SetOnEntering(Config, enteringConfig);
-	stateMachine.SetOnEntering(Bloqueado, enteringBloqueado);
-	stateMachine.SetOnEntering(Alarma, enteringAlarma);
-	stateMachine.SetOnEntering(Monitor, enteringMonitor);
-	stateMachine.SetOnEntering(pmv_alto, enteringPMVALTO);
-	stateMachine.SetOnEntering(pmv_bajo, enteringPMVBAJO);
-	
-	// Configurar callbacks de salida de estados
-	stateMachine.SetOnLeaving(inicio, leavingInicio);
-	stateMachine.SetOnLeaving(Config, leavingConfig);
-	stateMachine.SetOnLeaving(Bloqueado, leavingBloqueado);
-	stateMachine.SetOnLeaving(Alarma, leavingAlarma);
-	stateMachine.SetOnLeaving(Monitor, leavingMonitor);
-	stateMachine.SetOnLeaving(pmv_alto, leavingPmvAlto);
-	stateMachine.SetOnLeaving(pmv_bajo, leavingPmvBajo);
+	// Al LCD solo lo que cambio, unos pocos bytes por pasada
+	{
+		PERFIL_SECCION(PERF_PANTALLA);
+		pantalla.refrescar();
+	}
 }
 
+// Avanza un paso del lector RFID y atiende la lectura cuando termina
 void leerDatosRFID() {
-	if (!mfrc522.PICC_IsNewCardPresent()) return;
-	if (!mfrc522.PICC_ReadCardSerial()) return;
-	byte bloqueNombre = 4;
-	byte bloqueTemp = 5;
-	
-	Serial.print(F("\nUID detectado: "));
-	for (byte i = 0; i < mfrc522.uid.size; i++) {
-		Serial.print(mfrc522.uid.uidByte[i] < 0x10 ? " 0" : " ");
-		Serial.print(mfrc522.uid.uidByte[i], HEX);
+	LectorRFID::Evento evento = lectorRFID.actualizar(millisTraza());
+	if (evento != LectorRFID::Ninguno) {
+		bitacora.tarjeta(evento == LectorRFID::Registrada, lectorRFID.uid().uidByte);
 	}
-	Serial.println();
-	
-	if (compararUID(mfrc522.uid.uidByte, tarjetaUID)) {
-		String nombre = leerBloque(bloqueNombre);
-		String temp = leerBloque(bloqueTemp);
-		Serial.print(F("Bienvenido "));
-		Serial.println(nombre);
-		Serial.print(F("Temperatura preferida: "));
-		Serial.println(temp);
+	if (evento == LectorRFID::Registrada) {
+		bitacora.perfil(lectorRFID.nombre(), lectorRFID.temperatura());
+		// La temperatura preferida pasa a ser el objetivo de la sala
+		principal.fijarObjetivo(objetivoPreferido(atof(lectorRFID.temperatura())));
 		taskConfig.Start();
-		lcd.clear();
-		lcd.setCursor(0, 0);
-		lcd.print(nombre);
-		lcd.setCursor(0, 1);
-		lcd.print("Temp pref:");
-		lcd.print(temp);
-		
+		pantalla.clear();
+		pantalla.setCursor(0, 0);
+		pantalla.print(lectorRFID.nombre());
+		pantalla.setCursor(0, 1);
+		pantalla.print("Temp pref:");
+		pantalla.print(lectorRFID.temperatura());
 	} 
-	else if (compararUID(mfrc522.uid.uidByte, llaveroUID)) {
-		String nombre = leerBloque(bloqueNombre);
-		String temp = leerBloque(bloqueTemp);
-		Serial.print(F("Bienvenido "));
-		Serial.println(nombre);
-		Serial.print(F("Temperatura preferida: "));
-		Serial.println(temp);
-		taskConfig.Start();
-		lcd.clear();
-		lcd.setCursor(0, 0);
-		lcd.print(nombre);
-		lcd.setCursor(0, 1);
-		lcd.print("Temp pref:");
-		lcd.print(temp);
-	} 
-	else {
-		Serial.println(F("UID desconocido ? no registrado"));
-		lcd.clear();
-		lcd.setCursor(0, 0);
-		lcd.print("Tarjeta no");
-		lcd.setCursor(0, 1);
-		lcd.print("reconocida");
-	}
-	mfrc522.PICC_HaltA();
-	mfrc522.PCD_StopCrypto1();
-	delay(2000);
-}
-
-void autenticarBloque(byte bloque) {
-	byte sectorTrailer = bloque - (bloque % 4) + 3;
-	MFRC522::StatusCode status;
-	status = (MFRC522::StatusCode) mfrc522.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A,
-															sectorTrailer, &key, &(mfrc522.uid));
-	if (status != MFRC522::STATUS_OK) {
-		Serial.print(F("Error de autenticacin en bloque "));
-		Serial.print(bloque);
-		Serial.print(F(": "));
-		Serial.println(mfrc522.GetStatusCodeName(status));
+	else if (evento == LectorRFID::Desconocida) {
+		pantalla.clear();
+		pantalla.setCursor(0, 0);
+		pantalla.print("Tarjeta no");
+		pantalla.setCursor(0, 1);
+		pantalla.print("reconocida");
 	}
 }
 
-String leerBloque(byte bloque) {
-	autenticarBloque(bloque);
-	byte buffer[18];
-	byte size = sizeof(buffer);
-	MFRC522::StatusCode status = (MFRC522::StatusCode)mfrc522.MIFARE_Read(bloque, buffer, &size);
-	
-	if (status != MFRC522::STATUS_OK) {
-		Serial.print(F("Error leyendo bloque "));
-		Serial.println(bloque);
-		return "";
+// -------------------------------------------------------------
+// readInput (con correcciones para pmv_alto y Alarma): cada estado tiene su
+// lector de entradas, elegido por indice como las celdas de la maquina
+// -------------------------------------------------------------
+
+// Estado Alarma: la presencia que llega con la alarma sonando la emite
+// flancoIR; aqui, la de alguien que ya estaba al entrar
+Input leerAlarma(char key) {
+	if (ir_armed && flancos.nivel(canalIR) == LOW) {
+		detectarPresencia();
+		return Input::sensorIR;
 	}
 	
-	String data = "";
-	for (int i = 0; i < 16; i++) {
-		if (buffer[i] == 0) break;
-		data += (char)buffer[i];
+	// tambin aceptar '#' para salir
+	if (key == '#') {
+		bitacora.evento(EV_TECLA_NUMERAL);
+		// Apagar sirena/leds
+		digitalWrite(LED_RED, LOW);
+		digitalWrite(BUZZER_PIN, LOW);
+		taskBuzzer.Stop();
+		taskSHORTLEDREDON.Stop();
+		taskSHORTLEDREDOFF.Stop();
+		return Input::keypadInput;
 	}
-	return data;
+	
+	return Input::Unknown;
 }
 
-bool compararUID(byte *uid, byte *referencia) {
-	for (byte i = 0; i < 4; i++) {
-		if (uid[i] != referencia[i]) return false;
+// Estado inicio: la clave avanza una tecla por pasada, sin frenar el loop.
+// Si vence el plazo, en la pasada siguiente se vuelve a pedir.
+Input leerInicio(char key) {
+	if (!entradaClave.activa()) entradaClave.iniciar(millisTraza());
+	if (entradaClave.procesar(key, millisTraza()) == EntradaClave::Completa) {
+		if (entradaClave.coincide(clave_store))
+			return Input::keypadInput;
+		else
+			return Input::keypadBlock;
 	}
-	return true;
+	return Input::Unknown;
 }
 
-String recibirCodigo() {
-	lcd.setCursor(0, 1);
-	lcd.print("Clave: []     ");
-	lcd.setCursor(7, 1);
-	String result = "";
-	unsigned long startTime = millis();
-	
-	while (result.length() < 4 && (millis() - startTime) < 15000) {
-		char key = keypad.getKey();
-		if (key) {
-			if (key >= '0' && key <= '9') {
-				lcd.print('*');
-				result += key;
-			} else if (key == '*' && result.length() > 0) {
-				result = result.substring(0, result.length() - 1);
-				lcd.setCursor(7, 1);
-				for (int i = 0; i < result.length(); i++) lcd.print('*');
-				for (int i = result.length(); i < 4; i++) lcd.print(' ');
-				lcd.setCursor(7 + result.length(), 1);
-			}
-		}
-		delay(50);
+// Estado Bloqueado (el boton lo emite flancoBoton)
+Input leerBloqueado(char key) {
+	if (key == '*') {
+		bitacora.evento(EV_TECLA_ASTERISCO);
+		return Input::keypadInput;
 	}
-	
-	if (result.length() < 4) return "";
-	return result;
+	return Input::Unknown;
 }
 
-// -------------------------------------------------------------
-// readInput (con correcciones para pmv_alto y Alarma)
-// -------------------------------------------------------------
-int readInput() {
-	State currentState = stateMachine.GetState();
-	char key = keypad.getKey();
-	
-	// Estado Alarma - DEBOUNCE / REARM (CORRECCIN)
-	if (currentState == Alarma) {
-		int presencia = digitalRead(IR_SENSOR);
-		unsigned long now = millis();
-		
-		// Si presencia (LOW) y estamos armados y pas debounce -> desencadenar una vez
-		if (presencia == LOW && ir_armed && (now - ultimo_ir_detectado > IR_DEBOUNCE_TIME)) {
-			Serial.println("=== PRESENCIA DETECTADA - TRANSICION A INICIO ===");
-			ultimo_ir_detectado = now;
-			ir_armed = false;            // desarma hasta que vuelva HIGH
-			// Apagar todo lo relacionado a ALARMA (buzzer/leds) ya aqu por seguridad
-			digitalWrite(LED_RED, LOW);
-			digitalWrite(BUZZER_PIN, LOW);
-			taskBuzzer.Stop();
-			//taskSHORTLEDREDON.Stop();
-			//taskSHORTLEDREDOFF.Stop();
-			return Input::sensorIR;
-		}
-		
-		// Si el sensor vuelve a HIGH, rearmamos la deteccin futura
-		if (presencia == HIGH && !ir_armed) {
-			ir_armed = true;
-			Serial.println("=== SENSOR IR LIBERADO - REARMADO ===");
-		}
-		
-		// tambin aceptar '#' para salir
-		if (key == '#') {
-			Serial.println("=== TECLA # PRESIONADA - TRANSICION A INICIO ===");
-			// Apagar sirena/leds
-			digitalWrite(LED_RED, LOW);
-			digitalWrite(BUZZER_PIN, LOW);
-			taskBuzzer.Stop();
-			taskSHORTLEDREDON.Stop();
-			taskSHORTLEDREDOFF.Stop();
-			return Input::keypadInput;
-		}
-		
-		return Input::Unknown;
-	}
-	
-	// Estado inicio
-	if (currentState == inicio) {
-		String codigo = recibirCodigo();
-		if (codigo.length() == 4) {
-			if (codigo == clave_store)
-				return Input::keypadInput;
-			else
-				return Input::keypadBlock;
-		}
+// Estado Config (el fin del plazo lo emite taskConfig)
+Input leerConfig(char key) {
+	leerDatosRFID();  
+	return Input::Unknown;
+}
+
+// Estado pmv_alto: al vencer taskpmv_alto se recalcula y se decide. La
+// salida a Monitor la dispara la guarda pmvAltoNormalizado con cualquier
+// evento; a Alarma, el evento alarmaTemp.
+void vencioPmvAlto() {
+	bitacora.evento(EV_TIMER_PMV_ALTO, BITACORA_PMV);
+	
+	// Ultimas lecturas del servicio de sensores; la regla de los intentos
+	// es la misma para todas las salas (Zona::evaluarEnfriamiento)
+	Zona::Evaluacion ev = principal.evaluarEnfriamiento(millisTraza());
+	if (ev == Zona::SIN_LECTURAS) {
+		bitacora.evento(EV_LECTURAS_NAN, BITACORA_ERRORES);
+		return;  // la tarea se rearma sola
 	}
 	
-	// Estado Bloqueado
-	if (currentState == Bloqueado) {
-		
-		if (key == '*') {
-			Serial.println("Tecla '*' presionada - Volviendo a INICIO");
-			return Input::keypadInput;
-		}
-	}
+	bitacora.pmv(pmv_alto, principal.temperatura(), principal.sensores().RH().valor, principal.pmv());
 	
-	// Estado Config
-	if (currentState == Config) {
-		leerDatosRFID();  
-		if (input == tiempo) {
-			return Input::tiempo;
-		}
-	}
+	// Ya en la banda pero sobre la consigna: se sigue enfriando sin contar
+	if (ev == Zona::ACERCANDO) return;
 	
-	// Estado pmv_alto - SOLUCIN CORREGIDA: recalcula y decide salida
-	if (currentState == pmv_alto) {
-		if (input == tiempo) {
-			Serial.println(">>> Timer pmv_alto disparado - Leyendo sensores");
-			
-			// Leer sensores
-			float Ta = dht.readTemperature();
-			float RH = dht.readHumidity();
-			float Tr = readNTCTemperature();
-			
-			if (isnan(Ta) || isnan(RH)) {
-				Serial.println("ERROR: Lecturas NaN - Reintentando");
-				input = Unknown;
-				taskpmv_alto.Start();
-				return Input::Unknown;
-			}
-			
-			temperatura_actual = Ta;
-			PMVResult res = computePMV(Ta, Tr, RH, 1.0f, 0.61f, 0.1f);
-			pmv_actual = res.pmv;
-			
-			Serial.print("PMV_ALTO -> T:");
-			Serial.print(Ta);
-			Serial.print("C | RH:");
-			Serial.print(RH);
-			Serial.print("% | PMV:");
-			Serial.println(pmv_actual);
-			
-			// Limpiar input inmediatamente despus de leer
-			input = Unknown;
-			
-			// Si PMV se normaliz, detener timer y marcar salida a Monitor
-			if (pmv_actual <= 1.00f) { // margen por precisin
-				Serial.println("PMV NORMALIZADO - PREPARANDO SALIDA A MONITOR");
-				taskpmv_alto.Stop();
-				intentos_temp_alta = 0;
-				pmv_alto_debe_salir = true; // flag: en next loop se har la transicin
-				return Input::Unknown;      // la transicin se hace por condicin en stateMachine
-			}
-			
-			// Si sigue alto, contar solo si temp>22
-			if (temperatura_actual >= 21.0f) {
-				intentos_temp_alta++;
-				Serial.print("Intento ");
-				Serial.print(intentos_temp_alta);
-				Serial.println("/3 - PMV continua alto");
-				
-				if (intentos_temp_alta >= 3) {
-					Serial.println("ALARMA: 3 intentos agotados - TRANSICION A ALARMA");
-					taskpmv_alto.Stop();
-					return Input::alarmaTemp;
-				}
-			} else {
-				Serial.println("Temperatura <=22 -> reseteo contador");
-				intentos_temp_alta = 0;
-			}
-			
-			// Reiniciar timer para otro ciclo
-			taskpmv_alto.Start();
-			return Input::Unknown;
-		}
-		
-		// Si pmv_alto_debe_salir fue marcado (pmv normalizado), devolver Unknown y
-		// la transicin pmv_alto->Monitor depende de pmv_actual <= 0.22 en setupStateMachine.
-		return Input::Unknown;
+	// Si PMV se normaliz, detener timer: la transicin a Monitor es de la
+	// guarda, en la prxima pasada
+	if (ev == Zona::NORMALIZADO) {
+		bitacora.evento(EV_PMV_NORMALIZADO);
+		taskpmv_alto.Stop();
+		return;
 	}
 	
-	// Estado pmv_bajo
-	if (currentState == pmv_bajo) {
-		if (input == tiempo) {
-			taskpmv_bajo.Start();
-			return Input::tiempo;
-		}
-		
-		float Ta = dht.readTemperature();
-		float RH = dht.readHumidity();
-		float Tr = readNTCTemperature();
-		temperatura_actual = Ta;
+	// Si sigue alto, solo cuenta con la sala templada
+	if (ev == Zona::REINICIADO) {
+		bitacora.evento(EV_CONTADOR_RESETEADO);
+	} else {
+		bitacora.intentos(principal.intentos());
 		
-		if (!isnan(Ta) && !isnan(RH)) {
-			PMVResult res = computePMV(Ta, Tr, RH, 1.0f, 0.61f, 0.1f);
-			pmv_actual = res.pmv;
-			
-			if (pmv_actual >= -1.0f) {
-				Serial.print("PMV normalizado en estado BAJO: ");
-				Serial.println(pmv_actual);
-				return Input::tiempo;
-			}
+		if (ev == Zona::AGOTADO) {
+			bitacora.evento(EV_INTENTOS_AGOTADOS);
+			taskpmv_alto.Stop();
+			emitir(alarmaTemp);
 		}
 	}
-	
-	// Estado Monitor
-	if (currentState == Monitor) {
-		if (input == tiempo) {
+}
+
+// Estado pmv_alto: sin entradas propias
+Input leerPmvAlto(char key) {
+	return Input::Unknown;
+}
+
+// Estado pmv_bajo (el fin de cada periodo lo emite taskpmv_bajo)
+Input leerPmvBajo(char key) {
+	// Solo se recalcula cuando llega una muestra nueva
+	if (principal.sensores().nuevaMuestra() && calcularPMVActual()) {
+		bitacora.pmv(pmv_bajo, principal.temperatura(), principal.sensores().RH().valor, principal.pmv());
+		if (principal.calentada()) {
+			bitacora.evento(EV_PMV_NORMALIZADO);
 			return Input::tiempo;
 		}
-		
-		float Ta = dht.readTemperature();
-		float RH = dht.readHumidity();
-		float Tr = readNTCTemperature();
-		temperatura_actual = Ta;
-		
-		if (!isnan(Ta) && !isnan(RH)) {
-			PMVResult res = computePMV(Ta, Tr, RH, 1.0f, 0.61f, 0.1f);
-			pmv_actual = res.pmv;
-			
-			Serial.print("Monitor - Temp: ");
-			Serial.print(Ta);
-			Serial.print("C, PMV: ");
-			Serial.println(pmv_actual);
-			
-			// Detectar PMV alto o bajo para hacer transicin
-			if (pmv_actual > 1.0f) {
-				return Input::pmv;
-			}
-			if (pmv_actual < -1.0f) {
-				return Input::pmv;
-			}
-		}
+	}
+	return Input::Unknown;
+}
+
+// Estado Monitor (el paso a Config lo emite taskMonitor)
+Input leerMonitor(char key) {
+	// Otra sala agoto sus intentos: la alarma es una sola para todas
+	for (uint8_t i = 1; i < NUM_ZONAS; i++) {
+		if (zonas[i].modo() == Zona::ALARMA) return Input::alarmaTemp;
 	}
 	
-	int boton = digitalRead(BUTTON_PIN);
-	if (boton == LOW) {
-		delay(50);
-		if (digitalRead(BUTTON_PIN) == LOW) {
-			return Input::boton;
+	if (principal.sensores().nuevaMuestra() && calcularPMVActual()) {
+		bitacora.pmv(Monitor, principal.temperatura(), principal.sensores().RH().valor, principal.pmv());
+		actualizarDisplayMonitor();
+		
+		// Detectar PMV alto o bajo para hacer transicin
+		if (principal.confort() != 0) {
+			return Input::pmv;
 		}
 	}
-	
 	return Input::Unknown;
 }
 
-String leerStringEEPROM(int direccion) {
-	char caracter;
-	String data = "";
-	int i = 0;
-	while (true) {
-		caracter = EEPROM.read(direccion + i);
-		if (caracter == '\0' || caracter == 0xFF) break;
-		data += caracter;
-		i++;
+// En el orden de State
+typedef Input (*LectorEntrada)(char key);
+const LectorEntrada lectoresEntrada[] = {
+	leerInicio,
+	leerConfig,
+	leerBloqueado,
+	leerAlarma,
+	leerMonitor,
+	leerPmvAlto,
+	leerPmvBajo,
+};
+static_assert(sizeof(lectoresEntrada) / sizeof(lectoresEntrada[0]) == NUM_ESTADOS, "falta el lector de algun estado");
+
+int readInput() {
+	PERFIL_SECCION(PERF_ENTRADA);
+	// Flancos del IR y del boton capturados desde la pasada anterior
+	if (flancos.servicio(millisTraza()) > 0) reposo.latencia(maquina.estado(), flancos.latencia());
+	char key = TRAZA_ENTRADA(TR_TECLA, keypad.getKey());
+	return lectoresEntrada[maquina.estado()](key);
+}
+
+// Lee un texto terminado en '\0' (o en una celda borrada, 0xFF) a un buffer
+// fijo; devuelve false si no cabia entero y se trunco en N caracteres
+template <uint8_t N>
+bool leerTextoEEPROM(int direccion, TextoFijo<N> &destino) {
+	destino.limpiar();
+	for (int i = direccion; i < (int)EEPROM.length(); i++) {
+		byte caracter = EEPROM.read(i);
+		if (caracter == '\0' || caracter == 0xFF) return true;
+		if (!destino.agregar((char)caracter)) return false;
 	}
-	return data;
+	return true;
 }
 
 bool estaVacioEEPROM(int direccion) {
@@ -714,28 +715,23 @@ bool estaVacioEEPROM(int direccion) {
 }
 
 void leavingInicio() {
-	Serial.println("Leaving INICIO");
-	inputKey = "";
-	intentos_temp_alta = 0;
+	entradaClave.cancelar();
+	principal.reiniciarIntentos();
 }
 
 void leavingConfig() {
-	Serial.println("Leaving CONFIG");
-	
 	taskConfig.Stop();
-	input = Unknown;
+	lectorRFID.reiniciar();
 }
 
 void leavingBloqueado() {
-	Serial.println("Leaving BLOQUEADO");
 	taskLEDREDON.Stop();
 	taskLEDREDOFF.Stop();
 	digitalWrite(LED_RED, LOW);
 }
 
 void leavingAlarma() {
-	Serial.println("Leaving ALARMA");
-	intentos_temp_alta = 0;
+	principal.reiniciarIntentos();
 	digitalWrite(LED_RED, LOW);
 	taskSHORTLEDREDON.Stop();
 	taskSHORTLEDREDOFF.Stop();
@@ -744,18 +740,17 @@ void leavingAlarma() {
 	
 	// Resetear estado del sensor IR al salir de alarma
 	ir_armed = true;
-	ultimo_ir_detectado = 0;
+	
+	// Quien apaga la alarma la reconoce en todas las salas
+	for (uint8_t i = 1; i < NUM_ZONAS; i++) zonas[i].reconocerAlarma(millisTraza());
 }
 
 void leavingMonitor() {
-	Serial.println("Leaving MONITOR");
 	taskMonitor.Stop();
-	input = Unknown;
 }
 
 void leavingPmvAlto() {
-	Serial.println("Leaving PMV_ALTO");
-	digitalWrite(RELAY_PIN, LOW);
+	principal.enfriar(false);
 	digitalWrite(LED_RED, LOW);
 	taskpmv_alto.Stop();
 	taskLEDBLUEON.Stop();
@@ -763,142 +758,115 @@ void leavingPmvAlto() {
 	//taskSHORTLEDREDOFF.Stop();
 	
 	// Solo resetear contador si NO vamos a Alarma
-	if (input != alarmaTemp) {
-		intentos_temp_alta = 0;
-		Serial.println("Contador de temperatura alta reseteado");
+	if (!intentosAgotados()) {
+		principal.reiniciarIntentos();
+		bitacora.evento(EV_CONTADOR_RESETEADO);
 	}
-	
-	// Reset flags
-	pmv_alto_debe_salir = false;
-	input = Unknown;
 }
 
 void leavingPmvBajo() {
-	Serial.println("Leaving PMV_BAJO");
-	servo.write(0);
+	principal.calentar(false);
 	digitalWrite(LED_GREEN, LOW);
 	taskpmv_bajo.Stop();
 	taskLEDGREENON.Stop();
 	taskLEDGREENOFF.Stop();
-	input = Unknown;
 }
 
 void enteringInicio() {
-	Serial.println("-> Estado: INICIO");
-	lcd.clear();
-	lcd.setCursor(0, 0);
-	lcd.print("Sistema Listo");
-	lcd.setCursor(0, 1);
-	lcd.print("Ingrese clave:");
+	pantalla.clear();
+	pantalla.setCursor(0, 0);
+	pantalla.print("Sistema Listo");
+	pantalla.setCursor(0, 1);
+	pantalla.print("Ingrese clave:");
 }
 
 void enteringConfig() {
-	Serial.println("-> Estado: CONFIG");
-	lcd.clear();
-	lcd.setCursor(0, 0);
-	lcd.print("Modo CONFIG");
-	lcd.setCursor(0, 1);
-	lcd.print("Escanee tarjeta");
+	pantalla.clear();
+	pantalla.setCursor(0, 0);
+	pantalla.print("Modo CONFIG");
+	pantalla.setCursor(0, 1);
+	pantalla.print("Escanee tarjeta");
 	// digitalWrite(LED_BLUE, HIGH);
 }
 
 void enteringBloqueado() {
 	taskLEDREDON.Start();
-	Serial.println("-> Estado: BLOQUEADO");
-	lcd.clear();
-	lcd.setCursor(0, 0);
-	lcd.print("BLOQUEADO");
-	lcd.setCursor(0, 1);
-	lcd.print("Clave incorrecta , presione *");
+	pantalla.clear();
+	pantalla.setCursor(0, 0);
+	pantalla.print("BLOQUEADO");
+	pantalla.setCursor(0, 1);
+	pantalla.print("Clave incorrecta , presione *");
 }
 
 void enteringAlarma() {
 	taskBuzzer.Start();
 	taskSHORTLEDREDON.Start();
-	Serial.println("-> Estado: ALARMA");
-	Serial.println("*** ALARMA ACTIVADA ***");
-	lcd.clear();
-	lcd.setCursor(0, 0);
-	lcd.print("*** ALARMA ***");
-	lcd.setCursor(0, 1);
-	lcd.print("Presione OFF");
+	bitacora.evento(EV_ALARMA_ACTIVADA);
+	pantalla.clear();
+	pantalla.setCursor(0, 0);
+	pantalla.print("*** ALARMA ***");
+	pantalla.setCursor(0, 1);
+	pantalla.print("Presione OFF");
 	
 	// Resetear banderas del sensor IR al entrar
 	ir_armed = true;
-	ultimo_ir_detectado = 0;
 }
 
 void enteringMonitor() {
 	taskMonitor.Start();
-	Serial.println("-> Estado: MONITOR");
-	
-	// Resetear bandera de salida
-	pmv_alto_debe_salir = false;
-	
-	// Leer sensores al entrar
-	float Ta = dht.readTemperature();
-	float RH = dht.readHumidity();
-	float Tr = readNTCTemperature();
-	if (!isnan(Ta) && !isnan(RH)) {
-		temperatura_actual = Ta;
-		PMVResult res = computePMV(Ta, Tr, RH, 1.0f, 0.61f, 0.1f);
-		pmv_actual = res.pmv;
-	}
-	
-	lcd.setCursor(0, 0);
-	lcd.print("T:");
-	lcd.print(temperatura_actual, 1);
-	lcd.print("C Tr:");
-	lcd.print(Tr, 1);
-	lcd.print("C");
 	
-	lcd.setCursor(0, 1);
-	lcd.print("H:");
-	lcd.print(RH, 0);
-	lcd.print("% PMV:");
-	lcd.print(pmv_actual, 2);
-	
-	/*lcd.clear();
-	lcd.setCursor(0, 0);
-	lcd.print("Monitor:");*/
-	//actualizarDisplayMonitor();
-	
-	Serial.print("Temperatura: ");
-	Serial.println(temperatura_actual);
-	Serial.print("PMV: ");
-	Serial.println(pmv_actual);
+	// PMV con las lecturas vigentes al entrar
+	calcularPMVActual();
+	actualizarDisplayMonitor();
 	
+	bitacora.pmv(Monitor, principal.temperatura(), principal.sensores().RH().valor, principal.pmv());
 }
 
+// Se redibuja entera en la copia de la pantalla; al LCD solo salen los
+// digitos que cambiaron
 void actualizarDisplayMonitor() {
-	lcd.setCursor(0, 1);
-	lcd.print("T:");
-	lcd.print(temperatura_actual, 1);
-	lcd.print("C PMV:");
-	lcd.print(pmv_actual, 2);
-	lcd.print("  ");
+	pantalla.clear();
+	pantalla.print("T:");
+	pantalla.print(principal.temperatura(), 1);
+	pantalla.print("C Tr:");
+	pantalla.print(principal.sensores().trPMV(millisTraza()), 1);
+	pantalla.print("C");
+	
+	pantalla.setCursor(0, 1);
+	pantalla.print("H:");
+	pantalla.print(principal.sensores().RH().valor, 0);
+	pantalla.print("% PMV:");
+	pantalla.print(principal.pmv(), 2);
+}
+
+// Consigna de Ta calculada al encender el rele o el servo, si hay usuario
+void mostrarConsigna() {
+	if (isnan(principal.consigna())) return;
+	pantalla.print("Consigna ");
+	pantalla.print(principal.consigna(), 1);
+	pantalla.print("C");
 }
 
 void enteringPMVALTO() {
 	taskpmv_alto.Start();
-	digitalWrite(RELAY_PIN, HIGH);
+	principal.enfriar(true);
 	taskLEDBLUEON.Start();
-	Serial.println("-> Estado: PMV_ALTO");
-	lcd.clear();
-	lcd.setCursor(0, 0);
-	lcd.print("PMV ALTO ");
-	lcd.print(pmv_actual, 1);
-	lcd.setCursor(0, 1);
+	pantalla.clear();
+	pantalla.setCursor(0, 0);
+	pantalla.print("PMV ALTO ");
+	pantalla.print(principal.pmv(), 1);
+	pantalla.setCursor(0, 1);
+	mostrarConsigna();
 }
 
 void enteringPMVBAJO() {
 	taskpmv_bajo.Start();
 	taskLEDGREENON.Start();
-	servo.write(90);
-	Serial.println("-> Estado: PMV_BAJO");
-	lcd.clear();
-	lcd.setCursor(0, 0);
-	lcd.print("PMV BAJO");
-	lcd.setCursor(0, 1);
-	lcd.print("Calentando...");
+	principal.calentar(true);
+	pantalla.clear();
+	pantalla.setCursor(0, 0);
+	pantalla.print("PMV BAJO");
+	pantalla.setCursor(0, 1);
+	if (isnan(principal.consigna())) pantalla.print("Calentando...");
+	else mostrarConsigna();
 }
@@ -0,0 +1,53 @@
+#ifndef SMARTCOMFORT_TEXTOFIJO_H
+#define SMARTCOMFORT_TEXTOFIJO_H
+
+#include <Arduino.h>
+
+// Cadena de capacidad fija (N caracteres + '\0') que vive donde se declara:
+// global, miembro o en la pila. Reemplaza a String en el teclado, el RFID y
+// la EEPROM: no usa el heap y lo que no cabe se descarta en lugar de crecer.
+template <uint8_t N>
+class TextoFijo {
+public:
+	TextoFijo() : _largo(0) { _buf[0] = '\0'; }
+
+	// Agrega un caracter; false si ya esta lleno
+	bool agregar(char c) {
+		if (_largo >= N) return false;
+		_buf[_largo++] = c;
+		_buf[_largo] = '\0';
+		return true;
+	}
+
+	// Copia hasta N caracteres de 'texto'; false si hubo que truncar
+	bool asignar(const char *texto) {
+		limpiar();
+		while (*texto != '\0') {
+			if (!agregar(*texto++)) return false;
+		}
+		return true;
+	}
+
+	void quitarUltimo() {
+		if (_largo > 0) _buf[--_largo] = '\0';
+	}
+
+	void limpiar() {
+		_largo = 0;
+		_buf[0] = '\0';
+	}
+
+	bool igual(const char *texto) const { return strcmp(_buf, texto) == 0; }
+
+	uint8_t largo() const { return _largo; }
+	bool vacio() const { return _largo == 0; }
+	bool lleno() const { return _largo >= N; }
+	static uint8_t capacidad() { return N; }
+	const char *c_str() const { return _buf; }
+
+private:
+	char _buf[N + 1];
+	uint8_t _largo;
+};
+
+#endif
@@ -0,0 +1,198 @@
+#include "Traza.h"
+#include "Bitacora.h"
+
+static_assert(TRAZA_CAPACIDAD == 256, "los indices del buffer dan la vuelta en 8 bits");
+static_assert(TR_FUENTES <= 16, "la fuente va en 4 bits");
+static_assert(TRAZA_BLOQUE + 1 <= BITACORA_MAX_DATOS, "el bloque no entra en una trama");
+
+#define TRAZA_SALTOS_EN_CABECERA 15
+
+// Sin constructor: en cero queda INACTIVA y, si nada la usa, el enlazador la
+// descarta
+Traza traza;
+
+static uint32_t zigzag32(int32_t v) {
+	return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t deszigzag32(uint32_t v) {
+	return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+float Traza::entrada(FuenteTraza f, float vivo) {
+	if (_modo == INACTIVA) return vivo;
+	uint32_t bits;
+	memcpy(&bits, &vivo, sizeof(bits));
+	bits = valor(f, bits);
+	float v;
+	memcpy(&v, &bits, sizeof(v));
+	return v;
+}
+
+// --- Grabacion -----------------------------------------------------------
+
+void Traza::grabar() {
+	memset(this, 0, sizeof(*this));
+	_modo = GRABANDO;
+}
+
+void Traza::poner(uint8_t b) {
+	_buf[(uint8_t)(_inicio + _largo)] = b;
+	_largo++;
+}
+
+void Traza::ponerVarint(uint32_t v) {
+	while (v >= 0x80) {
+		poner((uint8_t)(v | 0x80));
+		v >>= 7;
+	}
+	poner((uint8_t)v);
+}
+
+// Un registro a medias no sirve: si no entra entero, la traza termina aqui
+bool Traza::abrirRegistro(FuenteTraza f, uint8_t largoMax) {
+	if (TRAZA_CAPACIDAD - _largo < 1 + 5 + largoMax) {
+		cortar();
+		return false;
+	}
+	if (_saltos < TRAZA_SALTOS_EN_CABECERA) {
+		poner((uint8_t)(f | (_saltos << 4)));
+	} else {
+		poner((uint8_t)(f | (TRAZA_SALTOS_EN_CABECERA << 4)));
+		ponerVarint(_saltos - TRAZA_SALTOS_EN_CABECERA);
+	}
+	_saltos = 0;
+	return true;
+}
+
+void Traza::cortar() {
+	_modo = CORTADA;
+	bitacora.evento(EV_TRAZA_CORTADA, BITACORA_ERRORES);
+}
+
+void Traza::bytes(uint8_t *p, uint8_t n) {
+	if (_modo == GRABANDO) {
+		if (!abrirRegistro(TR_BYTES, 1 + n)) return;
+		poner(n);
+		for (uint8_t i = 0; i < n; i++) poner(p[i]);
+		return;
+	}
+	if (_modo != REPRODUCIENDO) return;
+	uint8_t largo;
+	if (_saltos != 0 || _fuente != TR_BYTES || !leer(largo) || largo != n) {
+		desincronizar(0xFF, 0xFF);
+		return;
+	}
+	for (uint8_t i = 0; i < n; i++) {
+		if (!leer(p[i])) return;
+	}
+	siguiente();
+}
+
+void Traza::estado(uint8_t desde, uint8_t hasta) {
+	if (_modo == GRABANDO) {
+		if (!abrirRegistro(TR_ESTADO, 2)) return;
+		poner(desde);
+		poner(hasta);
+		return;
+	}
+	if (_modo != REPRODUCIENDO) return;
+	uint8_t esperado[2] = { 0xFF, 0xFF };
+	if (_saltos != 0 || _fuente != TR_ESTADO || !leer(esperado[0]) || !leer(esperado[1]) ||
+	    esperado[0] != desde || esperado[1] != hasta) {
+		desincronizar(esperado[0], esperado[1]);
+		return;
+	}
+	_verificados++;
+	siguiente();
+}
+
+uint32_t Traza::valor(FuenteTraza f, uint32_t vivo) {
+	if (_modo == GRABANDO) {
+		if (vivo == _ultimo[f]) {
+			_saltos++;
+			return vivo;
+		}
+		if (abrirRegistro(f, 5)) ponerVarint(zigzag32((int32_t)(vivo - _ultimo[f])));
+		_ultimo[f] = vivo;
+		return vivo;
+	}
+	if (_modo != REPRODUCIENDO) return vivo;
+
+	if (_saltos > 0) {
+		_saltos--;
+		return _ultimo[f];
+	}
+	uint32_t diferencia;
+	if (_fuente != f || !leerVarint(diferencia)) {
+		desincronizar(0xFF, 0xFF);
+		return vivo;
+	}
+	_ultimo[f] += (uint32_t)deszigzag32(diferencia);
+	siguiente();
+	return _ultimo[f];
+}
+
+void Traza::servicio() {
+	while (_largo >= TRAZA_BLOQUE || (_modo == CORTADA && _largo > 0)) {
+		uint8_t bloque[TRAZA_BLOQUE];
+		uint8_t n = _largo < TRAZA_BLOQUE ? (uint8_t)_largo : TRAZA_BLOQUE;
+		for (uint8_t i = 0; i < n; i++) bloque[i] = _buf[(uint8_t)(_inicio + i)];
+		if (!bitacora.traza(_tramas, bloque, n)) return;
+		_tramas++;
+		_inicio = (uint8_t)(_inicio + n);
+		_largo -= n;
+	}
+}
+
+// --- Reproduccion ----------------------------------------------------------
+
+void Traza::reproducir(const uint8_t *datos, uint32_t largo) {
+	memset(this, 0, sizeof(*this));
+	_datos = datos;
+	_total = largo;
+	_modo = REPRODUCIENDO;
+	siguiente();
+}
+
+bool Traza::leer(uint8_t &b) {
+	if (_pos >= _total) {
+		_modo = AGOTADA;
+		return false;
+	}
+	b = _datos[_pos++];
+	return true;
+}
+
+bool Traza::leerVarint(uint32_t &v) {
+	v = 0;
+	for (uint8_t n = 0; n < 5; n++) {
+		uint8_t b;
+		if (!leer(b)) return false;
+		v |= (uint32_t)(b & 0x7F) << (7 * n);
+		if (!(b & 0x80)) return true;
+	}
+	_modo = DESINCRONIZADA;
+	return false;
+}
+
+// Lee la cabecera del proximo registro
+void Traza::siguiente() {
+	uint8_t cabecera;
+	if (!leer(cabecera)) return;
+	_fuente = cabecera & 0x0F;
+	_saltos = cabecera >> 4;
+	if (_saltos == TRAZA_SALTOS_EN_CABECERA) {
+		uint32_t extra;
+		if (!leerVarint(extra)) return;
+		_saltos += extra;
+	}
+}
+
+void Traza::desincronizar(uint8_t desde, uint8_t hasta) {
+	// Una traza que se acaba a mitad de un registro no es una divergencia
+	if (_modo != REPRODUCIENDO) return;
+	_modo = DESINCRONIZADA;
+	_esperado[0] = desde;
+	_esperado[1] = hasta;
+}
@@ -0,0 +1,140 @@
+#ifndef SMARTCOMFORT_TRAZA_H
+#define SMARTCOMFORT_TRAZA_H
+
+#include <Arduino.h>
+
+// Traza de entradas para reproducir en el PC una ejecucion de la placa.
+// Cada lectura que decide el comportamiento del sketch (millis(), DHT11,
+// analogRead() del NTC, flancos del IR y del boton, teclado, puerto
+// serie y lector RFID) pasa por TRAZA_ENTRADA(). Grabando, la traza guarda
+// solo las lecturas que cambian respecto de la anterior de la misma fuente,
+// con cuantas lecturas sin cambio hubo antes; reproduciendo, cada lectura
+// devuelve el valor grabado en lugar del real. Como el sketch hace las mismas
+// lecturas en el mismo orden, la ejecucion se repite paso a paso, sin
+// esperar al reloj, y cada cambio de estado se compara con el grabado.
+//
+// Registro: un byte con la fuente (4 bits bajos) y las lecturas salteadas
+// (4 bits altos; 15 = siguen en un varint), y luego:
+//   - entradas: diferencia con el valor anterior de la fuente, zigzag y
+//     varint (los float se comparan y restan por sus bits)
+//   - TR_BYTES: largo y bytes (UID y bloques de la tarjeta)
+//   - TR_ESTADO: desde, hasta
+//
+// Sin SMARTCOMFORT_TRAZA definido, TRAZA_ENTRADA() es la lectura directa y
+// nada usa la traza (el build de host siempre lo define). Con el, en la
+// placa la traza se graba desde el arranque y sale por la bitacora en tramas
+// REG_TRAZA, con el puerto a TRAZA_BAUDIOS: en la simulacion son ~230 B/s,
+// que a 9600 baudios dejarian poco margen a la bitacora. host/DecodificadorBitacora la extrae
+// (smartcomfort_log --traza) y smartcomfort_sim --reproducir la ejecuta.
+#define TRAZA_CAPACIDAD 256   // bytes de RAM para registros sin enviar
+#define TRAZA_BLOQUE 32       // bytes por trama REG_TRAZA
+#define TRAZA_BAUDIOS 115200
+
+enum FuenteTraza : uint8_t {
+	TR_MILLIS = 0,
+	TR_DIGITAL,
+	TR_ANALOGICO,
+	TR_DHT,
+	TR_TECLA,
+	TR_SERIE,
+	TR_RFID,
+	TR_BYTES,
+	TR_ESTADO,
+	TR_FUENTES
+};
+
+class Traza {
+public:
+	enum Modo : uint8_t {
+		INACTIVA = 0,    // lecturas directas
+		GRABANDO,
+		CORTADA,         // se lleno el buffer: la traza termina ahi
+		REPRODUCIENDO,
+		AGOTADA,         // se reprodujo entera
+		DESINCRONIZADA   // el sketch leyo otra fuente o cambio a otro estado
+	};
+
+	// Empieza a grabar (en la placa, desde setup())
+	void grabar();
+
+	// Reproduce una traza grabada; los datos deben seguir vivos
+	void reproducir(const uint8_t *datos, uint32_t largo);
+
+	// El valor de una lectura: el real grabando, el grabado reproduciendo
+	unsigned long entrada(FuenteTraza f, unsigned long vivo) { return (unsigned long)valor(f, (uint32_t)vivo); }
+	int entrada(FuenteTraza f, int vivo) { return (int)(int32_t)valor(f, (uint32_t)(int32_t)vivo); }
+	char entrada(FuenteTraza f, char vivo) { return (char)valor(f, (uint8_t)vivo); }
+	bool entrada(FuenteTraza f, bool vivo) { return valor(f, vivo ? 1 : 0) != 0; }
+	byte entrada(FuenteTraza f, byte vivo) { return (byte)valor(f, vivo); }
+	float entrada(FuenteTraza f, float vivo);
+
+	// Bytes leidos de un dispositivo (se graban siempre enteros)
+	void bytes(uint8_t *p, uint8_t n);
+
+	// Cambio de estado de la maquina: se graba o se verifica
+	void estado(uint8_t desde, uint8_t hasta);
+
+	// Pasa a la bitacora los bloques completos. Va en cada pasada del loop.
+	void servicio();
+
+	Modo modo() const { return _modo; }
+	bool grabando() const { return _modo == GRABANDO; }
+	bool reproduciendo() const { return _modo == REPRODUCIENDO; }
+
+	// Reproduciendo: cambios de estado verificados y, si se desincronizo,
+	// el esperado segun la traza (desde, hasta; 0xFF si no era un estado)
+	unsigned long verificados() const { return _verificados; }
+	uint8_t esperadoDesde() const { return _esperado[0]; }
+	uint8_t esperadoHasta() const { return _esperado[1]; }
+	uint32_t posicion() const { return _pos; }
+
+	// Ultimo millis() leido (grabado o reproducido)
+	unsigned long ultimoMillis() const { return _ultimo[TR_MILLIS]; }
+
+private:
+	uint32_t valor(FuenteTraza f, uint32_t vivo);
+	bool abrirRegistro(FuenteTraza f, uint8_t largoMax);
+	void poner(uint8_t b);
+	void ponerVarint(uint32_t v);
+	void cortar();
+
+	bool leer(uint8_t &b);
+	bool leerVarint(uint32_t &v);
+	void siguiente();
+	void desincronizar(uint8_t desde, uint8_t hasta);
+
+	Modo _modo;
+	uint32_t _ultimo[TR_FUENTES];
+	uint32_t _saltos;        // lecturas sin cambio desde el ultimo registro (o hasta el proximo)
+
+	// Grabando
+	uint8_t _buf[TRAZA_CAPACIDAD];
+	uint8_t _inicio;
+	uint16_t _largo;
+	uint8_t _tramas;         // numero de la proxima trama REG_TRAZA
+
+	// Reproduciendo
+	const uint8_t *_datos;
+	uint32_t _total;
+	uint32_t _pos;
+	uint8_t _fuente;         // del proximo registro
+	unsigned long _verificados;
+	uint8_t _esperado[2];
+};
+
+extern Traza traza;
+
+#ifdef SMARTCOMFORT_TRAZA
+#define TRAZA_ENTRADA(fuente, expr) traza.entrada((fuente), (expr))
+#define TRAZA_BYTES(p, n) traza.bytes((p), (n))
+#else
+#define TRAZA_ENTRADA(fuente, expr) (expr)
+#define TRAZA_BYTES(p, n) ((void)0)
+#endif
+
+// Las lecturas mas usadas
+inline unsigned long millisTraza() { return TRAZA_ENTRADA(TR_MILLIS, millis()); }
+inline int digitalReadTraza(uint8_t pin) { return TRAZA_ENTRADA(TR_DIGITAL, digitalRead(pin)); }
+inline int analogReadTraza(uint8_t pin) { return TRAZA_ENTRADA(TR_ANALOGICO, analogRead(pin)); }
+
+#endif
@@ -0,0 +1,164 @@
+#include "Zona.h"
+#include "Traza.h"
+#include "Perfilador.h"
+
+Zona::Zona(uint8_t id, uint8_t pinDHT, uint8_t pinNTC, uint8_t pinRele, uint8_t pinServo)
+	: _dht(pinDHT, DHT11), _sensores(_dht, pinNTC), _id(id), _pinRele(pinRele), _pinServo(pinServo),
+	  _modo(MONITOR), _intentos(0), _pmv(0.0f), _temperatura(0.0f), _actuando(false), _enBanda(false),
+	  _objetivo(NAN), _consigna(NAN), _ultimaConsigna{ NAN, 0, false }, _bandaDesde(0), _vence(0), _atrasoMax(0) {
+}
+
+void Zona::begin() {
+	pinMode(_pinRele, OUTPUT);
+	digitalWrite(_pinRele, LOW);
+	_servo.attach(_pinServo);
+	_servo.write(0);
+	_dht.begin();
+	_vence = millisTraza() + ZONA_PERIODO_MONITOR_MS;
+}
+
+bool Zona::calcularPMV(unsigned long ahora) {
+	if (!_sensores.vigentes(ahora)) return false;
+	_temperatura = _sensores.Ta().valor;
+	PERFIL_SECCION(PERF_PMV);
+	PMVResult res = _pmvIncremental.evaluar(_sensores.Ta().valor, _sensores.trPMV(ahora), _sensores.RH().valor);
+	_pmv = res.pmv;
+	if (_actuando) actualizarConsigna(ahora);
+	return true;
+}
+
+void Zona::actualizarConsigna(unsigned long ahora) {
+	// Con el PMV de vuelta en la banda, la consigna tiene ZONA_CONSIGNA_MAX_MS
+	// para alcanzarse; si no, se deja y vale la banda
+	if (confort() != 0) {
+		_enBanda = false;
+	} else if (!_enBanda) {
+		_enBanda = true;
+		_bandaDesde = ahora;
+	}
+	if (isnan(_objetivo) || (_enBanda && ahora - _bandaDesde >= ZONA_CONSIGNA_MAX_MS)) {
+		_consigna = NAN;
+		return;
+	}
+	_ultimaConsigna = evaluarConsigna(_objetivo, _sensores.trPMV(ahora), _sensores.RH().valor, _arranque);
+	_consigna = _ultimaConsigna.Ta;
+}
+
+void Zona::fijarObjetivo(float pmv) {
+	_objetivo = pmv;
+	_arranque.olvidar();
+	if (_actuando) actualizarConsigna(millisTraza());
+}
+
+bool Zona::enfriada() const {
+	return isnan(_consigna) ? _pmv <= 1.00f : _temperatura <= _consigna;
+}
+
+bool Zona::calentada() const {
+	return isnan(_consigna) ? _pmv >= -1.00f : _temperatura >= _consigna;
+}
+
+int8_t Zona::confort() const {
+	if (_pmv > 1.0f) return 1;
+	if (_pmv < -1.0f) return -1;
+	return 0;
+}
+
+Zona::Evaluacion Zona::evaluarEnfriamiento(unsigned long ahora) {
+	if (!calcularPMV(ahora)) return SIN_LECTURAS;
+
+	if (enfriada()) {
+		_intentos = 0;
+		return NORMALIZADO;
+	}
+	if (_pmv <= 1.00f) {  // margen por precision
+		_intentos = 0;
+		return ACERCANDO;
+	}
+
+	// Si sigue alto, contar solo si la sala esta templada o caliente
+	if (_temperatura >= ZONA_TEMP_INTENTO) {
+		_intentos++;
+		return _intentos >= ZONA_INTENTOS_ALARMA ? AGOTADO : INTENTO;
+	}
+	_intentos = 0;
+	return REINICIADO;
+}
+
+void Zona::enfriar(bool encendido) {
+	digitalWrite(_pinRele, encendido ? HIGH : LOW);
+	_actuando = encendido;
+	_enBanda = false;
+	if (encendido) actualizarConsigna(millisTraza());
+	else _consigna = NAN;
+}
+
+void Zona::calentar(bool encendido) {
+	_servo.write(encendido ? 90 : 0);
+	_actuando = encendido;
+	_enBanda = false;
+	if (encendido) actualizarConsigna(millisTraza());
+	else _consigna = NAN;
+}
+
+unsigned long Zona::periodo(Modo modo) {
+	switch (modo) {
+	case ENFRIANDO: return ZONA_PERIODO_ENFRIANDO_MS;
+	case CALENTANDO: return ZONA_PERIODO_CALENTANDO_MS;
+	default: return ZONA_PERIODO_MONITOR_MS;
+	}
+}
+
+// Salida del modo actual y entrada al nuevo, como los leaving*/entering* del
+// sketch
+void Zona::entrar(Modo modo, unsigned long ahora) {
+	if (_modo == ENFRIANDO) {
+		enfriar(false);
+		if (modo != ALARMA) _intentos = 0;
+	} else if (_modo == CALENTANDO) {
+		calentar(false);
+	} else if (_modo == ALARMA) {
+		_intentos = 0;
+	}
+
+	_modo = modo;
+	if (modo == ENFRIANDO) enfriar(true);
+	else if (modo == CALENTANDO) calentar(true);
+	_vence = ahora + periodo(modo);
+}
+
+bool Zona::regular(unsigned long ahora) {
+	actualizarSensores(ahora);
+	if (_modo == ALARMA || (long)(ahora - _vence) < 0) return false;
+
+	unsigned long atraso = ahora - _vence;
+	if (atraso > _atrasoMax) _atrasoMax = atraso;
+
+	Modo antes = _modo;
+	switch (_modo) {
+	case MONITOR:
+		if (!calcularPMV(ahora)) _vence = ahora + ZONA_PERIODO_MONITOR_MS;
+		else if (confort() > 0) entrar(ENFRIANDO, ahora);
+		else if (confort() < 0) entrar(CALENTANDO, ahora);
+		else _vence = ahora + ZONA_PERIODO_MONITOR_MS;
+		break;
+	case ENFRIANDO:
+		switch (evaluarEnfriamiento(ahora)) {
+		case NORMALIZADO: entrar(MONITOR, ahora); break;
+		case AGOTADO: entrar(ALARMA, ahora); break;
+		default: _vence = ahora + ZONA_PERIODO_ENFRIANDO_MS; break;
+		}
+		break;
+	case CALENTANDO:
+		// Como pmv_bajo: un periodo de calefaccion y vuelta a medir
+		entrar(MONITOR, ahora);
+		break;
+	default:
+		break;
+	}
+	return _modo != antes;
+}
+
+void Zona::reconocerAlarma(unsigned long ahora) {
+	if (_modo == ALARMA) entrar(MONITOR, ahora);
+}
@@ -0,0 +1,135 @@
+#ifndef SMARTCOMFORT_ZONA_H
+#define SMARTCOMFORT_ZONA_H
+
+#include <Arduino.h>
+#include <DHT.h>
+#include <Servo.h>
+#include "Sensores.h"
+#include "PMVIncremental.h"
+#include "PMVConsigna.h"
+
+// Periodos de la regulacion, los mismos de taskMonitor, taskpmv_alto y
+// taskpmv_bajo del sketch
+#define ZONA_PERIODO_MONITOR_MS 7000UL
+#define ZONA_PERIODO_ENFRIANDO_MS 5000UL
+#define ZONA_PERIODO_CALENTANDO_MS 3000UL
+
+// Turno de taskZonas: con N salas, las N - 1 sin pantalla se atienden una
+// por turno y cada una espera (N - 1) * ZONA_TURNO_MS como maximo
+#define ZONA_TURNO_MS 25
+
+// Evaluaciones seguidas con PMV alto (y Ta >= ZONA_TEMP_INTENTO) que llevan
+// a la alarma
+#define ZONA_INTENTOS_ALARMA 3
+#define ZONA_TEMP_INTENTO 21.0f
+
+// Con un usuario identificado el enfriamiento y la calefaccion siguen hasta
+// la consigna de Ta de su PMV objetivo (PMVConsigna.h), no solo hasta volver
+// a la banda de +-1. Si ya en la banda la consigna no se alcanza en este
+// tiempo (el equipo no da abasto), se deja y vale la banda.
+#define ZONA_CONSIGNA_MAX_MS 60000UL
+
+// Una sala: sus sensores (DHT11 y NTC), sus actuadores (rele del
+// enfriamiento y servo de la calefaccion) y su estado de PMV. Las reglas de
+// pmv_alto/pmv_bajo/Alarma viven aqui para todas las salas; la sala con
+// teclado y LCD las aplica desde la maquina de estados del sketch y las
+// demas desde regular(), una por turno del planificador.
+class Zona {
+public:
+	enum Modo : uint8_t { MONITOR, ENFRIANDO, CALENTANDO, ALARMA };
+
+	// Resultado de una evaluacion con PMV alto
+	enum Evaluacion : uint8_t {
+		SIN_LECTURAS,  // sensores sin valores vigentes
+		NORMALIZADO,   // enfriada(): se deja de enfriar
+		ACERCANDO,     // PMV <= 1 pero todavia sobre la consigna: sigue
+		INTENTO,       // sigue alto con Ta >= ZONA_TEMP_INTENTO: un intento mas
+		REINICIADO,    // sigue alto pero con Ta baja: intentos a cero
+		AGOTADO        // ZONA_INTENTOS_ALARMA intentos: alarma
+	};
+
+	Zona(uint8_t id, uint8_t pinDHT, uint8_t pinNTC, uint8_t pinRele, uint8_t pinServo);
+	Zona(const Zona &) = delete;
+
+	void begin();
+
+	// Muestrea los sensores a su ritmo; true si llego algun valor nuevo
+	bool actualizarSensores(unsigned long ahora) { return _sensores.actualizar(ahora); }
+
+	// PMV con los ultimos valores de los sensores; false si no estan vigentes
+	bool calcularPMV(unsigned long ahora);
+
+	// +1 si el ultimo PMV es alto (> 1), -1 si es bajo (< -1), 0 si no
+	int8_t confort() const;
+
+	// Recalcula el PMV y cuenta el intento de enfriamiento
+	Evaluacion evaluarEnfriamiento(unsigned long ahora);
+
+	// Con un actuador encendido y un objetivo fijado, calcularPMV() tambien
+	// recalcula la consigna de Ta (PMVConsigna.h) con la RH y la Tr vigentes
+	void enfriar(bool encendido);
+	void calentar(bool encendido);
+
+	// PMV objetivo del usuario (objetivoPreferido()); NAN: sin usuario
+	void fijarObjetivo(float pmv);
+
+	// Fin del enfriamiento y de la calefaccion: con consigna, Ta la
+	// alcanzo; sin consigna, el PMV volvio a la banda de +-1
+	bool enfriada() const;
+	bool calentada() const;
+
+	// Regulacion autonoma (salas sin teclado ni LCD): atiende el vencimiento
+	// del modo actual, si lo hubo. Devuelve true si cambio de modo.
+	bool regular(unsigned long ahora);
+
+	// La alarma queda enclavada hasta que alguien la reconoce
+	void reconocerAlarma(unsigned long ahora);
+
+	uint8_t id() const { return _id; }
+	Modo modo() const { return _modo; }
+	float pmv() const { return _pmv; }
+	float temperatura() const { return _temperatura; }
+	float objetivo() const { return _objetivo; }
+	float consigna() const { return _consigna; }  // NAN sin objetivo o sin actuar
+	const ConsignaPMV &ultimaConsigna() const { return _ultimaConsigna; }
+	uint8_t intentos() const { return _intentos; }
+	void reiniciarIntentos() { _intentos = 0; }
+	const ServicioSensores &sensores() const { return _sensores; }
+	const PMVIncremental &pmvIncremental() const { return _pmvIncremental; }
+	ServicioSensores &sensores() { return _sensores; }
+
+	// millis() en que regular() tiene trabajo (salvo en ALARMA)
+	unsigned long vencimiento() const { return _vence; }
+
+	// Mayor atraso de regular() respecto de un vencimiento (ms)
+	unsigned long atrasoMaximo() const { return _atrasoMax; }
+	void reiniciarAtraso() { _atrasoMax = 0; }
+
+private:
+	void entrar(Modo modo, unsigned long ahora);
+	static unsigned long periodo(Modo modo);
+	void actualizarConsigna(unsigned long ahora);
+
+	DHT _dht;
+	ServicioSensores _sensores;
+	PMVIncremental _pmvIncremental;  // solo recalcula lo que cambio en los sensores
+	Servo _servo;
+	uint8_t _id;
+	uint8_t _pinRele;
+	uint8_t _pinServo;
+	Modo _modo;
+	uint8_t _intentos;
+	float _pmv;
+	float _temperatura;
+	bool _actuando;                // rele o servo encendido
+	bool _enBanda;                 // PMV en +-1 desde _bandaDesde
+	float _objetivo;
+	float _consigna;
+	ConsignaPMV _ultimaConsigna;
+	ArranqueConsigna _arranque;    // consigna anterior, para el solver
+	unsigned long _bandaDesde;
+	unsigned long _vence;
+	unsigned long _atrasoMax;
+};
+
+#endif
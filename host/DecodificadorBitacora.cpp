@@ -0,0 +1,250 @@
+#include "DecodificadorBitacora.h"
+
+#include <string.h>
+
+#include "Perfilador.h"
+
+namespace {
+
+const char *const kEstados[] = { "inicio", "Config", "Bloqueado", "Alarma", "Monitor", "pmv_alto", "pmv_bajo" };
+
+// Zona::Modo
+const char *const kModosZona[] = { "monitor", "enfriando", "calentando", "ALARMA" };
+
+const char *const kEventos[EV_CANTIDAD] = {
+	"?",
+	"presencia IR: vuelta a inicio",
+	"sensor IR liberado: rearmado",
+	"tecla #: vuelta a inicio",
+	"tecla *: vuelta a inicio",
+	"timer pmv_alto: leyendo sensores",
+	"ERROR lecturas NaN: reintento",
+	"PMV normalizado",
+	"ALARMA: 3 intentos agotados",
+	"contador de temperatura alta reseteado",
+	"*** ALARMA ACTIVADA ***",
+	"ERROR traza de entradas cortada: buffer lleno",
+	"ERROR cola de eventos llena: eventos perdidos",
+	"ERROR cola de flancos llena: flancos perdidos",
+	"ERROR NTC abierto o en corto: PMV con Tr = Ta",
+	"ERROR planificador lleno: una tarea no arranco",
+	"arranque: iniciando la maquina de estados",
+};
+
+// SeccionPerfil
+const char *const kSeccionesPerfil[PERF_SECCIONES] = {
+	"loop", "readInput", "maquina", "tareas", "espera", "PMV", "DHT", "NTC", "pantalla", "bitacora",
+};
+
+const char *nombreEstado(uint8_t e) {
+	return e < sizeof(kEstados) / sizeof(kEstados[0]) ? kEstados[e] : "?";
+}
+
+int16_t leer16(const uint8_t *p) {
+	return (int16_t)(p[0] | (p[1] << 8));
+}
+
+uint32_t leer32(const uint8_t *p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Centesimas a texto ("nan" para BITACORA_SIN_VALOR)
+const char *centesimas(int16_t v, char *buf, size_t n) {
+	if (v == BITACORA_SIN_VALOR) snprintf(buf, n, "nan");
+	else snprintf(buf, n, "%.2f", v / 100.0);
+	return buf;
+}
+
+}  // namespace
+
+void DecodificadorBitacora::byte(uint8_t c) {
+	if (largo_ == 0 && c != BITACORA_SYNC) {
+		fputc(c, salida_);
+		return;
+	}
+	trama_[largo_++] = c;
+	if (largo_ == 3 && trama_[2] > BITACORA_MAX_DATOS) {
+		resincronizar();
+		return;
+	}
+	if (largo_ < BITACORA_CABECERA || largo_ < (unsigned)BITACORA_CABECERA + trama_[2] + 1) return;
+
+	uint8_t control = 0;
+	for (unsigned i = 1; i + 1 < largo_; i++) control ^= trama_[i];
+	if (control != trama_[largo_ - 1]) {
+		resincronizar();
+		return;
+	}
+	imprimir();
+	largo_ = 0;
+}
+
+// El SYNC no abria una trama: sale como texto y el resto se vuelve a
+// examinar por si contiene el comienzo de una trama verdadera
+void DecodificadorBitacora::resincronizar() {
+	uint8_t resto[sizeof(trama_)];
+	unsigned n = largo_ - 1;
+	memcpy(resto, trama_ + 1, n);
+	fputc(trama_[0], salida_);
+	largo_ = 0;
+	for (unsigned i = 0; i < n; i++) byte(resto[i]);
+}
+
+void DecodificadorBitacora::fin() {
+	for (unsigned i = 0; i < largo_; i++) fputc(trama_[i], salida_);
+	largo_ = 0;
+	fflush(salida_);
+}
+
+void DecodificadorBitacora::imprimir() {
+	uint8_t tipo = trama_[1];
+	uint8_t n = trama_[2];
+	uint32_t ms = leer32(trama_ + 3);
+	const uint8_t *d = trama_ + BITACORA_CABECERA;
+	char a[16], b[16], c[16];
+	tramas_++;
+
+	if (tipo == REG_HISTORIAL) {
+		bloqueHistorial(ms / 1000.0, d, n);
+		return;
+	}
+	if (tipo == REG_TRAZA) {
+		bloqueTraza(d, n);
+		return;
+	}
+	if (tipo == REG_PERFILADO) {
+		bloquePerfilado(ms / 1000.0, d, n);
+		return;
+	}
+	fprintf(salida_, "[%10.3f s] ", ms / 1000.0);
+	switch (tipo) {
+	case REG_ESTADO:
+		fprintf(salida_, "estado %s -> %s\n", nombreEstado(d[0]), nombreEstado(d[1]));
+		break;
+	case REG_MUESTRA:
+		fprintf(salida_, "muestra Ta=%s C RH=%s %% Tr=%s C\n", centesimas(leer16(d), a, sizeof(a)),
+		        centesimas(leer16(d + 2), b, sizeof(b)), centesimas(leer16(d + 4), c, sizeof(c)));
+		break;
+	case REG_PMV:
+		fprintf(salida_, "PMV %s en %s (Ta=%s C RH=%s %%)\n", centesimas(leer16(d + 5), a, sizeof(a)),
+		        nombreEstado(d[0]), centesimas(leer16(d + 1), b, sizeof(b)), centesimas(leer16(d + 3), c, sizeof(c)));
+		break;
+	case REG_INTENTOS:
+		fprintf(salida_, "intento %u/3: PMV continua alto\n", d[0]);
+		break;
+	case REG_EVENTO:
+		fprintf(salida_, "%s\n", d[0] < EV_CANTIDAD ? kEventos[d[0]] : "evento ?");
+		break;
+	case REG_TARJETA:
+		fprintf(salida_, "tarjeta %02X %02X %02X %02X %s\n", d[1], d[2], d[3], d[4],
+		        d[0] ? "registrada" : "desconocida: no registrada");
+		break;
+	case REG_PERFIL: {
+		size_t ln = strnlen((const char *)d, n);
+		fprintf(salida_, "bienvenido %.*s, temperatura preferida %.*s\n", (int)ln, (const char *)d,
+		        (int)(ln < n ? n - ln - 1 : 0), (const char *)d + ln + 1);
+		break;
+	}
+	case REG_ERROR_RFID:
+		fprintf(salida_, "ERROR RFID al %s el bloque %u (status %u)\n", d[0] ? "leer" : "autenticar", d[1], d[2]);
+		break;
+	case REG_HEAP:
+		fprintf(salida_, "heap %u bytes\n", (unsigned)(uint16_t)leer16(d));
+		break;
+	case REG_DESCARTES:
+		descartadas_ += (uint16_t)leer16(d);
+		fprintf(salida_, "(%u eventos descartados: bitacora llena)\n", (unsigned)(uint16_t)leer16(d));
+		break;
+	case REG_ZONA:
+		fprintf(salida_, "zona %u: %s con PMV %s (Ta=%s C RH=%s %%)\n", d[0],
+		        d[1] < sizeof(kModosZona) / sizeof(kModosZona[0]) ? kModosZona[d[1]] : "?",
+		        centesimas(leer16(d + 6), a, sizeof(a)), centesimas(leer16(d + 2), b, sizeof(b)),
+		        centesimas(leer16(d + 4), c, sizeof(c)));
+		break;
+	default:
+		fprintf(salida_, "registro tipo %u (%u bytes)\n", tipo, n);
+		break;
+	}
+}
+
+void DecodificadorBitacora::bloqueHistorial(double segundos, const uint8_t *d, uint8_t n) {
+	if (n < 2) return;
+	uint16_t direccion = (uint16_t)leer16(d);
+	if (n == 2) {
+		// Bloque vacio: fin del volcado
+		if (!recibiendoHistorial_) historial_.reiniciar();
+		fprintf(salidaHistorial_, "[%10.3f s] ", segundos);
+		historial_.imprimir(salidaHistorial_);
+		recibiendoHistorial_ = false;
+		volcados_++;
+		return;
+	}
+	if (!recibiendoHistorial_) {
+		historial_.reiniciar();
+		recibiendoHistorial_ = true;
+	}
+	historial_.bloque(direccion, d + 2, n - 2);
+}
+
+// Los bytes de la traza van tal cual al archivo; un salto en la numeracion
+// es una trama perdida y la traza deja de servir desde ahi
+void DecodificadorBitacora::bloqueTraza(const uint8_t *d, uint8_t n) {
+	if (n < 1) return;
+	if (tramasTraza_ > 0 && d[0] != (uint8_t)(ultimaTraza_ + 1)) {
+		if (trazaPerdida_ == 0) fprintf(stderr, "traza: falta la trama %u\n", (uint8_t)(ultimaTraza_ + 1));
+		trazaPerdida_++;
+	}
+	ultimaTraza_ = d[0];
+	tramasTraza_++;
+	if (salidaTraza_ && trazaPerdida_ == 0) fwrite(d + 1, 1, n - 1, salidaTraza_);
+}
+
+// Una linea por seccion y debajo su histograma (solo los cubos con cuentas)
+void DecodificadorBitacora::bloquePerfilado(double segundos, const uint8_t *d, uint8_t n) {
+	if (n < 1) return;
+	FILE *f = salidaHistorial_;
+	if (!recibiendoPerfilado_) {
+		fprintf(f, "[%10.3f s] perfilado del loop (us)\n", segundos);
+		recibiendoPerfilado_ = true;
+	}
+	uint8_t tipo = d[0];
+	d++;
+	n--;
+	if (tipo == PERFILADO_SECCION && n >= 21) {
+		char nombre[32];
+		if (d[0] & PERFIL_TAREA) snprintf(nombre, sizeof(nombre), "tarea %u (cada %lu ms)", d[0] & ~PERFIL_TAREA,
+		                                  (unsigned long)leer32(d + 1));
+		else snprintf(nombre, sizeof(nombre), "%s", d[0] < PERF_SECCIONES ? kSeccionesPerfil[d[0]] : "?");
+		fprintf(f, "  %-26s n=%-9lu min=%-7lu media=%-7lu max=%lu\n", nombre, (unsigned long)leer32(d + 5),
+		        (unsigned long)leer32(d + 9), (unsigned long)leer32(d + 17), (unsigned long)leer32(d + 13));
+	} else if (tipo == PERFILADO_HISTOGRAMA && n >= 1 + 2 * PERFIL_CUBOS) {
+		fprintf(f, "   ");
+		for (unsigned b = 0; b < PERFIL_CUBOS; b++) {
+			unsigned cuenta = (uint16_t)leer16(d + 1 + 2 * b);
+			if (cuenta == 0) continue;
+			if (b == 0) fprintf(f, " 0-1:%u", cuenta);
+			else if (b == PERFIL_CUBOS - 1) fprintf(f, " %lu+:%u", 1UL << b, cuenta);
+			else fprintf(f, " %lu-%lu:%u", 1UL << b, (2UL << b) - 1, cuenta);
+		}
+		fprintf(f, "\n");
+	} else if (tipo == PERFILADO_PEOR_LOOP && n >= 9) {
+		fprintf(f, "  peor loop: %lu us a los %.3f s, en %s\n", (unsigned long)leer32(d),
+		        leer32(d + 4) / 1000.0, nombreEstado(d[8]));
+	} else if (tipo == PERFILADO_PMV && n >= 20) {
+		unsigned long aciertos = leer32(d), soloRH = leer32(d + 4), soloTr = leer32(d + 8);
+		unsigned long total = aciertos + soloRH + soloTr + leer32(d + 12);
+		double pct = total ? 100.0 / total : 0.0;
+		fprintf(f, "  PMV incremental: %lu evaluaciones, %.1f %% sin cambio, %.1f %% solo RH, %.1f %% solo Tr,"
+		        " %lu us ahorrados\n", total, aciertos * pct, soloRH * pct, soloTr * pct, (unsigned long)leer32(d + 16));
+	} else if (tipo == PERFILADO_REPOSO && n >= 19) {
+		unsigned long activo = leer32(d + 1), dormido = leer32(d + 5);
+		double total = (double)activo + dormido;
+		fprintf(f, "  reposo en %-10s %5.1f %% activo, %.1f s dormido, %lu despertares por tiempo y %lu por entrada,"
+		        " latencia max %u ms, %.3f mAh\n", nombreEstado(d[0]), total > 0 ? 100.0 * activo / total : 0.0,
+		        dormido / 1000.0, (unsigned long)leer32(d + 9), (unsigned long)leer32(d + 13),
+		        (unsigned)(uint16_t)leer16(d + 17), (activo * REPOSO_MA_ACTIVO + dormido * REPOSO_MA_DORMIDO) / 3.6e6);
+	} else if (tipo == PERFILADO_FIN) {
+		recibiendoPerfilado_ = false;
+		perfilados_++;
+	}
+}
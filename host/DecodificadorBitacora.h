@@ -0,0 +1,58 @@
+// Decodificador de la bitacora binaria del sketch (Bitacora.h): recibe los
+// bytes del puerto serie de a uno y escribe una linea de texto por trama.
+// Lo que no forma una trama valida (texto de setup(), ruido) pasa tal cual.
+// Los bloques de un volcado del historial (REG_HISTORIAL) se juntan y al
+// llegar el ultimo se imprime el historial entero. Los de la traza de
+// entradas (REG_TRAZA) se escriben en el archivo elegido con traza(). Un
+// volcado del perfilado (REG_PERFILADO) se imprime como tabla por seccion.
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "Bitacora.h"
+#include "DecodificadorHistorial.h"
+
+class DecodificadorBitacora {
+public:
+	// El historial y el perfilado salen por 'volcados' (por defecto, por 'salida')
+	explicit DecodificadorBitacora(FILE *salida, FILE *volcados = nullptr)
+		: salida_(salida), salidaHistorial_(volcados ? volcados : salida) {}
+
+	void byte(uint8_t c);
+	// Vuelca lo que quede a medias al terminar el flujo
+	void fin();
+
+	unsigned long tramas() const { return tramas_; }
+	unsigned long descartadas() const { return descartadas_; }  // informadas por el sketch
+	unsigned long volcados() const { return volcados_; }        // historiales completos recibidos
+	unsigned long perfilados() const { return perfilados_; }    // perfilados completos recibidos
+
+	// Archivo para la traza de entradas (nullptr: se descarta)
+	void traza(FILE *salida) { salidaTraza_ = salida; }
+	unsigned long tramasTraza() const { return tramasTraza_; }
+	unsigned long tramasTrazaPerdidas() const { return trazaPerdida_; }
+
+private:
+	void resincronizar();
+	void imprimir();
+	void bloqueHistorial(double segundos, const uint8_t *d, uint8_t n);
+	void bloqueTraza(const uint8_t *d, uint8_t n);
+	void bloquePerfilado(double segundos, const uint8_t *d, uint8_t n);
+
+	FILE *salida_;
+	FILE *salidaHistorial_;
+	DecodificadorHistorial historial_;
+	bool recibiendoHistorial_ = false;
+	unsigned long volcados_ = 0;
+	FILE *salidaTraza_ = nullptr;
+	uint8_t ultimaTraza_ = 0;
+	unsigned long tramasTraza_ = 0;
+	unsigned long trazaPerdida_ = 0;
+	bool recibiendoPerfilado_ = false;
+	unsigned long perfilados_ = 0;
+	uint8_t trama_[BITACORA_CABECERA + BITACORA_MAX_DATOS + 1];
+	unsigned largo_ = 0;
+	unsigned long tramas_ = 0;
+	unsigned long descartadas_ = 0;
+};
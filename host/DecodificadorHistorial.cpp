@@ -0,0 +1,90 @@
+#include "DecodificadorHistorial.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace {
+
+const char *const kEstados[] = { "inicio", "Config", "Bloqueado", "Alarma", "Monitor", "pmv_alto", "pmv_bajo" };
+
+struct Pagina {
+	unsigned indice;
+	CabeceraHistorial cabecera;
+};
+
+const char *escalado(int16_t v, double escala, const char *formato, char *buf, size_t n) {
+	if (v == HISTORIAL_SIN_VALOR) snprintf(buf, n, "nan");
+	else snprintf(buf, n, formato, v / escala);
+	return buf;
+}
+
+}  // namespace
+
+void DecodificadorHistorial::reiniciar() {
+	memset(imagen_, HISTORIAL_LIBRE, sizeof(imagen_));
+}
+
+void DecodificadorHistorial::bloque(uint16_t direccion, const uint8_t *datos, unsigned n) {
+	for (unsigned i = 0; i < n; i++) {
+		unsigned dir = direccion + i;
+		if (dir >= HISTORIAL_INICIO && dir < HISTORIAL_FIN) imagen_[dir - HISTORIAL_INICIO] = datos[i];
+	}
+}
+
+unsigned DecodificadorHistorial::paginasValidas() const {
+	unsigned n = 0;
+	CabeceraHistorial c;
+	for (unsigned p = 0; p < HISTORIAL_PAGINAS; p++)
+		if (decodificarCabecera(imagen_ + p * HISTORIAL_PAGINA, c)) n++;
+	return n;
+}
+
+std::vector<DecodificadorHistorial::Entrada> DecodificadorHistorial::muestras() const {
+	std::vector<Pagina> paginas;
+	for (unsigned p = 0; p < HISTORIAL_PAGINAS; p++) {
+		Pagina pg;
+		pg.indice = p;
+		if (decodificarCabecera(imagen_ + p * HISTORIAL_PAGINA, pg.cabecera)) paginas.push_back(pg);
+	}
+	// La mas nueva es la ultima en la rueda: la mas vieja es la siguiente
+	// a ella (secuencias modulo 2^16)
+	if (!paginas.empty()) {
+		uint16_t ultima = paginas[0].cabecera.secuencia;
+		for (const Pagina &pg : paginas)
+			if ((int16_t)(pg.cabecera.secuencia - ultima) > 0) ultima = pg.cabecera.secuencia;
+		std::sort(paginas.begin(), paginas.end(), [ultima](const Pagina &a, const Pagina &b) {
+			return (uint16_t)(ultima - a.cabecera.secuencia) > (uint16_t)(ultima - b.cabecera.secuencia);
+		});
+	}
+
+	std::vector<Entrada> salida;
+	for (const Pagina &pg : paginas) {
+		const uint8_t *p = imagen_ + pg.indice * HISTORIAL_PAGINA + HISTORIAL_CABECERA;
+		const uint8_t *fin = imagen_ + (pg.indice + 1) * HISTORIAL_PAGINA;
+		MuestraHistorial previa = muestraInicial(pg.cabecera);
+		Entrada e;
+		e.arranque = pg.cabecera.arranque;
+		uint8_t largo;
+		while ((largo = decodificarMuestra(p, fin, previa, pg.cabecera.secuencia, e.muestra)) != 0) {
+			salida.push_back(e);
+			previa = e.muestra;
+			p += largo;
+		}
+	}
+	return salida;
+}
+
+void DecodificadorHistorial::imprimir(FILE *salida) const {
+	std::vector<Entrada> m = muestras();
+	fprintf(salida, "historial: %zu muestras en %u paginas\n", m.size(), paginasValidas());
+	char ta[16], tr[16], rh[16], pmv[16];
+	for (const Entrada &e : m) {
+		const MuestraHistorial &x = e.muestra;
+		fprintf(salida, "  arranque %u  %3lu:%02lu:%02lu  Ta=%s C Tr=%s C RH=%s %% PMV=%s  %s\n", e.arranque,
+		        (unsigned long)(x.segundos / 3600), (unsigned long)(x.segundos / 60 % 60),
+		        (unsigned long)(x.segundos % 60), escalado(x.Ta, 10.0, "%.1f", ta, sizeof(ta)),
+		        escalado(x.Tr, 10.0, "%.1f", tr, sizeof(tr)), escalado(x.RH, 1.0, "%.0f", rh, sizeof(rh)),
+		        escalado(x.pmv, 100.0, "%.2f", pmv, sizeof(pmv)),
+		        x.estado < sizeof(kEstados) / sizeof(kEstados[0]) ? kEstados[x.estado] : "?");
+	}
+}
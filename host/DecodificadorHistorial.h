@@ -0,0 +1,34 @@
+// Decodificador del historial de la EEPROM (Historial.h): arma la imagen de
+// la zona del historial con los bloques del volcado (REG_HISTORIAL) y la
+// recorre pagina por pagina, en orden de secuencia.
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+#include "Historial.h"
+
+class DecodificadorHistorial {
+public:
+	struct Entrada {
+		uint16_t arranque;
+		MuestraHistorial muestra;
+	};
+
+	DecodificadorHistorial() { reiniciar(); }
+
+	// Imagen vacia (todo 0xFF, como una EEPROM sin escribir)
+	void reiniciar();
+	void bloque(uint16_t direccion, const uint8_t *datos, unsigned n);
+
+	// Muestras de todas las paginas validas, de la mas vieja a la mas nueva
+	std::vector<Entrada> muestras() const;
+	unsigned paginasValidas() const;
+
+	// Una linea por muestra y un resumen
+	void imprimir(FILE *salida) const;
+
+private:
+	uint8_t imagen_[HISTORIAL_FIN - HISTORIAL_INICIO];
+};
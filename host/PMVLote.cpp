@@ -0,0 +1,37 @@
+#include "PMVLote.h"
+#include "PMVLoteNucleo.h"
+
+#if defined(__x86_64__)
+// PMVLoteAVX2.cpp
+void evaluarLoteAVX2(const EntradasPMVLote &in, const SalidasPMVLote &out, size_t n);
+
+static bool cpuConAVX2() {
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+#endif
+
+NucleoPMVLote computePMVLote(const EntradasPMVLote &in, const SalidasPMVLote &out, size_t n, NucleoPMVLote nucleo) {
+#if defined(__x86_64__)
+	if (nucleo == NucleoPMVLote::Auto) nucleo = cpuConAVX2() ? NucleoPMVLote::AVX2 : NucleoPMVLote::SSE2;
+	if (nucleo == NucleoPMVLote::AVX2 && !cpuConAVX2()) nucleo = NucleoPMVLote::SSE2;
+	if (nucleo == NucleoPMVLote::AVX2) {
+		evaluarLoteAVX2(in, out, n);
+		return nucleo;
+	}
+	if (nucleo == NucleoPMVLote::SSE2) {
+		evaluarLote<VSSE2>(in, out, n);
+		return nucleo;
+	}
+#endif
+	evaluarLote<VEscalar>(in, out, n);
+	return NucleoPMVLote::Escalar;
+}
+
+const char *nombreNucleoPMVLote(NucleoPMVLote nucleo) {
+	switch (nucleo) {
+	case NucleoPMVLote::SSE2: return "SSE2";
+	case NucleoPMVLote::AVX2: return "AVX2";
+	case NucleoPMVLote::Escalar: return "escalar";
+	default: return "auto";
+	}
+}
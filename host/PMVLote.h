@@ -0,0 +1,32 @@
+// Evaluacion de PMV/PPD por lotes para post-procesar registros en el PC.
+// Las entradas llegan como estructura de arreglos (un arreglo por variable)
+// y se evaluan de a 8 (AVX2), 4 (SSE2) o 1 (escalar) muestras por paso, con
+// el solver de T_cl de computePMV iterado en paralelo sobre todos los carriles
+// hasta que cada uno converge.
+#pragma once
+
+#include <stddef.h>
+
+struct EntradasPMVLote {
+	const float *Ta;
+	const float *Tr;
+	const float *RH;
+	const float *met;
+	const float *clo;
+	const float *va;
+};
+
+struct SalidasPMVLote {
+	float *pmv;
+	float *ppd;  // opcional (nullptr = no se calcula)
+};
+
+enum class NucleoPMVLote { Auto, Escalar, SSE2, AVX2 };
+
+// Evalua n muestras. Mismo saneado de entradas y mismo resultado que
+// computePMV (salvo el arranque en caliente, aqui siempre en frio).
+// Devuelve el nucleo usado: Auto elige AVX2 si la CPU lo soporta.
+NucleoPMVLote computePMVLote(const EntradasPMVLote &in, const SalidasPMVLote &out, size_t n,
+                             NucleoPMVLote nucleo = NucleoPMVLote::Auto);
+
+const char *nombreNucleoPMVLote(NucleoPMVLote nucleo);
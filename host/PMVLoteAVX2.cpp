@@ -0,0 +1,9 @@
+// Camino AVX2 de computePMVLote. Este archivo se compila con -mavx2 -mfma
+// (ver Makefile) y solo se llama si la CPU lo soporta.
+#include "PMVLoteNucleo.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+void evaluarLoteAVX2(const EntradasPMVLote &in, const SalidasPMVLote &out, size_t n) {
+	evaluarLote<VAVX2>(in, out, n);
+}
+#endif
@@ -0,0 +1,264 @@
+// Nucleo de computePMVLote, comun a todos los anchos de vector. Se incluye
+// desde PMVLote.cpp (escalar y SSE2) y desde PMVLoteAVX2.cpp, que se compila
+// con -mavx2 -mfma. Todo queda en un espacio de nombres anonimo para que
+// cada unidad tenga su propia copia, compilada con sus propias opciones, y el
+// enlazador no mezcle instrucciones AVX en el camino SSE2.
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+#include "PMV.h"
+#include "PMVLote.h"
+
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+namespace {
+
+
+// El nucleo se escribe una vez sobre un tipo de vector V; cada V aporta las
+// operaciones por carril, las mascaras (resultado de comparaciones) y exp().
+
+// --- Escalar: un carril, mascaras bool --------------------------------------
+struct VEscalar {
+	typedef float T;
+	typedef bool Mascara;
+	static const int kAncho = 1;
+
+	static T cargar(const float *p) { return *p; }
+	static void guardar(float *p, T v) { *p = v; }
+	static T uno(float x) { return x; }
+	static T suma(T a, T b) { return a + b; }
+	static T resta(T a, T b) { return a - b; }
+	static T mul(T a, T b) { return a * b; }
+	static T div(T a, T b) { return a / b; }
+	static T raiz(T a) { return sqrtf(a); }
+	static T minimo(T a, T b) { return fminf(a, b); }
+	static T maximo(T a, T b) { return fmaxf(a, b); }
+	static T abs(T a) { return fabsf(a); }
+	static T exp(T a) { return expf(a); }
+	static Mascara mayor(T a, T b) { return a > b; }
+	static Mascara menor(T a, T b) { return a < b; }
+	static Mascara menorIgual(T a, T b) { return a <= b; }
+	static Mascara mayorIgual(T a, T b) { return a >= b; }
+	static Mascara esNan(T a) { return isnan(a); }
+	static Mascara o(Mascara a, Mascara b) { return a || b; }
+	static Mascara y(Mascara a, Mascara b) { return a && b; }
+	static Mascara yNo(Mascara quitar, Mascara a) { return a && !quitar; }
+	static bool alguna(Mascara m) { return m; }
+	static T elegir(Mascara m, T si, T no) { return m ? si : no; }
+};
+
+#ifdef __SSE2__
+// Polinomio de exp de Cephes (error relativo ~2e-7) con reduccion
+// x = n ln2 + r; 2^n se arma directamente en el exponente IEEE.
+#define PMV_EXP_COEFS(SET1)                                                         \
+	const T c0 = SET1(1.9875691500e-4f), c1 = SET1(1.3981999507e-3f),              \
+	        c2 = SET1(8.3333452e-3f), c3 = SET1(4.1665795894e-2f),                  \
+	        c4 = SET1(1.6666665459e-1f), c5 = SET1(5.0000001201e-1f);
+
+// --- SSE2: 4 carriles (base de x86-64) ---------------------------------------
+struct VSSE2 {
+	typedef __m128 T;
+	typedef __m128 Mascara;
+	static const int kAncho = 4;
+
+	static T cargar(const float *p) { return _mm_loadu_ps(p); }
+	static void guardar(float *p, T v) { _mm_storeu_ps(p, v); }
+	static T uno(float x) { return _mm_set1_ps(x); }
+	static T suma(T a, T b) { return _mm_add_ps(a, b); }
+	static T resta(T a, T b) { return _mm_sub_ps(a, b); }
+	static T mul(T a, T b) { return _mm_mul_ps(a, b); }
+	static T div(T a, T b) { return _mm_div_ps(a, b); }
+	static T raiz(T a) { return _mm_sqrt_ps(a); }
+	static T minimo(T a, T b) { return _mm_min_ps(a, b); }
+	static T maximo(T a, T b) { return _mm_max_ps(a, b); }
+	static T abs(T a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+	static Mascara mayor(T a, T b) { return _mm_cmpgt_ps(a, b); }
+	static Mascara menor(T a, T b) { return _mm_cmplt_ps(a, b); }
+	static Mascara menorIgual(T a, T b) { return _mm_cmple_ps(a, b); }
+	static Mascara mayorIgual(T a, T b) { return _mm_cmpge_ps(a, b); }
+	static Mascara esNan(T a) { return _mm_cmpunord_ps(a, a); }
+	static Mascara o(Mascara a, Mascara b) { return _mm_or_ps(a, b); }
+	static Mascara y(Mascara a, Mascara b) { return _mm_and_ps(a, b); }
+	static Mascara yNo(Mascara quitar, Mascara a) { return _mm_andnot_ps(quitar, a); }
+	static bool alguna(Mascara m) { return _mm_movemask_ps(m) != 0; }
+	static T elegir(Mascara m, T si, T no) { return _mm_or_ps(_mm_and_ps(m, si), _mm_andnot_ps(m, no)); }
+	static T exp(T x) {
+		PMV_EXP_COEFS(_mm_set1_ps)
+		x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-87.0f)), _mm_set1_ps(88.0f));
+		__m128i n = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.44269504f)));
+		T nf = _mm_cvtepi32_ps(n);
+		T r = _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(nf, _mm_set1_ps(0.693359375f))), _mm_mul_ps(nf, _mm_set1_ps(-2.12194440e-4f)));
+		T p = c0;
+		p = _mm_add_ps(_mm_mul_ps(p, r), c1);
+		p = _mm_add_ps(_mm_mul_ps(p, r), c2);
+		p = _mm_add_ps(_mm_mul_ps(p, r), c3);
+		p = _mm_add_ps(_mm_mul_ps(p, r), c4);
+		p = _mm_add_ps(_mm_mul_ps(p, r), c5);
+		T y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, r), r), r), _mm_set1_ps(1.0f));
+		T escala = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+		return _mm_mul_ps(y, escala);
+	}
+};
+
+#endif
+
+#if defined(__AVX2__) && defined(__FMA__)
+// --- AVX2 + FMA: 8 carriles (solo en PMVLoteAVX2.cpp) ------------------------
+struct VAVX2 {
+	typedef __m256 T;
+	typedef __m256 Mascara;
+	static const int kAncho = 8;
+
+	static T cargar(const float *p) { return _mm256_loadu_ps(p); }
+	static void guardar(float *p, T v) { _mm256_storeu_ps(p, v); }
+	static T uno(float x) { return _mm256_set1_ps(x); }
+	static T suma(T a, T b) { return _mm256_add_ps(a, b); }
+	static T resta(T a, T b) { return _mm256_sub_ps(a, b); }
+	static T mul(T a, T b) { return _mm256_mul_ps(a, b); }
+	static T div(T a, T b) { return _mm256_div_ps(a, b); }
+	static T raiz(T a) { return _mm256_sqrt_ps(a); }
+	static T minimo(T a, T b) { return _mm256_min_ps(a, b); }
+	static T maximo(T a, T b) { return _mm256_max_ps(a, b); }
+	static T abs(T a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+	static Mascara mayor(T a, T b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	static Mascara menor(T a, T b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	static Mascara menorIgual(T a, T b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+	static Mascara mayorIgual(T a, T b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+	static Mascara esNan(T a) { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+	static Mascara o(Mascara a, Mascara b) { return _mm256_or_ps(a, b); }
+	static Mascara y(Mascara a, Mascara b) { return _mm256_and_ps(a, b); }
+	static Mascara yNo(Mascara quitar, Mascara a) { return _mm256_andnot_ps(quitar, a); }
+	static bool alguna(Mascara m) { return _mm256_movemask_ps(m) != 0; }
+	static T elegir(Mascara m, T si, T no) { return _mm256_blendv_ps(no, si, m); }
+	static T exp(T x) {
+		PMV_EXP_COEFS(_mm256_set1_ps)
+		x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-87.0f)), _mm256_set1_ps(88.0f));
+		__m256i n = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504f)));
+		T nf = _mm256_cvtepi32_ps(n);
+		T r = _mm256_fnmadd_ps(nf, _mm256_set1_ps(0.693359375f), x);
+		r = _mm256_fnmadd_ps(nf, _mm256_set1_ps(-2.12194440e-4f), r);
+		T p = c0;
+		p = _mm256_fmadd_ps(p, r, c1);
+		p = _mm256_fmadd_ps(p, r, c2);
+		p = _mm256_fmadd_ps(p, r, c3);
+		p = _mm256_fmadd_ps(p, r, c4);
+		p = _mm256_fmadd_ps(p, r, c5);
+		T y = _mm256_add_ps(_mm256_fmadd_ps(_mm256_mul_ps(p, r), r, r), _mm256_set1_ps(1.0f));
+		T escala = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23));
+		return _mm256_mul_ps(y, escala);
+	}
+};
+#endif
+
+// Nucleo: las mismas formulas que nucleoPMV (PMVPerfil.h), con met/clo/va
+// por carril. Los carriles que ya convergieron congelan su T_cl; el bucle
+// sigue mientras quede alguno activo.
+template <class V>
+inline void evaluarBloque(const EntradasPMVLote &in, const SalidasPMVLote &out, size_t i) {
+	typedef typename V::T T;
+	typedef typename V::Mascara Mascara;
+
+	T Ta = V::cargar(in.Ta + i);
+	T Tr = V::cargar(in.Tr + i);
+	T RH = V::cargar(in.RH + i);
+	T met = V::cargar(in.met + i);
+	T clo = V::cargar(in.clo + i);
+	T va = V::cargar(in.va + i);
+
+	Mascara nan = V::o(V::esNan(Ta), V::o(V::esNan(Tr), V::esNan(RH)));
+	const T cero = V::uno(0.0f);
+
+	// Saneado (como computePMV). Los NaN pasan a valores validos para que no
+	// contaminen el bucle; su resultado se descarta al final.
+	Ta = V::elegir(V::o(nan, V::o(V::menor(Ta, V::uno(-10.0f)), V::mayor(Ta, V::uno(50.0f)))), V::uno(25.0f), Ta);
+	Tr = V::elegir(V::o(nan, V::o(V::menor(Tr, V::uno(-10.0f)), V::mayor(Tr, V::uno(50.0f)))), Ta, Tr);
+	RH = V::elegir(nan, cero, V::minimo(V::maximo(RH, cero), V::uno(100.0f)));
+	va = V::elegir(V::menor(va, cero), V::uno(0.1f), va);
+	va = V::maximo(va, V::uno(0.0001f));
+
+	// Terminos del perfil (TerminosPMV por carril)
+	T M = V::mul(met, V::uno(58.15f));
+	T T_sk = V::resta(V::uno(35.7f), V::mul(V::uno(0.028f), M));
+	T f_cl = V::elegir(V::menorIgual(clo, V::uno(0.078f)),
+	                   V::suma(V::uno(1.05f), V::mul(V::uno(0.1f), clo)),
+	                   V::suma(V::uno(1.0f), V::mul(V::uno(0.2f), clo)));
+	T h_cf = V::mul(V::uno(12.1f), V::raiz(va));
+	T g_conv = V::mul(V::mul(clo, V::uno(0.155f)), f_cl);
+	T g_rad = V::mul(g_conv, V::uno(3.96e-8f));
+
+	T p_a = V::mul(V::mul(RH, V::uno(6.105f)),
+	               V::exp(V::div(V::mul(V::uno(17.27f), Ta), V::suma(Ta, V::uno(237.3f)))));
+	T trK = V::suma(Tr, V::uno(273.15f));
+	T trK2 = V::mul(trK, trK);
+	T trK4 = V::mul(trK2, trK2);
+
+	T lo = V::minimo(V::minimo(Ta, Tr), T_sk);
+	T hi = V::maximo(V::maximo(Ta, Tr), T_sk);
+	T T_cl = V::suma(Ta, V::uno(0.1f));
+	T_cl = V::elegir(V::o(V::menorIgual(T_cl, lo), V::mayorIgual(T_cl, hi)), V::mul(V::uno(0.5f), V::suma(lo, hi)), T_cl);
+
+	const T h238 = V::uno(2.38f);
+	Mascara activos = V::mayor(V::uno(1.0f), cero);  // todos
+	for (int it = 0; it < PMV_NEWTON_MAX_ITER && V::alguna(activos); it++) {
+		T d = V::resta(T_cl, Ta);
+		T raiz4 = V::raiz(V::raiz(V::abs(d)));
+		T hn = V::mul(h238, raiz4);
+		Mascara natural = V::mayor(hn, h_cf);
+		T conv = V::mul(g_conv, V::mul(V::elegir(natural, hn, h_cf), d));
+		T dconv = V::mul(g_conv, V::elegir(natural, V::mul(V::uno(2.975f), raiz4), h_cf));
+		T tclK = V::suma(T_cl, V::uno(273.15f));
+		T tclK2 = V::mul(tclK, tclK);
+		T rad = V::mul(g_rad, V::resta(V::mul(tclK2, tclK2), trK4));
+		T drad = V::mul(V::mul(V::uno(4.0f), g_rad), V::mul(tclK2, tclK));
+
+		T f = V::suma(V::resta(T_cl, T_sk), V::suma(rad, conv));
+		Mascara positivo = V::mayor(f, cero);
+		hi = V::elegir(positivo, T_cl, hi);
+		lo = V::elegir(positivo, lo, T_cl);
+
+		T T_new = V::resta(T_cl, V::div(f, V::suma(V::uno(1.0f), V::suma(drad, dconv))));
+		T_new = V::elegir(V::o(V::menorIgual(T_new, lo), V::mayorIgual(T_new, hi)),
+		                  V::mul(V::uno(0.5f), V::suma(lo, hi)), T_new);
+
+		T paso = V::abs(V::resta(T_new, T_cl));
+		T_cl = V::elegir(activos, T_new, T_cl);
+		activos = V::yNo(V::menor(paso, V::uno(PMV_TCL_TOLERANCIA)), activos);
+	}
+
+	// Balance final
+	T hn = V::mul(h238, V::raiz(V::raiz(V::abs(V::resta(T_cl, Ta)))));
+	T h_c = V::maximo(hn, h_cf);
+	T tclK = V::suma(T_cl, V::uno(273.15f));
+	T tclK2 = V::mul(tclK, tclK);
+	T factor = V::suma(V::mul(V::uno(0.303f), V::exp(V::mul(V::uno(-0.036f), M))), V::uno(0.028f));
+	T balance = V::resta(M, V::mul(V::uno(3.05e-3f), V::resta(V::resta(V::uno(5733.0f), V::mul(V::uno(6.99f), M)), p_a)));
+	balance = V::resta(balance, V::mul(V::uno(0.42f), V::resta(M, V::uno(58.15f))));
+	balance = V::resta(balance, V::mul(V::mul(V::uno(1.7e-5f), M), V::resta(V::uno(5867.0f), p_a)));
+	balance = V::resta(balance, V::mul(V::mul(V::uno(0.0014f), M), V::resta(V::uno(34.0f), Ta)));
+	balance = V::resta(balance, V::mul(V::mul(V::uno(3.96e-8f), f_cl), V::resta(V::mul(tclK2, tclK2), trK4)));
+	balance = V::resta(balance, V::mul(V::mul(f_cl, h_c), V::resta(T_cl, Ta)));
+
+	T pmv = V::minimo(V::maximo(V::mul(factor, balance), V::uno(-3.0f)), V::uno(3.0f));
+	pmv = V::elegir(nan, cero, pmv);
+	V::guardar(out.pmv + i, pmv);
+
+	if (out.ppd) {
+		// PPD = 100 - 95 exp(-0.03353 PMV^4 - 0.2179 PMV^2)
+		T p2 = V::mul(pmv, pmv);
+		T e = V::resta(V::mul(V::mul(V::uno(-0.03353f), p2), p2), V::mul(V::uno(0.2179f), p2));
+		V::guardar(out.ppd + i, V::resta(V::uno(100.0f), V::mul(V::uno(95.0f), V::exp(e))));
+	}
+}
+
+template <class V>
+inline void evaluarLote(const EntradasPMVLote &in, const SalidasPMVLote &out, size_t n) {
+	size_t i = 0;
+	for (; i + V::kAncho <= n; i += V::kAncho) evaluarBloque<V>(in, out, i);
+	for (; i < n; i++) evaluarBloque<VEscalar>(in, out, i);  // cola
+}
+
+}  // namespace
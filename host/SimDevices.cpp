@@ -0,0 +1,52 @@
+// Objetos globales de las librerias de host y operaciones del MFRC522.
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "MFRC522.h"
+#include "SPI.h"
+
+HardwareSerial Serial;
+SPIClass SPI;
+EEPROMClass EEPROM;
+
+MFRC522::StatusCode MFRC522::PCD_Authenticate(byte command, byte blockAddr, MIFARE_Key *key, Uid *uid) {
+	(void)command;
+	(void)key;
+	(void)uid;
+	sim::advanceMicros(sim::costs().rfidAuth);
+	if (sim::cardInField() == nullptr || sim::cardHalted()) {
+		_authSector = -1;
+		return STATUS_TIMEOUT;
+	}
+	sim::countRfidAuth();
+	_authSector = blockAddr / 4;
+	return STATUS_OK;
+}
+
+MFRC522::StatusCode MFRC522::MIFARE_Read(byte blockAddr, byte *buffer, byte *bufferSize) {
+	if (buffer == nullptr || bufferSize == nullptr || *bufferSize < 18) return STATUS_NO_ROOM;
+	sim::advanceMicros(sim::costs().rfidRead);
+	const sim::Card *card = sim::cardInField();
+	if (card == nullptr || sim::cardHalted()) return STATUS_TIMEOUT;
+	if (blockAddr >= 64 || _authSector != blockAddr / 4) return STATUS_ERROR;
+	sim::countRfidRead();
+	memcpy(buffer, card->blocks[blockAddr], 16);
+	buffer[16] = 0;
+	buffer[17] = 0;
+	*bufferSize = 18;
+	return STATUS_OK;
+}
+
+const __FlashStringHelper *MFRC522::GetStatusCodeName(StatusCode code) {
+	switch (code) {
+	case STATUS_OK: return F("Success.");
+	case STATUS_ERROR: return F("Error in communication.");
+	case STATUS_COLLISION: return F("Collission detected.");
+	case STATUS_TIMEOUT: return F("Timeout in communication.");
+	case STATUS_NO_ROOM: return F("A buffer is not big enough.");
+	case STATUS_INTERNAL_ERROR: return F("Internal error in the code. Should not happen.");
+	case STATUS_INVALID: return F("Invalid argument.");
+	case STATUS_CRC_WRONG: return F("The CRC_A does not match.");
+	case STATUS_MIFARE_NACK: return F("A MIFARE PICC responded with NAK.");
+	default: return F("Unknown error");
+	}
+}
@@ -0,0 +1,473 @@
+// Implementacion del mundo simulado (ver include/SimHAL.h).
+#include "SimHAL.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace sim {
+
+namespace {
+
+const float kPi = 3.14159265f;
+
+uint64_t g_now = 0;
+uint64_t g_roomAccum = 0;
+uint32_t g_rng = 0x2545F491u;
+
+struct Pin {
+	uint8_t mode = 0;
+	int out = 0;
+	int in = 1;
+	int analog = -1;
+	uint32_t toggles = 0;
+};
+Pin g_pins[70];
+std::multimap<uint64_t, std::pair<uint8_t, int> > g_pinSchedule;
+
+TimerIsr g_timerIsr = nullptr;
+uint32_t g_timerPeriod = 1024;
+bool g_timerPending = false;
+uint64_t g_timerAt = 0;
+uint64_t g_timerCalls = 0;
+
+RoomModel g_room = {
+	24.0f, 24.0f, 55.0f,   // Ta, Tr, RH
+	24.0f, 9.0f,           // exterior
+	60.0f,                 // tau
+	0.25f, 0.30f,          // rele / servo
+	1.5f,                  // ruido ADC
+	25, 26, 54             // RELAY_PIN, SERVO_PIN, A0
+};
+float g_dhtFailure = 0.0f;
+uint32_t g_dhtReads = 0;
+std::map<uint8_t, int> g_servo;
+
+unsigned long g_baud = 0;
+float g_txQueued = 0.0f;
+uint64_t g_txLastDrain = 0;
+uint64_t g_txBytes = 0;
+uint64_t g_txBlocked = 0;
+SerialTap g_tap = nullptr;
+std::deque<char> g_rx;
+const int kTxBuffer = 64;
+
+std::multimap<uint64_t, char> g_keys;
+
+struct CardWindow {
+	Card card;
+	uint64_t from, to;
+	bool halted;
+};
+std::vector<CardWindow> g_cards;
+uint32_t g_rfidAuths = 0;
+uint32_t g_rfidReads = 0;
+
+char g_ddram[2][40];
+char g_lcdLines[2][17];
+uint32_t g_lcdClears = 0;
+uint32_t g_lcdBytes = 0;
+
+uint8_t g_eeprom[kEepromSize];
+uint32_t g_eepromWear[kEepromSize];
+uint32_t g_eepromWrites = 0;
+bool g_eepromInit = false;
+
+long g_heapUsado = 0;
+long g_heapMaximo = 0;
+
+StateHook g_stateHook = nullptr;
+
+Costs g_costs = { 23000, 112, 2000, 100, 5000, 3000, 25000, 3300 };
+
+void initEeprom() {
+	if (g_eepromInit) return;
+	memset(g_eeprom, 0xFF, sizeof(g_eeprom));
+	memset(g_eepromWear, 0, sizeof(g_eepromWear));
+	g_eepromInit = true;
+}
+
+void drainTx() {
+	if (g_baud == 0) return;
+	float byteUs = 10.0e6f / (float)g_baud;
+	float drained = (float)(g_now - g_txLastDrain) / byteUs;
+	g_txLastDrain = g_now;
+	g_txQueued = drained >= g_txQueued ? 0.0f : g_txQueued - drained;
+}
+
+// Codigo ADC sin cuantizar del divisor NTC a la temperatura T. Mismo divisor
+// que temperaturaNTC() (Sensores.h): 10k serie, NTC beta 3950
+float ntcCodigo(float T) {
+	const float beta = 3950.0f, R0 = 10.0f, T0 = 298.15f, resistance = 10.0f;
+	float Rntc = R0 * expf(beta * (1.0f / (T + 273.15f) - 1.0f / T0));
+	float Vout = 5.0f * Rntc / (resistance + Rntc);
+	return Vout * 1023.0f / 5.0f;
+}
+
+}  // namespace
+
+// --- Reloj ---------------------------------------------------------------
+uint64_t nowMicros() { return g_now; }
+
+namespace {
+
+void stepClock(uint64_t us) {
+	g_now += us;
+	g_roomAccum += us;
+	while (g_roomAccum >= 1000000ULL) {
+		g_roomAccum -= 1000000ULL;
+		stepRoom(1.0f);
+	}
+}
+
+// Los niveles programados y la interrupcion corren en su instante, en orden;
+// a igual instante la interrupcion muestrea antes del cambio. Con wake, se
+// detiene tras la interrupcion que lo ponga en true.
+void advanceUntil(uint64_t end, WakeCheck wake) {
+	for (;;) {
+		bool pin = !g_pinSchedule.empty() && g_pinSchedule.begin()->first <= end;
+		uint64_t at = pin ? g_pinSchedule.begin()->first : end;
+		bool isr = g_timerPending && g_timerAt <= at;
+		if (isr) at = g_timerAt;
+		else if (!pin) break;
+		if (at > g_now) stepClock(at - g_now);
+		if (isr) {
+			g_timerPending = false;
+			g_timerCalls++;
+			g_timerIsr();
+			if (wake && wake()) return;
+		} else {
+			std::pair<uint8_t, int> v = g_pinSchedule.begin()->second;
+			g_pinSchedule.erase(g_pinSchedule.begin());
+			setDigitalInput(v.first, v.second);
+		}
+	}
+	if (end > g_now) stepClock(end - g_now);
+}
+
+}  // namespace
+
+void advanceMicros(uint64_t us) { advanceUntil(g_now + us, nullptr); }
+
+uint64_t sleepMicros(uint64_t us, WakeCheck wake) {
+	uint64_t from = g_now;
+	advanceUntil(g_now + us, wake);
+	return g_now - from;
+}
+
+void resetClock() {
+	g_now = 0;
+	g_roomAccum = 0;
+	g_txLastDrain = 0;
+	g_txQueued = 0.0f;
+}
+
+// --- Aleatorio -----------------------------------------------------------
+void seedRandom(uint32_t seed) { g_rng = seed ? seed : 0x2545F491u; }
+
+uint32_t randomU32() {
+	g_rng ^= g_rng << 13;
+	g_rng ^= g_rng >> 17;
+	g_rng ^= g_rng << 5;
+	return g_rng;
+}
+
+float randomUniform(float lo, float hi) {
+	return lo + (hi - lo) * (float)(randomU32() & 0xFFFFFF) / (float)0xFFFFFF;
+}
+
+// --- Pines ---------------------------------------------------------------
+void pinMode(uint8_t pin, uint8_t mode) {
+	if (pin >= 70) return;
+	g_pins[pin].mode = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+	if (pin >= 70) return;
+	int v = val ? 1 : 0;
+	if (g_pins[pin].out != v) g_pins[pin].toggles++;
+	g_pins[pin].out = v;
+}
+
+int digitalRead(uint8_t pin) {
+	if (pin >= 70) return 0;
+	return g_pins[pin].in;
+}
+
+int analogRead(uint8_t pin) {
+	advanceMicros(g_costs.analogRead);
+	if (pin < 70 && g_pins[pin].analog >= 0) return g_pins[pin].analog;
+	if (pin == g_room.ntcPin) {
+		// El ruido se suma antes de cuantizar, como en el ADC real
+		float noise = randomUniform(-g_room.adcNoiseLsb, g_room.adcNoiseLsb);
+		int v = (int)lroundf(ntcCodigo(g_room.Tr) + noise);
+		return v < 0 ? 0 : (v > 1023 ? 1023 : v);
+	}
+	return 0;
+}
+
+int pinOutput(uint8_t pin) { return pin < 70 ? g_pins[pin].out : 0; }
+uint32_t pinToggles(uint8_t pin) { return pin < 70 ? g_pins[pin].toggles : 0; }
+
+void setDigitalInput(uint8_t pin, int val) {
+	if (pin >= 70) return;
+	int v = val ? 1 : 0;
+	if (g_pins[pin].in == v) return;
+	g_pins[pin].in = v;
+	if (g_timerIsr && !g_timerPending) {
+		g_timerPending = true;
+		g_timerAt = (g_now / g_timerPeriod + 1) * g_timerPeriod;
+	}
+}
+
+void scheduleDigitalInput(uint64_t atMicros, uint8_t pin, int val) {
+	g_pinSchedule.insert(std::make_pair(atMicros, std::make_pair(pin, val)));
+}
+
+void setAnalogInput(uint8_t pin, int val) { if (pin < 70) g_pins[pin].analog = val; }
+
+// --- Interrupcion de temporizador ------------------------------------------
+void attachTimerIsr(TimerIsr isr, uint32_t periodUs) {
+	g_timerIsr = isr;
+	g_timerPeriod = periodUs ? periodUs : 1;
+	g_timerPending = false;
+}
+
+uint64_t timerIsrCalls() { return g_timerCalls; }
+
+// --- Serie ---------------------------------------------------------------
+void serialBegin(unsigned long baud) {
+	g_baud = baud;
+	g_txQueued = 0.0f;
+	g_txLastDrain = g_now;
+}
+
+void serialWrite(uint8_t c) {
+	if (g_tap) g_tap(c);
+	g_txBytes++;
+	if (g_baud == 0) return;
+	drainTx();
+	if (g_txQueued >= (float)(kTxBuffer - 1)) {
+		// Buffer lleno: HardwareSerial espera a que salga un byte
+		float byteUs = 10.0e6f / (float)g_baud;
+		uint64_t wait = (uint64_t)ceilf((g_txQueued - (float)(kTxBuffer - 2)) * byteUs);
+		g_txBlocked += wait;
+		advanceMicros(wait);
+		drainTx();
+	}
+	g_txQueued += 1.0f;
+}
+
+int serialAvailableForWrite() {
+	drainTx();
+	int used = (int)ceilf(g_txQueued);
+	return kTxBuffer - 1 - used;
+}
+
+void serialFlush() {
+	drainTx();
+	if (g_baud == 0 || g_txQueued <= 0.0f) return;
+	uint64_t wait = (uint64_t)ceilf(g_txQueued * 10.0e6f / (float)g_baud);
+	g_txBlocked += wait;
+	advanceMicros(wait);
+	drainTx();
+}
+
+int serialAvailable() { return (int)g_rx.size(); }
+
+int serialRead() {
+	if (g_rx.empty()) return -1;
+	char c = g_rx.front();
+	g_rx.pop_front();
+	return (uint8_t)c;
+}
+
+int serialPeek() { return g_rx.empty() ? -1 : (uint8_t)g_rx.front(); }
+
+void serialInject(const char *text) {
+	while (*text) g_rx.push_back(*text++);
+}
+
+void setSerialTap(SerialTap tap) { g_tap = tap; }
+uint64_t serialBytesWritten() { return g_txBytes; }
+uint64_t serialBlockedMicros() { return g_txBlocked; }
+
+// --- Sala ----------------------------------------------------------------
+RoomModel &room() { return g_room; }
+
+void stepRoom(float seconds) {
+	float days = (float)((double)g_now / 86400.0e6);
+	float outdoor = g_room.outdoorMean + g_room.outdoorSwing * sinf(2.0f * kPi * (days - 0.375f));
+	float minutes = seconds / 60.0f;
+	float dTa = (outdoor - g_room.Ta) / g_room.tauMinutes * minutes;
+	if (pinOutput(g_room.relayPin)) dTa -= g_room.coolingPerMin * minutes;
+	if (servoAngle(g_room.servoPin) >= 45) dTa += g_room.heatingPerMin * minutes;
+	g_room.Ta += dTa;
+	g_room.Tr += (g_room.Ta + 0.1f * (outdoor - g_room.Ta) - g_room.Tr) / 20.0f * minutes;
+	float rhTarget = 55.0f - 1.5f * (g_room.Ta - 24.0f);
+	g_room.RH += (rhTarget - g_room.RH) / 30.0f * minutes;
+	g_room.RH = g_room.RH < 5.0f ? 5.0f : (g_room.RH > 95.0f ? 95.0f : g_room.RH);
+}
+
+void setDhtFailureRate(float p) { g_dhtFailure = p; }
+
+bool dhtSample(float &t, float &h) {
+	advanceMicros(g_costs.dhtRead);
+	g_dhtReads++;
+	if (g_dhtFailure > 0.0f && randomUniform(0.0f, 1.0f) < g_dhtFailure) {
+		t = NAN;
+		h = NAN;
+		return false;
+	}
+	// DHT11: resolucion de 1 C y 1 %
+	t = roundf(g_room.Ta);
+	h = roundf(g_room.RH);
+	return true;
+}
+
+uint32_t dhtBusReads() { return g_dhtReads; }
+
+int ntcAdcForTemperature(float T) {
+	return (int)lroundf(ntcCodigo(T));
+}
+
+// --- Servo ---------------------------------------------------------------
+void servoWrite(uint8_t pin, int angle) { g_servo[pin] = angle; }
+
+int servoAngle(uint8_t pin) {
+	std::map<uint8_t, int>::const_iterator it = g_servo.find(pin);
+	return it == g_servo.end() ? 0 : it->second;
+}
+
+// --- Teclado -------------------------------------------------------------
+void scheduleKey(uint64_t atMicros, char key) { g_keys.insert(std::make_pair(atMicros, key)); }
+
+void scheduleKeys(uint64_t atMicros, const char *keys, uint32_t gapMs) {
+	for (; *keys; keys++, atMicros += (uint64_t)gapMs * 1000ULL) scheduleKey(atMicros, *keys);
+}
+
+char nextKey() {
+	if (g_keys.empty() || g_keys.begin()->first > g_now) return '\0';
+	char k = g_keys.begin()->second;
+	g_keys.erase(g_keys.begin());
+	return k;
+}
+
+size_t pendingKeys() { return g_keys.size(); }
+
+// --- RFID ----------------------------------------------------------------
+void presentCard(const Card &card, uint64_t fromMicros, uint64_t toMicros) {
+	CardWindow w;
+	w.card = card;
+	w.from = fromMicros;
+	w.to = toMicros;
+	w.halted = false;
+	g_cards.push_back(w);
+}
+
+static CardWindow *activeWindow() {
+	for (size_t i = 0; i < g_cards.size(); i++) {
+		if (g_cards[i].to <= g_now) {
+			g_cards.erase(g_cards.begin() + i);
+			i--;
+			continue;
+		}
+		if (g_cards[i].from <= g_now) return &g_cards[i];
+	}
+	return nullptr;
+}
+
+const Card *cardInField() {
+	CardWindow *w = activeWindow();
+	return w ? &w->card : nullptr;
+}
+
+bool cardHalted() {
+	CardWindow *w = activeWindow();
+	return w ? w->halted : false;
+}
+
+void haltCard() {
+	CardWindow *w = activeWindow();
+	if (w) w->halted = true;
+}
+
+uint32_t rfidAuths() { return g_rfidAuths; }
+uint32_t rfidBlockReads() { return g_rfidReads; }
+
+void countRfidAuth() { g_rfidAuths++; }
+void countRfidRead() { g_rfidReads++; }
+
+// --- LCD -----------------------------------------------------------------
+void lcdCommand(bool clear) {
+	if (clear) {
+		memset(g_ddram, ' ', sizeof(g_ddram));
+		g_lcdClears++;
+		advanceMicros(g_costs.lcdClear);
+	} else {
+		advanceMicros(g_costs.lcdByte);
+	}
+	g_lcdBytes++;
+}
+
+void lcdData(uint8_t row, uint8_t col, char c) {
+	if (row < 2 && col < 40) g_ddram[row][col] = c;
+	g_lcdBytes++;
+	advanceMicros(g_costs.lcdByte);
+}
+
+const char *lcdLine(uint8_t row) {
+	if (row > 1) row = 1;
+	memcpy(g_lcdLines[row], g_ddram[row], 16);
+	g_lcdLines[row][16] = '\0';
+	return g_lcdLines[row];
+}
+
+uint32_t lcdClears() { return g_lcdClears; }
+uint32_t lcdBytes() { return g_lcdBytes; }
+
+// --- EEPROM --------------------------------------------------------------
+uint8_t eepromRead(int addr) {
+	initEeprom();
+	if (addr < 0 || (size_t)addr >= kEepromSize) return 0xFF;
+	return g_eeprom[addr];
+}
+
+void eepromWrite(int addr, uint8_t v) {
+	initEeprom();
+	if (addr < 0 || (size_t)addr >= kEepromSize) return;
+	g_eeprom[addr] = v;
+	g_eepromWear[addr]++;
+	g_eepromWrites++;
+	advanceMicros(g_costs.eepromWrite);
+}
+
+uint32_t eepromWrites(int addr) {
+	initEeprom();
+	return (addr < 0 || (size_t)addr >= kEepromSize) ? 0 : g_eepromWear[addr];
+}
+
+uint32_t eepromTotalWrites() { return g_eepromWrites; }
+
+// --- Heap ----------------------------------------------------------------
+void heapReservar(long bytes) {
+	g_heapUsado += bytes;
+	if (g_heapUsado > g_heapMaximo) g_heapMaximo = g_heapUsado;
+}
+
+size_t heapUsado() { return (size_t)g_heapUsado; }
+size_t heapMaximo() { return (size_t)g_heapMaximo; }
+
+// --- Ganchos -------------------------------------------------------------
+void setStateHook(StateHook hook) { g_stateHook = hook; }
+
+void notifyStateChange(uint8_t from, uint8_t to) {
+	if (g_stateHook) g_stateHook(from, to);
+}
+
+Costs &costs() { return g_costs; }
+
+}  // namespace sim
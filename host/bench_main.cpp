@@ -0,0 +1,366 @@
+// Benchmarks de host. Ejecuta las mismas rutinas que la placa corre con
+// SMARTCOMFORT_BENCH (medidas con el reloj real del PC) y ademas barridos de
+// precision densos que en el AVR tardarian demasiado.
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <memory>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+#include "Arduino.h"
+#include "ConfortISO.h"
+#include "Eventos.h"
+#include "PMV.h"
+#include "PMVBench.h"
+#include "PMVLote.h"
+#include "Planificador.h"
+#include "Zona.h"
+
+namespace {
+
+class StdoutPrint : public Print {
+public:
+	size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+	using Print::write;
+};
+
+unsigned long relojReal() {
+	static const std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+	return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - inicio).count();
+}
+
+// Barrido de todo el rango que sanea computePMV: Ta, Tr en -10..50 C y RH en
+// 0..100 %, con el perfil fijo del sketch.
+void barridoSolver() {
+	float maxDif = 0.0f, maxTcl = 0.0f;
+	unsigned maxIter = 0;
+	unsigned long n = 0, iterTotal = 0, sinConvergencia = 0;
+	for (float Ta = -10.0f; Ta <= 50.0f; Ta += 0.5f) {
+		for (float Tr = -10.0f; Tr <= 50.0f; Tr += 2.0f) {
+			for (float RH = 0.0f; RH <= 100.0f; RH += 10.0f) {
+				resetPMVArranque();
+				PMVResult a = computePMV(Ta, Tr, RH, 1.0f, 0.61f, 0.1f);
+				PMVResult b = computePMVPuntoFijo(Ta, Tr, RH, 1.0f, 0.61f, 0.1f);
+				if (a.iteraciones > maxIter) maxIter = a.iteraciones;
+				iterTotal += a.iteraciones;
+				n++;
+				if (b.iteraciones >= 200) {
+					sinConvergencia++;
+					continue;
+				}
+				maxDif = fmaxf(maxDif, fabsf(a.pmv - b.pmv));
+				maxTcl = fmaxf(maxTcl, fabsf(a.t_cl - b.t_cl));
+			}
+		}
+	}
+	printf("barrido completo (%lu puntos, arranque en frio): iter media=%.2f  max=%u (tope %d)\n",
+	       n, (double)iterTotal / (double)n, maxIter, PMV_NEWTON_MAX_ITER);
+	printf("  donde el punto fijo converge: max |dPMV|=%.6f  max |dT_cl|=%.6f C\n", maxDif, maxTcl);
+	printf("  punto fijo sin converger (200 pasos): %lu puntos\n", sinConvergencia);
+}
+
+// Error de un motor del perfil fijo frente a computePMV en una rejilla densa
+// que no coincide con los nodos de las tablas.
+void barridoMotor(const char *nombre, PMVResult (*motor)(float, float, float)) {
+	float maxErr = 0.0f, maxConfort = 0.0f;
+	double sumaCuad = 0.0;
+	unsigned long n = 0;
+	for (float Ta = -10.0f; Ta <= 50.0f; Ta += 0.37f) {
+		for (float Tr = -10.0f; Tr <= 50.0f; Tr += 0.71f) {
+			for (float RH = 0.0f; RH <= 100.0f; RH += 3.3f) {
+				float ref = computePMV(Ta, Tr, RH, PMV_MET, PMV_CLO, PMV_VA).pmv;
+				float err = fabsf(motor(Ta, Tr, RH).pmv - ref);
+				maxErr = fmaxf(maxErr, err);
+				if (fabsf(ref) <= 2.0f) maxConfort = fmaxf(maxConfort, err);
+				sumaCuad += (double)err * err;
+				n++;
+			}
+		}
+	}
+	printf("%s (%lu puntos): max |err|=%.4f  max |err| con |PMV|<=2: %.4f  rms=%.4f\n",
+	       nombre, n, maxErr, maxConfort, sqrt(sumaCuad / (double)n));
+}
+
+// Error de cada motor que usa el proyecto frente a computeConfortISO, con el
+// perfil fijo, en el rango de validez de la norma (Ta 10..30 C, Tr 10..40 C,
+// RH 0..100 %) y con la referencia recortada a +-3 como los motores. El
+// lote se evalua de una vez sobre los mismos puntos y, como computePMV, en
+// las filas del anexo D.
+PMVResult motorNewtonPerfil(float Ta, float Tr, float RH) {
+	return computePMV(Ta, Tr, RH, PMV_MET, PMV_CLO, PMV_VA);
+}
+
+PMVResult motorLote(float Ta, float Tr, float RH, float met, float clo, float va) {
+	float pmv;
+	EntradasPMVLote in = { &Ta, &Tr, &RH, &met, &clo, &va };
+	SalidasPMVLote out = { &pmv, nullptr };
+	computePMVLote(in, out, 1);
+	return { pmv, NAN, 0 };
+}
+
+void barridoISO() {
+	std::vector<float> Ta, Tr, RH, met, clo, va, ref;
+	for (float a = 10.0f; a <= 30.0f; a += 0.37f) {
+		for (float r = 10.0f; r <= 40.0f; r += 0.71f) {
+			for (float h = 0.0f; h <= 100.0f; h += 3.3f) {
+				Ta.push_back(a);
+				Tr.push_back(r);
+				RH.push_back(h);
+				ref.push_back(fmaxf(-3.0f, fminf(3.0f, computeConfortISO(a, r, h, PMV_VA, PMV_MET, PMV_CLO).pmv)));
+			}
+		}
+	}
+	size_t n = Ta.size();
+	met.assign(n, PMV_MET);
+	clo.assign(n, PMV_CLO);
+	va.assign(n, PMV_VA);
+	std::vector<float> lote(n);
+	EntradasPMVLote in = { Ta.data(), Tr.data(), RH.data(), met.data(), clo.data(), va.data() };
+	SalidasPMVLote out = { lote.data(), nullptr };
+	NucleoPMVLote nucleo = computePMVLote(in, out, n);
+
+	struct Motor {
+		const char *nombre;
+		PMVResult (*motor)(float, float, float);
+	};
+	const Motor motores[] = {
+		{ "Newton      ", motorNewtonPerfil },
+		{ "tabla flash ", computePMVTabla },
+		{ "punto fijo Q", computePMVFijo },
+		{ "lote        ", nullptr },
+	};
+	printf("--- Precision frente a ISO 7730 en su rango de validez (%zu puntos) ---\n", n);
+	for (const Motor &m : motores) {
+		float maxErr = 0.0f, maxConfort = 0.0f;
+		double sumaCuad = 0.0;
+		for (size_t i = 0; i < n; i++) {
+			float pmv = m.motor ? m.motor(Ta[i], Tr[i], RH[i]).pmv : lote[i];
+			float err = fabsf(pmv - ref[i]);
+			maxErr = fmaxf(maxErr, err);
+			if (fabsf(ref[i]) <= 2.0f) maxConfort = fmaxf(maxConfort, err);
+			sumaCuad += (double)err * err;
+		}
+		printf("%s: max |err|=%.4f  max |err| con |PMV|<=2: %.4f  rms=%.4f", m.nombre, maxErr, maxConfort,
+		       sqrt(sumaCuad / (double)n));
+		if (m.motor == nullptr) printf("  anexo D=%.4f (%s)", errorAnexoD(motorLote), nombreNucleoPMVLote(nucleo));
+		printf("\n");
+	}
+}
+
+double segundosDesde(std::chrono::steady_clock::time_point t0) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Rendimiento de computePMVLote frente a computePMV muestra a muestra sobre
+// registros sinteticos de muchas salas, con perfiles met/clo/va variados
+void benchmarkLote(size_t n) {
+	std::vector<float> Ta(n), Tr(n), RH(n), met(n), clo(n), va(n);
+	std::vector<float> pmvRef(n), ppdRef(n), pmv(n), ppd(n);
+	sim::seedRandom(7);
+	for (size_t i = 0; i < n; i++) {
+		Ta[i] = sim::randomUniform(10.0f, 35.0f);
+		Tr[i] = Ta[i] + sim::randomUniform(-5.0f, 5.0f);
+		RH[i] = sim::randomUniform(10.0f, 90.0f);
+		met[i] = sim::randomUniform(0.8f, 2.5f);
+		clo[i] = sim::randomUniform(0.3f, 1.5f);
+		va[i] = sim::randomUniform(0.05f, 0.8f);
+	}
+	Ta[n / 2] = NAN;  // lectura fallida en medio del lote
+
+	std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < n; i++) {
+		float p = computePMV(Ta[i], Tr[i], RH[i], met[i], clo[i], va[i]).pmv;
+		pmvRef[i] = p;
+		ppdRef[i] = 100.0f - 95.0f * expf(-0.03353f * p * p * p * p - 0.2179f * p * p);
+	}
+	double segEscalar = segundosDesde(t0);
+	printf("--- PMV por lotes (%zu muestras) ---\n", n);
+	printf("computePMV escalar : %6.2f Meval/s\n", (double)n / segEscalar / 1.0e6);
+
+	EntradasPMVLote in = { Ta.data(), Tr.data(), RH.data(), met.data(), clo.data(), va.data() };
+	SalidasPMVLote out = { pmv.data(), ppd.data() };
+	const NucleoPMVLote nucleos[] = { NucleoPMVLote::Escalar, NucleoPMVLote::SSE2, NucleoPMVLote::AVX2 };
+	for (NucleoPMVLote pedido : nucleos) {
+		t0 = std::chrono::steady_clock::now();
+		NucleoPMVLote usado = computePMVLote(in, out, n, pedido);
+		double seg = segundosDesde(t0);
+		if (usado != pedido) {
+			printf("lote %-7s      : no disponible en esta CPU\n", nombreNucleoPMVLote(pedido));
+			continue;
+		}
+		float maxPmv = 0.0f, maxPpd = 0.0f;
+		for (size_t i = 0; i < n; i++) {
+			maxPmv = fmaxf(maxPmv, fabsf(pmv[i] - pmvRef[i]));
+			maxPpd = fmaxf(maxPpd, fabsf(ppd[i] - ppdRef[i]));
+		}
+		printf("lote %-7s      : %6.2f Meval/s  x%.1f  max|dPMV|=%.5f  max|dPPD|=%.4f\n", nombreNucleoPMVLote(usado),
+		       (double)n / seg / 1.0e6, segEscalar / seg, maxPmv, maxPpd);
+	}
+}
+
+// Salas sin pantalla atendidas en rueda, una por turno, como taskZonas del
+// sketch. Corre en tiempo virtual con los costos de bus del AVR (DHT11 y
+// ADC) mas un costo fijo por cada calculo de PMV, que el reloj virtual no
+// mide. Una sala de cada tres esta caliente, una fria y una en confort, para
+// recorrer los periodos de 7 s, 5 s y 3 s; las alarmas se reconocen al
+// momento. Cumple si ningun vencimiento se atiende con mas atraso que el 10 %
+// del periodo mas corto.
+const uint32_t kCostoPMVus = 2000;  // evaluarPMV en el AVR, aprox.
+const unsigned long kToleranciaMs = ZONA_PERIODO_CALENTANDO_MS / 10;
+
+std::vector<std::unique_ptr<Zona>> g_zonas;
+size_t g_turno = 0;
+
+void turnoZona() {
+	Zona &z = *g_zonas[g_turno];
+	g_turno = (g_turno + 1) % g_zonas.size();
+	unsigned long ahora = millis();
+	if (z.modo() == Zona::ALARMA) z.reconocerAlarma(ahora);
+	if ((long)(ahora - z.vencimiento()) >= 0) sim::advanceMicros(kCostoPMVus);
+	z.regular(ahora);
+}
+
+unsigned long atrasoConZonas(size_t n, float minutos) {
+	static Planificador plan;
+	static Tarea turno(ZONA_TURNO_MS, true, turnoZona, plan);
+	const float Tr[] = { 40.0f, 5.0f, 24.0f };
+
+	sim::resetClock();
+	g_zonas.clear();
+	g_turno = 0;
+	for (size_t i = 0; i < n; i++) {
+		uint8_t pinNTC = (uint8_t)(A0 + i);
+		sim::setAnalogInput(pinNTC, sim::ntcAdcForTemperature(Tr[i % 3]));
+		g_zonas.emplace_back(new Zona((uint8_t)i, (uint8_t)(30 + i), pinNTC, (uint8_t)(2 + i), (uint8_t)(2 + i)));
+		g_zonas.back()->begin();
+	}
+
+	turno.Start();
+	unsigned long fin = millis() + (unsigned long)(minutos * 60000.0f);
+	while ((long)(millis() - fin) < 0) {
+		plan.Ejecutar(millis());
+		delay(plan.Espera(millis(), 10));
+	}
+	turno.Stop();
+
+	unsigned long peor = 0;
+	for (size_t i = 0; i < n; i++) {
+		if (g_zonas[i]->atrasoMaximo() > peor) peor = g_zonas[i]->atrasoMaximo();
+		sim::setAnalogInput((uint8_t)(A0 + i), -1);
+	}
+	return peor;
+}
+
+void benchmarkZonas() {
+	printf("--- Salas por placa (turno de %d ms, tolerancia %lu ms) ---\n", ZONA_TURNO_MS, kToleranciaMs);
+	size_t maximo = 0;
+	for (size_t n = 1; n <= 16; n++) {
+		unsigned long atraso = atrasoConZonas(n, 30.0f);
+		bool cumple = atraso <= kToleranciaMs;
+		if (cumple && maximo == n - 1) maximo = n;
+		printf("salas=%2zu atraso max=%5lu ms %s\n", n, atraso, cumple ? "" : "(fuera de tolerancia)");
+	}
+	printf("maximo de salas en tiempo: %zu (16 entradas analogicas en la placa)\n", maximo);
+}
+
+// Cola de eventos de la maquina (ColaSPSC.h). En un hilo: costo de poner y
+// sacar un Evento. En dos hilos, como una interrupcion y el loop: el
+// productor pone numeros de secuencia con su instante y el consumidor
+// verifica el orden y mide la latencia, con el productor a toda velocidad
+// (la cola se llena y reintenta) y con un evento cada 2 us. Las esperas
+// ceden la CPU: con un solo nucleo la latencia es la del planificador del
+// sistema operativo.
+struct MuestraCola {
+	uint32_t secuencia;
+	std::chrono::steady_clock::time_point instante;
+};
+
+typedef ColaSPSC<MuestraCola, 128> ColaBench;
+
+void colaEntreHilos(const char *nombre, size_t n, double espaciadoUs) {
+	static ColaBench cola;
+	cola = ColaBench{};
+	std::vector<double> latenciasNs(n);
+	unsigned long reintentos = 0;
+	bool enOrden = true;
+
+	std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+	std::thread productor([&]() {
+		std::chrono::steady_clock::time_point proximo = std::chrono::steady_clock::now();
+		const std::chrono::nanoseconds paso((long long)(espaciadoUs * 1000.0));
+		for (size_t i = 0; i < n; i++) {
+			if (espaciadoUs > 0.0) {
+				while (std::chrono::steady_clock::now() < proximo) std::this_thread::yield();
+				proximo += paso;
+			}
+			MuestraCola m = { (uint32_t)i, std::chrono::steady_clock::now() };
+			while (!cola.poner(m)) {
+				reintentos++;
+				std::this_thread::yield();
+			}
+		}
+	});
+	for (size_t i = 0; i < n; i++) {
+		MuestraCola m;
+		while (!cola.sacar(m)) std::this_thread::yield();
+		if (m.secuencia != (uint32_t)i) enOrden = false;
+		latenciasNs[i] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - m.instante).count();
+	}
+	productor.join();
+	double seg = segundosDesde(t0);
+
+	std::sort(latenciasNs.begin(), latenciasNs.end());
+	printf("%s: %6.2f Meventos/s  latencia p50=%.0f ns p99=%.0f ns max=%.0f ns  reintentos=%lu  %s\n", nombre,
+	       (double)n / seg / 1.0e6, latenciasNs[n / 2], latenciasNs[n * 99 / 100], latenciasNs[n - 1], reintentos,
+	       enOrden ? "en orden" : "FUERA DE ORDEN");
+}
+
+void benchmarkColaEventos(size_t n) {
+	printf("--- Cola de eventos SPSC (%zu eventos, capacidad %u/%u, %u nucleos) ---\n", n,
+	       ColaEventos::capacidad(), ColaBench::capacidad(), std::thread::hardware_concurrency());
+	static ColaEventos eventos;
+	volatile uint8_t sumidero = 0;
+	std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < n; i++) {
+		Evento e = { (uint8_t)(i & 7), 0, (uint16_t)i };
+		eventos.poner(e);
+		eventos.sacar(e);
+		sumidero += e.entrada;
+	}
+	double seg = segundosDesde(t0);
+	printf("un hilo, poner + sacar : %6.2f ns por evento\n", seg * 1.0e9 / (double)n);
+	colaEntreHilos("dos hilos, rafaga     ", n / 4, 0.0);
+	colaEntreHilos("dos hilos, cada 2 us  ", n / 32, 2.0);
+}
+
+}  // namespace
+
+int main() {
+	StdoutPrint out;
+	bool referenciaOk = benchmarkReferenciaISO(out);
+	benchmarkSolverPMV(out, relojReal, 5000);
+	barridoSolver();
+	benchmarkMotoresPMV(out, relojReal, 5000);
+	barridoMotor("tabla flash ", computePMVTabla);
+	barridoMotor("punto fijo Q", computePMVFijo);
+	barridoISO();
+	benchmarkPMVIncremental(out, relojReal, 60000);
+	benchmarkConsignaPMV(out, relojReal, 60000);
+	benchmarkLote(1u << 21);
+	benchmarkPlanificador(out, relojReal, 50000);
+	benchmarkMaquinaEstados(out, relojReal, 50000);
+	benchmarkColaEventos(1u << 21);
+	benchmarkNTC(out, relojReal, 2000);
+	// Sala fija a 24 C: el desvio de Tr es solo el ruido del ADC
+	sim::RoomModel &sala = sim::room();
+	sala.Ta = sala.Tr = sala.outdoorMean = 24.0f;
+	sala.outdoorSwing = 0.0f;
+	benchmarkRuidoNTC(out, sala.ntcPin, 2000);
+	printf("Tr real de la sala: %.3f C\n", sala.Tr);
+	benchmarkZonas();
+	// El motor de referencia tiene que reproducir la tabla de la norma
+	return referenciaOk ? 0 : 1;
+}
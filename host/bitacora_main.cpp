@@ -0,0 +1,44 @@
+// Convierte en texto la bitacora binaria que el sketch envia por el puerto
+// serie (capturada de la placa o con smartcomfort_sim --serie). Si la
+// captura incluye un volcado del historial (comando 'H'), tambien lo imprime.
+// Con --traza guarda la traza de entradas de un build con SMARTCOMFORT_TRAZA
+// (Traza.h), para smartcomfort_sim --reproducir.
+//
+//   smartcomfort_log [--traza SALIDA] [archivo]     (sin archivo lee la entrada estandar)
+#include <stdio.h>
+#include <string.h>
+
+#include "DecodificadorBitacora.h"
+
+int main(int argc, char **argv) {
+	FILE *in = stdin;
+	FILE *traza = nullptr;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--traza") && i + 1 < argc) {
+			traza = fopen(argv[++i], "wb");
+			if (!traza) {
+				perror(argv[i]);
+				return 1;
+			}
+		} else if (in == stdin && argv[i][0] != '-') {
+			in = fopen(argv[i], "rb");
+			if (!in) {
+				perror(argv[i]);
+				return 1;
+			}
+		} else {
+			fprintf(stderr, "uso: %s [--traza SALIDA] [archivo]\n", argv[0]);
+			return 2;
+		}
+	}
+	DecodificadorBitacora dec(stdout);
+	dec.traza(traza);
+	int c;
+	while ((c = fgetc(in)) != EOF) dec.byte((uint8_t)c);
+	dec.fin();
+	if (traza) fclose(traza);
+	fprintf(stderr, "%lu tramas, %lu eventos descartados en la placa\n", dec.tramas(), dec.descartadas());
+	if (dec.tramasTraza() > 0)
+		fprintf(stderr, "traza: %lu tramas, %lu perdidas\n", dec.tramasTraza(), dec.tramasTrazaPerdidas());
+	return 0;
+}
@@ -0,0 +1,50 @@
+// Generador offline de NTCTablaDatos.h: temperatura del NTC (centesimas de
+// C, int16) cada NTC_TABLA_PASO codigos del ADC de 10 bits, con el mismo
+// divisor y constantes que temperaturaNTC() (Sensores.h), en doble precision.
+// Los segmentos de los extremos (sensor en corto o abierto) quedan fuera.
+//
+//   make -C host tabla    (reescribe tambien ../NTCTablaDatos.h)
+#include <math.h>
+#include <stdio.h>
+
+#include "Sensores.h"
+
+namespace {
+
+const int kPaso = 8;
+const int kPrimerCodigo = kPaso;         // codigo 0: NTC en corto
+const int kUltimoCodigo = 1024 - kPaso;  // codigo 1023: NTC abierto
+
+double temperatura(int codigo) {
+	double Vout = codigo * (5.0 / 1023.0);
+	double Rntc = (NTC_R_SERIE * Vout) / (5.0 - Vout);
+	return 1.0 / (1.0 / NTC_T0 + (1.0 / NTC_BETA) * log(Rntc / NTC_R0)) - 273.15;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+	const char *ruta = argc > 1 ? argv[1] : "../NTCTablaDatos.h";
+	FILE *f = fopen(ruta, "w");
+	if (!f) {
+		perror(ruta);
+		return 1;
+	}
+	int n = (kUltimoCodigo - kPrimerCodigo) / kPaso + 1;
+	fprintf(f, "// Generado por host/gen_ntc_tabla.cpp: no editar a mano.\n");
+	fprintf(f, "// Temperatura del NTC x100 (beta %.0f, R0 %.0fk, serie %.0fk) cada %d codigos del ADC.\n", NTC_BETA,
+	        NTC_R0, NTC_R_SERIE, kPaso);
+	fprintf(f, "#ifndef SMARTCOMFORT_NTCTABLADATOS_H\n#define SMARTCOMFORT_NTCTABLADATOS_H\n\n");
+	fprintf(f, "#define NTC_TABLA_PASO_BITS %d\n", (int)log2(kPaso));
+	fprintf(f, "#define NTC_TABLA_PRIMER_CODIGO %d\n#define NTC_TABLA_ULTIMO_CODIGO %d\n#define NTC_TABLA_N %d\n\n",
+	        kPrimerCodigo, kUltimoCodigo, n);
+	fprintf(f, "static const int16_t ntcTabla[NTC_TABLA_N] PROGMEM = {");
+	for (int i = 0; i < n; i++) {
+		int codigo = kPrimerCodigo + i * kPaso;
+		fprintf(f, "%s%6ld%s", i % 8 ? " " : "\n\t", lround(temperatura(codigo) * 100.0), i + 1 < n ? "," : "");
+	}
+	fprintf(f, "\n};\n\n#endif\n");
+	fclose(f);
+	printf("%s: %d entradas, %d bytes de flash\n", ruta, n, (int)(n * sizeof(short)));
+	return 0;
+}
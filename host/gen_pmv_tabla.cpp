@@ -0,0 +1,64 @@
+// Generador offline de PMVTablaDatos.h:
+//  - pmvTabla: rejilla de PMV (x1000, int16) para el perfil fijo del sketch
+//    sobre el rango que sanea computePMV (motor de tabla).
+//  - psatTabla: presion de vapor saturado en Pa cada 1 C (motor en punto fijo).
+//
+//   make -C host tabla    (reescribe ../PMVTablaDatos.h)
+#include <math.h>
+#include <stdio.h>
+
+#include "PMV.h"
+
+namespace {
+
+const float kTaMin = -10.0f, kTaPaso = 2.0f;
+const int kNTa = 31;  // -10..50 C
+const float kTrMin = -10.0f, kTrPaso = 5.0f;
+const int kNTr = 13;  // -10..50 C
+const float kRHMin = 0.0f, kRHPaso = 20.0f;
+const int kNRH = 6;   // 0..100 %
+const int kPsatMin = -10, kPsatMax = 50;
+
+}  // namespace
+
+int main(int argc, char **argv) {
+	const char *ruta = argc > 1 ? argv[1] : "../PMVTablaDatos.h";
+	FILE *f = fopen(ruta, "w");
+	if (!f) {
+		perror(ruta);
+		return 1;
+	}
+	fprintf(f, "// Generado por host/gen_pmv_tabla.cpp: no editar a mano.\n");
+	fprintf(f, "// PMV x1000 con met=%.2f, clo=%.2f, va=%.2f; indices [Ta][Tr][RH].\n", PMV_MET, PMV_CLO, PMV_VA);
+	fprintf(f, "#ifndef SMARTCOMFORT_PMVTABLADATOS_H\n#define SMARTCOMFORT_PMVTABLADATOS_H\n\n");
+	fprintf(f, "#define PMV_TABLA_TA_MIN (%.1ff)\n#define PMV_TABLA_TA_PASO %.1ff\n#define PMV_TABLA_NTA %d\n", kTaMin, kTaPaso, kNTa);
+	fprintf(f, "#define PMV_TABLA_TR_MIN (%.1ff)\n#define PMV_TABLA_TR_PASO %.1ff\n#define PMV_TABLA_NTR %d\n", kTrMin, kTrPaso, kNTr);
+	fprintf(f, "#define PMV_TABLA_RH_MIN (%.1ff)\n#define PMV_TABLA_RH_PASO %.1ff\n#define PMV_TABLA_NRH %d\n\n", kRHMin, kRHPaso, kNRH);
+	fprintf(f, "static const int16_t pmvTabla[PMV_TABLA_NTA][PMV_TABLA_NTR][PMV_TABLA_NRH] PROGMEM = {\n");
+	for (int i = 0; i < kNTa; i++) {
+		fprintf(f, "\t{ // Ta = %.1f\n", kTaMin + i * kTaPaso);
+		for (int j = 0; j < kNTr; j++) {
+			fprintf(f, "\t\t{");
+			for (int k = 0; k < kNRH; k++) {
+				resetPMVArranque();
+				float pmv = computePMV(kTaMin + i * kTaPaso, kTrMin + j * kTrPaso, kRHMin + k * kRHPaso,
+				                       PMV_MET, PMV_CLO, PMV_VA).pmv;
+				fprintf(f, "%s%6ld", k ? ", " : " ", lroundf(pmv * 1000.0f));
+			}
+			fprintf(f, " }%s\n", j + 1 < kNTr ? "," : "");
+		}
+		fprintf(f, "\t}%s\n", i + 1 < kNTa ? "," : "");
+	}
+	fprintf(f, "};\n\n");
+	fprintf(f, "// Presion de vapor saturado [Pa] de saturation_vapor_pressure_kPa, T = %d..%d C\n", kPsatMin, kPsatMax);
+	fprintf(f, "#define PSAT_TABLA_T_MIN %d\n#define PSAT_TABLA_N %d\n\n", kPsatMin, kPsatMax - kPsatMin + 1);
+	fprintf(f, "static const uint16_t psatTabla[PSAT_TABLA_N] PROGMEM = {");
+	for (int t = kPsatMin; t <= kPsatMax; t++) {
+		fprintf(f, "%s%ld%s", (t - kPsatMin) % 10 ? " " : "\n\t", lroundf(saturation_vapor_pressure_kPa((float)t) * 1000.0f),
+		        t < kPsatMax ? "," : "");
+	}
+	fprintf(f, "\n};\n\n#endif\n");
+	fclose(f);
+	printf("%s: %d entradas, %d bytes de flash\n", ruta, kNTa * kNTr * kNRH, (int)(kNTa * kNTr * kNRH * sizeof(int16_t)));
+	return 0;
+}
@@ -0,0 +1,233 @@
+// Arduino.h para el build de host (Linux).
+// Reemplaza el core de AVR: tipos basicos, String, Serial y las funciones de
+// pines/tiempo, todas respaldadas por el mundo simulado de SimHAL.h.
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <type_traits>
+
+#include "SimHAL.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// Pines analogicos del ATmega2560
+#define A0 54
+#define A1 55
+#define A2 56
+#define A3 57
+#define A4 58
+#define A5 59
+#define A6 60
+#define A7 61
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_float(addr) (*(const float *)(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+template <typename T, typename U>
+inline typename std::common_type<T, U>::type max(T a, U b) { return a > b ? a : b; }
+template <typename T, typename U>
+inline typename std::common_type<T, U>::type min(T a, U b) { return a < b ? a : b; }
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline void pinMode(uint8_t pin, uint8_t mode) { sim::pinMode(pin, mode); }
+inline void digitalWrite(uint8_t pin, uint8_t val) { sim::digitalWrite(pin, val); }
+inline int digitalRead(uint8_t pin) { return sim::digitalRead(pin); }
+inline int analogRead(uint8_t pin) { return sim::analogRead(pin); }
+
+inline unsigned long millis() { return (unsigned long)(sim::nowMicros() / 1000ULL); }
+inline unsigned long micros() { return (unsigned long)sim::nowMicros(); }
+inline void delay(unsigned long ms) { sim::advanceMicros((uint64_t)ms * 1000ULL); }
+inline void delayMicroseconds(unsigned int us) { sim::advanceMicros(us); }
+inline void yield() {}
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+inline long random(long howbig) { return howbig <= 0 ? 0 : (long)(sim::randomU32() % (uint32_t)howbig); }
+inline long random(long howsmall, long howbig) { return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall); }
+inline void randomSeed(unsigned long seed) { sim::seedRandom(seed); }
+
+// -------------------------------------------------------------
+// String (subconjunto usado por el sketch, sobre std::string). Cada objeto
+// informa a sim::heapReservar() lo que pediria a malloc el String del core
+// de AVR (largo + 1, el buffer solo crece), para medir el heap del sketch.
+// -------------------------------------------------------------
+class String {
+public:
+	String() { ajustar(); }
+	String(const char *s) : s_(s ? s : "") { ajustar(); }
+	String(const std::string &s) : s_(s) { ajustar(); }
+	String(const String &o) : s_(o.s_) { ajustar(); }
+	String(String &&o) : s_(std::move(o.s_)), reservado_(o.reservado_) { o.reservado_ = 0; }
+	explicit String(char c) : s_(1, c) { ajustar(); }
+	explicit String(int v, unsigned char base = DEC) { fromLong(v, base); ajustar(); }
+	explicit String(unsigned int v, unsigned char base = DEC) { fromULong(v, base); ajustar(); }
+	explicit String(long v, unsigned char base = DEC) { fromLong(v, base); ajustar(); }
+	explicit String(unsigned long v, unsigned char base = DEC) { fromULong(v, base); ajustar(); }
+	explicit String(float v, unsigned char decimals = 2) { fromDouble(v, decimals); ajustar(); }
+	explicit String(double v, unsigned char decimals = 2) { fromDouble(v, decimals); ajustar(); }
+	~String() { sim::heapReservar(-(long)reservado_); }
+	String &operator=(const String &o) { s_ = o.s_; ajustar(); return *this; }
+	String &operator=(String &&o) {
+		std::swap(s_, o.s_);
+		std::swap(reservado_, o.reservado_);
+		return *this;
+	}
+
+	unsigned int length() const { return (unsigned int)s_.size(); }
+	const char *c_str() const { return s_.c_str(); }
+	char charAt(unsigned int i) const { return i < s_.size() ? s_[i] : 0; }
+	char operator[](unsigned int i) const { return charAt(i); }
+	String substring(unsigned int from) const { return from < s_.size() ? String(s_.substr(from)) : String(); }
+	String substring(unsigned int from, unsigned int to) const {
+		if (from > to) { unsigned int t = from; from = to; to = t; }
+		if (from >= s_.size()) return String();
+		return String(s_.substr(from, to - from));
+	}
+	long toInt() const { return atol(s_.c_str()); }
+	float toFloat() const { return (float)atof(s_.c_str()); }
+	bool equals(const String &o) const { return s_ == o.s_; }
+
+	String &operator+=(const String &o) { s_ += o.s_; ajustar(); return *this; }
+	String &operator+=(const char *o) { if (o) s_ += o; ajustar(); return *this; }
+	String &operator+=(char c) { s_ += c; ajustar(); return *this; }
+	String &operator+=(int v) { return *this += String(v); }
+
+	friend String operator+(const String &a, const String &b) { return String(a.s_ + b.s_); }
+	friend String operator+(const String &a, const char *b) { return String(a.s_ + (b ? b : "")); }
+	friend String operator+(const String &a, char c) { return String(a.s_ + c); }
+	friend bool operator==(const String &a, const String &b) { return a.s_ == b.s_; }
+	friend bool operator==(const String &a, const char *b) { return a.s_ == (b ? b : ""); }
+	friend bool operator!=(const String &a, const String &b) { return a.s_ != b.s_; }
+	friend bool operator!=(const String &a, const char *b) { return !(a == b); }
+
+private:
+	void ajustar() {
+		size_t necesario = s_.size() + 1;
+		if (necesario > reservado_) {
+			sim::heapReservar((long)(necesario - reservado_));
+			reservado_ = necesario;
+		}
+	}
+	void fromLong(long v, unsigned char base) {
+		if (v < 0 && base == DEC) { s_ = "-"; fromULong((unsigned long)(-v), base, true); }
+		else fromULong((unsigned long)v, base);
+	}
+	void fromULong(unsigned long v, unsigned char base, bool append = false) {
+		char buf[sizeof(unsigned long) * 8 + 1];
+		char *p = buf + sizeof(buf) - 1;
+		*p = 0;
+		do {
+			unsigned long d = v % base;
+			*--p = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+			v /= base;
+		} while (v);
+		if (append) s_ += p; else s_ = p;
+	}
+	void fromDouble(double v, unsigned char decimals) {
+		char buf[48];
+		snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+		s_ = buf;
+	}
+	std::string s_;
+	size_t reservado_ = 0;
+};
+
+// -------------------------------------------------------------
+// Print: base comun de Serial y LiquidCrystal
+// -------------------------------------------------------------
+class Print {
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t c) = 0;
+	size_t write(const uint8_t *buf, size_t n) { size_t w = 0; while (n--) w += write(*buf++); return w; }
+	size_t write(const char *s) { return s ? write((const uint8_t *)s, strlen(s)) : 0; }
+
+	size_t print(const __FlashStringHelper *s) { return write(reinterpret_cast<const char *>(s)); }
+	size_t print(const String &s) { return write(s.c_str()); }
+	size_t print(const char *s) { return write(s); }
+	size_t print(char c) { return write((uint8_t)c); }
+	size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+	size_t print(int v, int base = DEC) { return print((long)v, base); }
+	size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+	size_t print(long v, int base = DEC) {
+		if (v < 0 && base == DEC) return write('-') + print((unsigned long)(-v), base);
+		return print((unsigned long)v, base);
+	}
+	size_t print(unsigned long v, int base = DEC) {
+		// Como el Print del core: en la pila, sin pasar por String
+		char buf[sizeof(unsigned long) * 8 + 1];
+		char *p = buf + sizeof(buf) - 1;
+		*p = 0;
+		if (base < 2) base = 10;
+		do {
+			unsigned long d = v % (unsigned long)base;
+			*--p = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+			v /= (unsigned long)base;
+		} while (v);
+		return write(p);
+	}
+	size_t print(double v, int digits = 2) {
+		if (isnan(v)) return write("nan");
+		if (isinf(v)) return write("inf");
+		char buf[48];
+		snprintf(buf, sizeof(buf), "%.*f", digits, v);
+		return write(buf);
+	}
+
+	size_t println() { return write("\r\n"); }
+	template <typename T>
+	size_t println(const T &v) { size_t n = print(v); return n + println(); }
+	template <typename T>
+	size_t println(const T &v, int fmt) { size_t n = print(v, fmt); return n + println(); }
+};
+
+// Puerto serie simulado: TX con buffer de 64 bytes drenado a la velocidad
+// configurada (bloquea el reloj virtual al llenarse, como HardwareSerial).
+class HardwareSerial : public Print {
+public:
+	void begin(unsigned long baud) { sim::serialBegin(baud); }
+	void end() {}
+	int available() { return sim::serialAvailable(); }
+	int read() { return sim::serialRead(); }
+	int peek() { return sim::serialPeek(); }
+	int availableForWrite() { return sim::serialAvailableForWrite(); }
+	void flush() { sim::serialFlush(); }
+	size_t write(uint8_t c) override { sim::serialWrite(c); return 1; }
+	using Print::write;
+	operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
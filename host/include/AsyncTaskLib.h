@@ -0,0 +1,66 @@
+// AsyncTaskLib.h de host: misma semantica que la libreria de Luis Llamas,
+// sobre el millis() virtual.
+#pragma once
+
+#include "Arduino.h"
+
+typedef void (*AsyncTaskCallback)();
+
+class AsyncTask {
+public:
+	AsyncTask(unsigned long millisInterval) : AsyncTask(millisInterval, false, nullptr) {}
+	AsyncTask(unsigned long millisInterval, AsyncTaskCallback OnFinish) : AsyncTask(millisInterval, false, OnFinish) {}
+	AsyncTask(unsigned long millisInterval, bool autoReset) : AsyncTask(millisInterval, autoReset, nullptr) {}
+	AsyncTask(unsigned long millisInterval, bool autoReset, AsyncTaskCallback OnFinish)
+		: Interval(millisInterval), AutoReset(autoReset), OnFinish(OnFinish) {}
+
+	void Start() {
+		Reset();
+		_isActive = true;
+		if (OnStart != nullptr) OnStart();
+	}
+	void Reset() {
+		_startTime = millis();
+		_isExpired = false;
+		if (OnReset != nullptr) OnReset();
+	}
+	void Stop() {
+		if (_isActive) {
+			_isActive = false;
+			if (OnStop != nullptr) OnStop();
+		}
+	}
+	bool Update() {
+		if (!_isActive) return false;
+		_isExpired = false;
+		if (static_cast<unsigned long>(millis() - _startTime) >= Interval) {
+			_isExpired = true;
+			if (OnFinish != nullptr) OnFinish();
+			Reset();
+			if (!AutoReset) Stop();
+		}
+		return _isExpired;
+	}
+	void Update(AsyncTask &next) {
+		if (Update()) next.Start();
+	}
+
+	void SetIntervalMillis(unsigned long interval) { Interval = interval; }
+	unsigned long GetStartTime() { return _startTime; }
+	unsigned long GetElapsedTime() { return millis() - _startTime; }
+	unsigned long GetRemainingTime() { return Interval - GetElapsedTime(); }
+	bool IsActive() const { return _isActive; }
+	bool IsExpired() const { return _isExpired; }
+
+	unsigned long Interval;
+	bool AutoReset;
+	AsyncTaskCallback OnStart = nullptr;
+	AsyncTaskCallback OnReset = nullptr;
+	AsyncTaskCallback OnStop = nullptr;
+	AsyncTaskCallback OnFinish;
+
+private:
+	bool _isActive = false;
+	bool _isExpired = false;
+	unsigned long _startTime = 0;
+};
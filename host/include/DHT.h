@@ -0,0 +1,38 @@
+// DHT.h de host: DHT11 simulado sobre el modelo de sala de SimHAL.
+// Igual que la libreria de Adafruit, una lectura fisica cada 2 s como maximo;
+// las llamadas intermedias devuelven el ultimo resultado.
+#pragma once
+
+#include "Arduino.h"
+
+#define DHT11 11
+#define DHT22 22
+
+class DHT {
+public:
+	DHT(uint8_t pin, uint8_t type, uint8_t count = 6) : _pin(pin), _type(type) { (void)count; }
+	void begin(uint8_t usec = 55) { (void)usec; _lastreadtime = 0; _primed = false; }
+	float readTemperature(bool S = false, bool force = false) {
+		if (!read(force)) return NAN;
+		return S ? _t * 1.8f + 32.0f : _t;
+	}
+	float readHumidity(bool force = false) {
+		if (!read(force)) return NAN;
+		return _h;
+	}
+	bool read(bool force = false) {
+		unsigned long now = millis();
+		if (!force && _primed && (now - _lastreadtime) < 2000) return _lastresult;
+		_primed = true;
+		_lastreadtime = now;
+		_lastresult = sim::dhtSample(_t, _h);
+		return _lastresult;
+	}
+
+private:
+	uint8_t _pin, _type;
+	unsigned long _lastreadtime = 0;
+	bool _primed = false;
+	bool _lastresult = false;
+	float _t = NAN, _h = NAN;
+};
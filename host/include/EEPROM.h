@@ -0,0 +1,27 @@
+// EEPROM.h de host: 4 KB como el ATmega2560, con contador de desgaste.
+#pragma once
+
+#include "Arduino.h"
+
+class EEPROMClass {
+public:
+	uint8_t read(int idx) { return sim::eepromRead(idx); }
+	void write(int idx, uint8_t val) { sim::eepromWrite(idx, val); }
+	void update(int idx, uint8_t val) { if (read(idx) != val) write(idx, val); }
+	uint16_t length() { return (uint16_t)sim::kEepromSize; }
+
+	template <typename T>
+	T &get(int idx, T &t) {
+		uint8_t *p = (uint8_t *)&t;
+		for (size_t i = 0; i < sizeof(T); i++) p[i] = read(idx + (int)i);
+		return t;
+	}
+	template <typename T>
+	const T &put(int idx, const T &t) {
+		const uint8_t *p = (const uint8_t *)&t;
+		for (size_t i = 0; i < sizeof(T); i++) update(idx + (int)i, p[i]);
+		return t;
+	}
+};
+
+extern EEPROMClass EEPROM;
@@ -0,0 +1,23 @@
+// Keypad.h de host: entrega las teclas programadas con sim::scheduleKey().
+#pragma once
+
+#include "Arduino.h"
+
+#define makeKeymap(x) ((char *)x)
+#define NO_KEY '\0'
+
+class Keypad {
+public:
+	Keypad(char *userKeymap, byte *row, byte *col, byte numRows, byte numCols)
+		: _keymap(userKeymap), _rows(numRows), _cols(numCols) { (void)row; (void)col; }
+	char getKey() { return sim::nextKey(); }
+	char waitForKey() {
+		char k;
+		while ((k = getKey()) == NO_KEY) delay(1);
+		return k;
+	}
+
+private:
+	char *_keymap;
+	byte _rows, _cols;
+};
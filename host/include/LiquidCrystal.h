@@ -0,0 +1,32 @@
+// LiquidCrystal.h de host: HD44780 16x2 simulado. Mantiene la DDRAM, cuenta
+// clears y bytes enviados y carga al reloj virtual el coste de cada comando.
+#pragma once
+
+#include "Arduino.h"
+
+class LiquidCrystal : public Print {
+public:
+	LiquidCrystal(uint8_t rs, uint8_t enable, uint8_t d0, uint8_t d1, uint8_t d2, uint8_t d3) {
+		(void)rs; (void)enable; (void)d0; (void)d1; (void)d2; (void)d3;
+	}
+	void begin(uint8_t cols, uint8_t rows) { _cols = cols; _rows = rows; clear(); }
+	void clear() { sim::lcdCommand(true); _col = 0; _row = 0; }
+	void home() { sim::lcdCommand(true); _col = 0; _row = 0; }
+	void setCursor(uint8_t col, uint8_t row) {
+		sim::lcdCommand(false);
+		_col = col;
+		_row = row < _rows ? row : (uint8_t)(_rows - 1);
+	}
+	void noDisplay() { sim::lcdCommand(false); }
+	void display() { sim::lcdCommand(false); }
+	size_t write(uint8_t c) override {
+		sim::lcdData(_row, _col, (char)c);
+		_col++;
+		return 1;
+	}
+	using Print::write;
+
+private:
+	uint8_t _cols = 16, _rows = 2;
+	uint8_t _col = 0, _row = 0;
+};
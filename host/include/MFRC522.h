@@ -0,0 +1,67 @@
+// MFRC522.h de host: lector RFID simulado. Las tarjetas se presentan con
+// sim::presentCard(); la lectura de un bloque exige haber autenticado su
+// sector en la sesion actual, como en una MIFARE Classic real.
+#pragma once
+
+#include "Arduino.h"
+
+class MFRC522 {
+public:
+	enum StatusCode : byte {
+		STATUS_OK,
+		STATUS_ERROR,
+		STATUS_COLLISION,
+		STATUS_TIMEOUT,
+		STATUS_NO_ROOM,
+		STATUS_INTERNAL_ERROR,
+		STATUS_INVALID,
+		STATUS_CRC_WRONG,
+		STATUS_MIFARE_NACK = 0xff
+	};
+	enum PICC_Command : byte {
+		PICC_CMD_MF_AUTH_KEY_A = 0x60,
+		PICC_CMD_MF_AUTH_KEY_B = 0x61,
+	};
+	typedef struct {
+		byte size;
+		byte uidByte[10];
+		byte sak;
+	} Uid;
+	typedef struct {
+		byte keyByte[6];
+	} MIFARE_Key;
+
+	Uid uid;
+
+	MFRC522(byte chipSelectPin, byte resetPowerDownPin) { (void)chipSelectPin; (void)resetPowerDownPin; }
+	void PCD_Init() { _authSector = -1; }
+
+	bool PICC_IsNewCardPresent() {
+		const sim::Card *card = sim::cardInField();
+		if (card == nullptr || sim::cardHalted()) {
+			sim::advanceMicros(sim::costs().rfidPoll);
+			return false;
+		}
+		return true;
+	}
+	bool PICC_ReadCardSerial() {
+		const sim::Card *card = sim::cardInField();
+		if (card == nullptr || sim::cardHalted()) return false;
+		uid.size = card->uidSize;
+		memcpy(uid.uidByte, card->uid, sizeof(uid.uidByte));
+		uid.sak = 0x08;
+		_authSector = -1;
+		return true;
+	}
+	StatusCode PCD_Authenticate(byte command, byte blockAddr, MIFARE_Key *key, Uid *uid);
+	StatusCode MIFARE_Read(byte blockAddr, byte *buffer, byte *bufferSize);
+	StatusCode PICC_HaltA() {
+		sim::haltCard();
+		return STATUS_OK;
+	}
+	void PCD_StopCrypto1() { _authSector = -1; }
+	static const __FlashStringHelper *GetStatusCodeName(StatusCode code);
+
+private:
+	int _authSector = -1;
+};
@@ -0,0 +1,12 @@
+// SPI.h de host: el bus lo modela MFRC522.h directamente.
+#pragma once
+
+#include "Arduino.h"
+
+class SPIClass {
+public:
+	void begin() {}
+	void end() {}
+};
+
+extern SPIClass SPI;
@@ -0,0 +1,20 @@
+// Servo.h de host: registra el angulo para el modelo termico.
+#pragma once
+
+#include "Arduino.h"
+
+class Servo {
+public:
+	uint8_t attach(int pin) { _pin = pin; return 0; }
+	void detach() { _pin = -1; }
+	void write(int value) {
+		_angle = constrain(value, 0, 180);
+		if (_pin >= 0) sim::servoWrite((uint8_t)_pin, _angle);
+	}
+	int read() { return _angle; }
+	bool attached() { return _pin >= 0; }
+
+private:
+	int _pin = -1;
+	int _angle = 0;
+};
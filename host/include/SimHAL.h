@@ -0,0 +1,159 @@
+// SimHAL: mundo simulado para el build de host.
+// Reloj virtual en microsegundos, pines, puerto serie, modelo termico de la
+// sala y los dispositivos (DHT11, NTC, teclado, RFID, LCD, EEPROM). Las
+// cabeceras de librerias de host/include delegan aqui, de modo que el sketch
+// se compila sin cambios contra dispositivos simulados. delay() solo avanza
+// el reloj virtual: semanas de operacion se ejecutan en segundos.
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace sim {
+
+// --- Reloj virtual -------------------------------------------------------
+uint64_t nowMicros();
+void advanceMicros(uint64_t us);
+// Como advanceMicros(), pero vuelve despues de la interrupcion de
+// temporizador que deje wake() en true (el sueno de la CPU en la placa).
+// Devuelve los us que avanzo.
+typedef bool (*WakeCheck)();
+uint64_t sleepMicros(uint64_t us, WakeCheck wake);
+void resetClock();
+
+// --- Aleatorio determinista (xorshift) -----------------------------------
+void seedRandom(uint32_t seed);
+uint32_t randomU32();
+float randomUniform(float lo, float hi);
+
+// --- Pines ---------------------------------------------------------------
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+int pinOutput(uint8_t pin);                 // ultimo valor escrito
+uint32_t pinToggles(uint8_t pin);           // flancos escritos en el pin
+void setDigitalInput(uint8_t pin, int val); // nivel que veran las lecturas
+void setAnalogInput(uint8_t pin, int val);  // -1 = derivado del modelo NTC
+// Nivel programado en el tiempo virtual: se aplica al pasar el reloj por
+// ese instante, aunque el sketch este dentro de un delay()
+void scheduleDigitalInput(uint64_t atMicros, uint8_t pin, int val);
+
+// --- Interrupcion de temporizador ------------------------------------------
+// Como una comparacion del Timer0 en la placa: la rutina corre cada
+// periodUs, con el reloj en el instante de la interrupcion. Para no correrla
+// millones de veces en vano, solo se llama en el primer vencimiento despues
+// de un cambio de alguna entrada digital (un muestreador no ve otra cosa).
+typedef void (*TimerIsr)();
+void attachTimerIsr(TimerIsr isr, uint32_t periodUs);
+uint64_t timerIsrCalls();
+
+// --- Puerto serie --------------------------------------------------------
+void serialBegin(unsigned long baud);
+void serialWrite(uint8_t c);
+int serialAvailableForWrite();
+void serialFlush();
+int serialAvailable();
+int serialRead();
+int serialPeek();
+void serialInject(const char *text);        // datos que llegaran por RX
+typedef void (*SerialTap)(uint8_t c);
+void setSerialTap(SerialTap tap);           // recibe cada byte de TX
+uint64_t serialBytesWritten();
+uint64_t serialBlockedMicros();             // tiempo bloqueado con TX lleno
+
+// --- Modelo termico de la sala ---------------------------------------------
+// El rele (enfriamiento) y el servo a 90 grados (calefaccion) actuan sobre Ta;
+// Tr sigue a Ta con retardo y el exterior oscila con periodo diario.
+struct RoomModel {
+	float Ta;              // temperatura del aire [C]
+	float Tr;              // temperatura radiante [C]
+	float RH;              // humedad relativa [%]
+	float outdoorMean;     // media exterior [C]
+	float outdoorSwing;    // amplitud diaria [C]
+	float tauMinutes;      // constante de tiempo sala/exterior
+	float coolingPerMin;   // efecto del rele [C/min]
+	float heatingPerMin;   // efecto del servo abierto [C/min]
+	float adcNoiseLsb;     // ruido del ADC en el canal NTC [LSB]
+	uint8_t relayPin;
+	uint8_t servoPin;
+	uint8_t ntcPin;
+};
+RoomModel &room();
+void stepRoom(float seconds);
+
+// Dispositivos DHT11: fallos NaN inyectables con probabilidad dada
+void setDhtFailureRate(float p);
+bool dhtSample(float &t, float &h);
+uint32_t dhtBusReads();
+
+// Valor ADC que produciria el divisor NTC a la temperatura T
+int ntcAdcForTemperature(float T);
+
+// --- Servo ---------------------------------------------------------------
+void servoWrite(uint8_t pin, int angle);
+int servoAngle(uint8_t pin);
+
+// --- Teclado -------------------------------------------------------------
+// Teclas programadas en el tiempo virtual; getKey() entrega una por llamada.
+void scheduleKey(uint64_t atMicros, char key);
+void scheduleKeys(uint64_t atMicros, const char *keys, uint32_t gapMs);
+char nextKey();
+size_t pendingKeys();
+
+// --- RFID ----------------------------------------------------------------
+struct Card {
+	uint8_t uid[10];
+	uint8_t uidSize;
+	uint8_t blocks[64][16];
+};
+void presentCard(const Card &card, uint64_t fromMicros, uint64_t toMicros);
+const Card *cardInField();
+bool cardHalted();
+void haltCard();
+uint32_t rfidAuths();
+uint32_t rfidBlockReads();
+void countRfidAuth();
+void countRfidRead();
+
+// --- LCD -----------------------------------------------------------------
+void lcdCommand(bool clear);
+void lcdData(uint8_t row, uint8_t col, char c);
+const char *lcdLine(uint8_t row);           // 16 caracteres visibles
+uint32_t lcdClears();
+uint32_t lcdBytes();
+
+// --- EEPROM --------------------------------------------------------------
+const size_t kEepromSize = 4096;
+uint8_t eepromRead(int addr);
+void eepromWrite(int addr, uint8_t v);
+uint32_t eepromWrites(int addr);            // desgaste por celda
+uint32_t eepromTotalWrites();
+
+// --- Heap del AVR ----------------------------------------------------------
+// String y StateMachine de host anotan aqui lo que pedirian a malloc en la
+// placa (sin la cabecera de cada bloque).
+void heapReservar(long bytes);              // negativo al liberar
+size_t heapUsado();
+size_t heapMaximo();                        // marca de agua alta
+
+// --- Ganchos del harness ---------------------------------------------------
+typedef void (*StateHook)(uint8_t from, uint8_t to);
+void setStateHook(StateHook hook);
+void notifyStateChange(uint8_t from, uint8_t to);
+
+// Costes de bus modelados (us) para que el reloj virtual refleje los
+// bloqueos reales del AVR.
+struct Costs {
+	uint32_t dhtRead;        // lectura completa DHT11 (~23 ms)
+	uint32_t analogRead;     // conversion ADC (~112 us)
+	uint32_t lcdClear;       // clear()/home() del HD44780 (2 ms)
+	uint32_t lcdByte;        // comando o dato (~100 us en LiquidCrystal)
+	uint32_t rfidAuth;       // PCD_Authenticate
+	uint32_t rfidRead;       // MIFARE_Read de un bloque
+	uint32_t rfidPoll;       // PICC_IsNewCardPresent sin tarjeta
+	uint32_t eepromWrite;    // escritura de un byte (3.3 ms)
+};
+Costs &costs();
+
+}  // namespace sim
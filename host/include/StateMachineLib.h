@@ -0,0 +1,66 @@
+// StateMachineLib.h de host: misma semantica que la libreria de Luis Llamas
+// (transiciones evaluadas en orden de alta en cada Update()). Notifica cada
+// cambio de estado al harness mediante sim::notifyStateChange().
+#pragma once
+
+#include "Arduino.h"
+
+class StateMachine {
+public:
+	typedef bool (*StateMachineCondition)();
+	typedef void (*StateMachineAction)();
+
+	StateMachine(uint8_t numStates, uint8_t numTransitions)
+		: _numStates(numStates), _maxTransitions(numTransitions) {
+		_transitions = new Transition[numTransitions];
+		_onEntering = new StateMachineAction[numStates]();
+		_onLeaving = new StateMachineAction[numStates]();
+		// En la placa: transicion de 4 bytes y punteros a funcion de 2
+		sim::heapReservar((long)numTransitions * 4 + (long)numStates * 2 * 2);
+	}
+
+	void AddTransition(uint8_t inputState, uint8_t outputState, StateMachineCondition condition) {
+		if (_numTransitions >= _maxTransitions) return;
+		_transitions[_numTransitions].InputState = inputState;
+		_transitions[_numTransitions].OutputState = outputState;
+		_transitions[_numTransitions].Condition = condition;
+		_numTransitions++;
+	}
+	void SetOnEntering(uint8_t state, StateMachineAction functionPointer) { _onEntering[state] = functionPointer; }
+	void SetOnLeaving(uint8_t state, StateMachineAction functionPointer) { _onLeaving[state] = functionPointer; }
+	void ClearOnEntering(uint8_t state) { _onEntering[state] = nullptr; }
+	void ClearOnLeaving(uint8_t state) { _onLeaving[state] = nullptr; }
+
+	void SetState(uint8_t state, bool launchLeaving, bool launchEntering) {
+		uint8_t previous = _currentStateIndex;
+		if (launchLeaving && _onLeaving[_currentStateIndex] != nullptr) _onLeaving[_currentStateIndex]();
+		_currentStateIndex = state;
+		sim::notifyStateChange(previous, state);
+		if (launchEntering && _onEntering[state] != nullptr) _onEntering[state]();
+	}
+	int GetState() const { return _currentStateIndex; }
+
+	bool Update() {
+		for (int i = 0; i < _numTransitions; i++) {
+			if (_transitions[i].InputState == _currentStateIndex && _transitions[i].Condition()) {
+				SetState(_transitions[i].OutputState, true, true);
+				return true;
+			}
+		}
+		return false;
+	}
+
+private:
+	struct Transition {
+		uint8_t InputState;
+		uint8_t OutputState;
+		StateMachineCondition Condition;
+	};
+	uint8_t _numStates;
+	uint8_t _maxTransitions;
+	uint8_t _numTransitions = 0;
+	uint8_t _currentStateIndex = 0;
+	Transition *_transitions;
+	StateMachineAction *_onEntering;
+	StateMachineAction *_onLeaving;
+};
@@ -0,0 +1,429 @@
+// Simulador de host: enlaza el sketch contra los dispositivos de SimHAL y lo
+// ejecuta en tiempo acelerado. Un "usuario" programado responde a cada estado
+// (clave, tarjeta, presencia IR, boton) y al final se informa el rendimiento
+// del loop (total y por estado) y la latencia de las transiciones en tiempo
+// simulado.
+//
+//   smartcomfort_sim [--days D] [--hours H] [--seed N] [--dht-fail P] [--ntc-abierto H] [--echo] [--serie ARCHIVO]
+//                    [--nivel 0-3] [--historial] [--perfil] [--grabar TRAZA | --reproducir TRAZA]
+//
+// --ntc-abierto desconecta el NTC de la sala principal a las H horas (el ADC
+// queda a fondo de escala): la sala tiene que seguir regulando con Tr = Ta.
+//
+// --echo muestra la salida serie del sketch ya decodificada (Bitacora.h) y
+// --serie guarda los bytes tal como salen, para smartcomfort_log. --nivel
+// envia al sketch la verbosidad de la bitacora. --historial le pide el
+// volcado del historial de la EEPROM ('H') un minuto antes del final y lo
+// imprime decodificado. --perfil pide, en el mismo momento, el volcado del
+// perfilado del loop ('P', Perfilador.h): tiempos por seccion y por tarea
+// medidos con micros() del reloj virtual.
+//
+// --grabar guarda la traza de entradas del sketch (Traza.h) tal como la
+// enviaria la placa; --reproducir ejecuta el sketch con las entradas de una
+// traza (de la placa, via smartcomfort_log --traza, o de --grabar), sin
+// usuario simulado y hasta agotarla, y verifica que cada cambio de estado
+// coincida con el grabado. Sale con 1 si la ejecucion se desvia.
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "Arduino.h"
+#include "ConfortISO.h"
+#include "DecodificadorBitacora.h"
+#include "Traza.h"
+#include "Zona.h"
+#include "Eventos.h"
+#include "Flancos.h"
+#include "Reposo.h"
+
+void setup();
+void loop();
+extern Zona &principal;
+extern ColaEventos eventos;
+extern EstadisticaEventos estadisticaEventos;
+
+namespace {
+
+const char *const kStateNames[] = { "inicio", "Config", "Bloqueado", "Alarma", "Monitor", "pmv_alto", "pmv_bajo" };
+const int kNumStates = 7;
+enum { S_INICIO, S_CONFIG, S_BLOQUEADO, S_ALARMA, S_MONITOR, S_PMV_ALTO, S_PMV_BAJO };
+
+const uint8_t kButtonPin = 49;
+const uint8_t kIrPin = 23;
+const uint8_t kNtcPin = 54;  // A0
+
+// Estadistica simple con histograma en potencias de dos
+struct Stats {
+	uint64_t n = 0;
+	double sum = 0.0;
+	double minV = 0.0;
+	double maxV = 0.0;
+	uint64_t buckets[32] = {};
+
+	void add(double v) {
+		if (n == 0 || v < minV) minV = v;
+		if (n == 0 || v > maxV) maxV = v;
+		n++;
+		sum += v;
+		int b = 0;
+		while (b < 31 && v >= (double)(1ULL << b)) b++;
+		buckets[b]++;
+	}
+	double mean() const { return n ? sum / (double)n : 0.0; }
+	double percentile(double p) const {
+		uint64_t target = (uint64_t)(p * (double)n);
+		uint64_t acc = 0;
+		for (int b = 0; b < 32; b++) {
+			acc += buckets[b];
+			if (acc > target) return (double)(1ULL << b);
+		}
+		return maxV;
+	}
+};
+
+struct Stimulus {
+	bool pending = false;
+	uint64_t at = 0;
+	const char *kind = "";
+};
+
+Stimulus g_stimulus;
+uint64_t g_enteredAt[kNumStates];
+int g_current = S_INICIO;
+Stats g_dwell[kNumStates];
+Stats g_loopPorEstado[kNumStates];
+std::map<std::string, Stats> g_latency;
+uint64_t g_transitions[kNumStates][kNumStates] = {};
+uint64_t g_wrongCodes = 0;
+bool g_reproduciendo = false;
+
+sim::Card makeCard(const uint8_t uid[4], const char *nombre, const char *temp) {
+	sim::Card c;
+	memset(&c, 0, sizeof(c));
+	memcpy(c.uid, uid, 4);
+	c.uidSize = 4;
+	strncpy((char *)c.blocks[4], nombre, 16);
+	strncpy((char *)c.blocks[5], temp, 16);
+	return c;
+}
+
+const uint8_t kTarjeta[4] = { 0x43, 0x89, 0x4F, 0x2E };
+const uint8_t kLlavero[4] = { 0x56, 0x34, 0xDA, 0x73 };
+const uint8_t kDesconocida[4] = { 0xDE, 0xAD, 0xBE, 0xEF };
+
+uint64_t msToUs(uint64_t ms) { return ms * 1000ULL; }
+
+void schedulePin(uint64_t at, uint8_t pin, int level, uint64_t holdMs) {
+	sim::scheduleDigitalInput(at, pin, level);
+	sim::scheduleDigitalInput(at + msToUs(holdMs), pin, !level);
+}
+
+void setStimulus(uint64_t at, const char *kind) {
+	g_stimulus.pending = true;
+	g_stimulus.at = at;
+	g_stimulus.kind = kind;
+}
+
+// Acciones del usuario simulado al entrar a cada estado
+void planUser(int state, uint64_t now) {
+	switch (state) {
+	case S_INICIO: {
+		uint64_t at = now + msToUs(1000 + random(0, 8000));
+		bool wrong = random(0, 100) < 15;
+		sim::scheduleKeys(at, wrong ? "9999" : "1234", 300);
+		if (wrong) g_wrongCodes++;
+		setStimulus(at + msToUs(900), wrong ? "clave incorrecta" : "clave correcta");
+		break;
+	}
+	case S_BLOQUEADO: {
+		uint64_t at = now + msToUs(2000 + random(0, 6000));
+		if (random(0, 2)) {
+			sim::scheduleKey(at, '*');
+			setStimulus(at, "tecla * (desbloqueo)");
+		} else {
+			schedulePin(at, kButtonPin, LOW, 400);
+			setStimulus(at, "boton (desbloqueo)");
+		}
+		break;
+	}
+	case S_CONFIG: {
+		long r = random(0, 100);
+		sim::Card card = r < 70 ? makeCard(kTarjeta, "Santiago", "22")
+		               : r < 90 ? makeCard(kLlavero, "Camila", "24")
+		                        : makeCard(kDesconocida, "", "");
+		uint64_t at = now + msToUs(500 + random(0, 2500));
+		sim::presentCard(card, at, at + msToUs(1500));
+		// Config solo avanza con una tarjeta registrada: el usuario reintenta
+		if (r >= 90) sim::presentCard(makeCard(kTarjeta, "Santiago", "22"), at + msToUs(4000), at + msToUs(5500));
+		break;
+	}
+	case S_ALARMA: {
+		uint64_t at = now + msToUs(5000 + random(0, 40000));
+		if (random(0, 100) < 75) {
+			schedulePin(at, kIrPin, LOW, 2000);
+			setStimulus(at, "presencia IR");
+		} else {
+			sim::scheduleKey(at, '#');
+			setStimulus(at, "tecla # (alarma)");
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void onStateChange(uint8_t from, uint8_t to) {
+	uint64_t now = sim::nowMicros();
+	if (from != to || now != 0) {
+		g_dwell[from].add((double)(now - g_enteredAt[from]) / 1000.0);
+		g_transitions[from][to]++;
+		if (g_stimulus.pending) {
+			g_latency[g_stimulus.kind].add((double)(now - g_stimulus.at) / 1000.0);
+			g_stimulus.pending = false;
+		}
+	}
+	g_current = to;
+	g_enteredAt[to] = now;
+	// Reproduciendo, las entradas salen de la traza
+	if (!g_reproduciendo) planUser(to, now);
+}
+
+void printStats(const char *name, const Stats &s, const char *unit) {
+	printf("  %-24s n=%-8llu media=%10.2f %s  min=%10.2f  p99<=%10.0f  max=%10.2f\n", name,
+	       (unsigned long long)s.n, s.mean(), unit, s.minV, s.percentile(0.99), s.maxV);
+}
+
+// Salida serie del sketch: decodificada a stdout (--echo) y/o cruda a un
+// archivo (--serie)
+DecodificadorBitacora *g_eco = nullptr;
+FILE *g_serie = nullptr;
+
+void alSalirPorSerie(uint8_t c) {
+	if (g_eco) g_eco->byte(c);
+	if (g_serie) fputc(c, g_serie);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+	double days = 1.0;
+	uint32_t seed = 1;
+	float dhtFail = 0.0f;
+	double ntcAbiertoH = -1.0;
+	bool echo = false;
+	const char *rutaSerie = nullptr;
+	const char *nivel = nullptr;
+	bool volcarHistorial = false;
+	bool volcarPerfil = false;
+	const char *rutaGrabar = nullptr;
+	const char *rutaReproducir = nullptr;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--days") && i + 1 < argc) days = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--hours") && i + 1 < argc) days = atof(argv[++i]) / 24.0;
+		else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--dht-fail") && i + 1 < argc) dhtFail = (float)atof(argv[++i]);
+		else if (!strcmp(argv[i], "--ntc-abierto") && i + 1 < argc) ntcAbiertoH = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--echo")) echo = true;
+		else if (!strcmp(argv[i], "--serie") && i + 1 < argc) rutaSerie = argv[++i];
+		else if (!strcmp(argv[i], "--nivel") && i + 1 < argc) nivel = argv[++i];
+		else if (!strcmp(argv[i], "--historial")) volcarHistorial = true;
+		else if (!strcmp(argv[i], "--perfil")) volcarPerfil = true;
+		else if (!strcmp(argv[i], "--grabar") && i + 1 < argc) rutaGrabar = argv[++i];
+		else if (!strcmp(argv[i], "--reproducir") && i + 1 < argc) rutaReproducir = argv[++i];
+		else {
+			fprintf(stderr, "uso: %s [--days D] [--hours H] [--seed N] [--dht-fail P] [--ntc-abierto H] [--echo] [--serie ARCHIVO] [--nivel 0-3] [--historial] [--perfil] [--grabar TRAZA | --reproducir TRAZA]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	sim::seedRandom(seed);
+	std::vector<uint8_t> trazaReproducida;
+	if (rutaReproducir) {
+		FILE *f = fopen(rutaReproducir, "rb");
+		if (!f) {
+			perror(rutaReproducir);
+			return 1;
+		}
+		int c;
+		while ((c = fgetc(f)) != EOF) trazaReproducida.push_back((uint8_t)c);
+		fclose(f);
+		traza.reproducir(trazaReproducida.data(), (uint32_t)trazaReproducida.size());
+		g_reproduciendo = true;
+	}
+	FILE *trazaGrabada = nullptr;
+	if (rutaGrabar) {
+		trazaGrabada = fopen(rutaGrabar, "wb");
+		if (!trazaGrabada) {
+			perror(rutaGrabar);
+			return 1;
+		}
+		traza.grabar();
+	}
+
+	// Sin --echo, los volcados y la traza se decodifican igual pero solo se
+	// imprimen los volcados
+	FILE *descarte = nullptr;
+	if ((volcarHistorial || volcarPerfil || trazaGrabada) && !echo) descarte = fopen("/dev/null", "w");
+	DecodificadorBitacora decodificador(descarte ? descarte : stdout, stdout);
+	decodificador.traza(trazaGrabada);
+	if (echo || descarte) g_eco = &decodificador;
+	if (rutaSerie) {
+		g_serie = fopen(rutaSerie, "wb");
+		if (!g_serie) {
+			perror(rutaSerie);
+			return 1;
+		}
+	}
+	sim::setSerialTap(alSalirPorSerie);
+	// Verbosidad de la bitacora: el sketch la lee del monitor serie
+	if (nivel) sim::serialInject(nivel);
+	sim::setDhtFailureRate(dhtFail);
+	sim::setDigitalInput(kButtonPin, HIGH);
+	sim::setDigitalInput(kIrPin, HIGH);
+	sim::setStateHook(onStateChange);
+
+	const uint64_t endUs = (uint64_t)(days * 86400.0e6);
+	Stats loopVirtualMs;
+	uint64_t loops = 0;
+
+	std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+	setup();
+	size_t heapSetup = sim::heapUsado();
+	const uint64_t volcadoUs = endUs > msToUs(60000) ? endUs - msToUs(60000) : 0;
+	bool volcadoPedido = false;
+	const uint64_t ntcAbiertoUs = ntcAbiertoH >= 0.0 ? (uint64_t)(ntcAbiertoH * 3600.0e6) : UINT64_MAX;
+	bool ntcAbierto = false;
+	unsigned long pmvAlAbrir = 0;
+	uint64_t enfriandoAlAbrir = 0;
+	while (g_reproduciendo ? traza.reproduciendo() : sim::nowMicros() < endUs) {
+		uint64_t t0 = sim::nowMicros();
+		int estado = g_current;
+		if ((volcarHistorial || volcarPerfil) && !volcadoPedido && t0 >= volcadoUs) {
+			if (volcarHistorial) sim::serialInject("H");
+			if (volcarPerfil) sim::serialInject("P");
+			volcadoPedido = true;
+		}
+		if (!ntcAbierto && t0 >= ntcAbiertoUs) {
+			sim::setAnalogInput(kNtcPin, 1023);
+			pmvAlAbrir = principal.pmvIncremental().estadistica().evaluaciones();
+			enfriandoAlAbrir = g_transitions[S_MONITOR][S_PMV_ALTO];
+			ntcAbierto = true;
+		}
+		loop();
+		double ms = (double)(sim::nowMicros() - t0) / 1000.0;
+		loopVirtualMs.add(ms);
+		g_loopPorEstado[estado].add(ms);
+		loops++;
+	}
+	if (g_eco) g_eco->fin();
+	if (descarte) fclose(descarte);
+	if (trazaGrabada) fclose(trazaGrabada);
+	if (g_serie) fclose(g_serie);
+	double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+	double simS = (double)sim::nowMicros() / 1.0e6;
+
+	printf("\n=== SmartComfort-PMV: simulacion de host ===\n");
+	printf("tiempo simulado   : %.1f h (%.2f dias)\n", simS / 3600.0, simS / 86400.0);
+	printf("tiempo real       : %.3f s  (aceleracion x%.0f)\n", wallS, wallS > 0 ? simS / wallS : 0.0);
+	printf("iteraciones loop  : %llu  (%.0f loops/s reales, %.1f loops/s simulados)\n",
+	       (unsigned long long)loops, wallS > 0 ? (double)loops / wallS : 0.0, (double)loops / simS);
+
+	printf("\nDuracion de loop() en tiempo virtual:\n");
+	printStats("loop()", loopVirtualMs, "ms");
+	for (int s = 0; s < kNumStates; s++) printStats(kStateNames[s], g_loopPorEstado[s], "ms");
+
+	printf("\nPermanencia por estado:\n");
+	for (int s = 0; s < kNumStates; s++) printStats(kStateNames[s], g_dwell[s], "ms");
+
+	printf("\nReposo por estado (CPU en IDLE entre vencimientos, Reposo.h):\n");
+	for (int s = 0; s <= kNumStates; s++) {
+		EstadisticaReposo r = s < kNumStates ? reposo.estadistica(s) : reposo.total();
+		if (r.msActivo == 0 && r.msDormido == 0) continue;
+		printf("  %-24s activo %5.1f %%  dormido %9.1f s  despertares %8lu tiempo / %4lu entrada"
+		       "  latencia flancos max %3u ms  %8.3f mAh\n", s < kNumStates ? kStateNames[s] : "total",
+		       100.0 * r.cicloActivo(), r.msDormido / 1000.0, (unsigned long)r.despertaresTiempo,
+		       (unsigned long)r.despertaresEntrada, r.latenciaMaxima, r.mAh());
+	}
+
+	printf("\nLatencia estimulo -> transicion:\n");
+	for (std::map<std::string, Stats>::const_iterator it = g_latency.begin(); it != g_latency.end(); ++it)
+		printStats(it->first.c_str(), it->second, "ms");
+
+	printf("\nTransiciones (origen -> destino: cantidad):\n");
+	for (int a = 0; a < kNumStates; a++)
+		for (int b = 0; b < kNumStates; b++)
+			if (g_transitions[a][b])
+				printf("  %-10s -> %-10s %llu\n", kStateNames[a], kStateNames[b], (unsigned long long)g_transitions[a][b]);
+
+	printf("\nDispositivos:\n");
+	printf("  lecturas DHT11 en bus  : %u\n", sim::dhtBusReads());
+	printf("  RFID auth / bloques    : %u / %u\n", sim::rfidAuths(), sim::rfidBlockReads());
+	printf("  LCD clears / bytes     : %u / %u\n", sim::lcdClears(), sim::lcdBytes());
+	printf("  serie TX bytes         : %llu (bloqueado %.1f s)\n", (unsigned long long)sim::serialBytesWritten(),
+	       (double)sim::serialBlockedMicros() / 1.0e6);
+	uint32_t desgasteMax = 0;
+	for (size_t i = 0; i < sim::kEepromSize; i++) desgasteMax = std::max(desgasteMax, sim::eepromWrites((int)i));
+	printf("  escrituras EEPROM      : %u (maximo %u en una celda)\n", sim::eepromTotalWrites(), desgasteMax);
+	printf("  heap (bytes en placa)  : %zu tras setup, maximo %zu, al final %zu\n", heapSetup, sim::heapMaximo(),
+	       sim::heapUsado());
+	printf("  claves incorrectas     : %llu\n", (unsigned long long)g_wrongCodes);
+	printf("  eventos de la maquina  : %lu despachados, %lu viejos descartados, %u perdidos, ocupacion max %u/%u,"
+	       " latencia max %u ms\n", estadisticaEventos.despachados, estadisticaEventos.viejos, eventos.desbordes(),
+	       eventos.maximo(), ColaEventos::capacidad(), estadisticaEventos.latenciaMaxima);
+	const EstadisticaFlancos &fl = flancos.estadistica();
+	printf("  flancos IR y boton     : %lu capturados, %lu rebotes, %lu cambios, %u perdidos, ocupacion max %u/%u,"
+	       " %llu interrupciones\n", fl.flancos, fl.rebotes, fl.cambios, flancos.desbordes(), flancos.maximo(),
+	       FLANCOS_CAPACIDAD, (unsigned long long)sim::timerIsrCalls());
+	const EstadisticaPMVIncremental &inc = principal.pmvIncremental().estadistica();
+	unsigned long evaluaciones = inc.evaluaciones();
+	printf("  PMV sala principal     : %lu evaluaciones, %.1f %% sin cambios, %.1f %% solo RH, %.1f %% solo Tr\n",
+	       evaluaciones, 100.0 * inc.aciertos / std::max(evaluaciones, 1UL),
+	       100.0 * inc.soloRH / std::max(evaluaciones, 1UL), 100.0 * inc.soloTr / std::max(evaluaciones, 1UL));
+	const ConsignaPMV &consigna = principal.ultimaConsigna();
+	printf("  consigna del usuario   : PMV objetivo %.2f, ultima Ta=%.2f C en %u evaluaciones%s\n", principal.objetivo(),
+	       consigna.Ta, consigna.evaluaciones, consigna.saturada ? " (saturada)" : "");
+	if (ntcAbierto) {
+		printf("  NTC abierto            : desde %.1f h; despues, %lu evaluaciones de PMV y %llu veces Monitor -> pmv_alto%s\n",
+		       ntcAbiertoH, evaluaciones - pmvAlAbrir,
+		       (unsigned long long)(g_transitions[S_MONITOR][S_PMV_ALTO] - enfriandoAlAbrir),
+		       principal.sensores().fallaNTC() ? ", falla detectada" : "");
+	}
+	printf("  sala al final          : Ta=%.1f C  Tr=%.1f C  RH=%.0f %%\n", sim::room().Ta, sim::room().Tr, sim::room().RH);
+	ConfortISO iso = computeConfortISO(sim::room().Ta, sim::room().Tr, sim::room().RH, PMV_VA, PMV_MET, PMV_CLO);
+	const PerdidasCalor &q = iso.perdidas;
+	printf("  ISO 7730 al final      : PMV=%.2f PPD=%.1f %%  T_cl=%.1f C  perdidas W/m2: piel %.1f sudor %.1f"
+	       " resp %.1f+%.1f rad %.1f conv %.1f\n", iso.pmv, iso.ppd, iso.t_cl, q.difusion, q.sudor, q.respLatente,
+	       q.respSeca, q.radiacion, q.conveccion);
+	printf("  LCD                    : [%s] [%s]\n", sim::lcdLine(0), sim::lcdLine(1));
+
+	if (trazaGrabada) {
+		printf("\nTraza grabada en %s: %lu tramas", rutaGrabar, decodificador.tramasTraza());
+		if (traza.modo() == Traza::CORTADA) printf(" (CORTADA: buffer lleno)");
+		printf("\n");
+	}
+	if (g_reproduciendo) {
+		bool ok = traza.modo() == Traza::AGOTADA;
+		printf("\nReproduccion de %s:\n", rutaReproducir);
+		printf("  traza                  : %zu bytes, %.1f h grabadas\n", trazaReproducida.size(),
+		       traza.ultimoMillis() / 3.6e6);
+		printf("  cambios de estado      : %lu verificados\n", traza.verificados());
+		printf("  velocidad              : x%.0f respecto de la placa\n",
+		       wallS > 0 ? traza.ultimoMillis() / 1000.0 / wallS : 0.0);
+		if (ok) {
+			printf("  resultado              : OK, la ejecucion coincide con la grabada\n");
+		} else {
+			printf("  resultado              : DESVIO en el byte %u de la traza", traza.posicion());
+			if (traza.esperadoDesde() != 0xFF)
+				printf(" (se esperaba %s -> %s)", kStateNames[traza.esperadoDesde() % kNumStates],
+				       kStateNames[traza.esperadoHasta() % kNumStates]);
+			printf("\n");
+		}
+		return ok ? 0 : 1;
+	}
+	return 0;
+}